@@ -0,0 +1,20 @@
+#version 330 core
+
+layout(location = 0) in vec4 vertexPosition;
+layout(location = 1) in vec4 vertexNormal;
+layout(location = 2) in vec4 vertexColor;
+layout(location = 3) in mat4 objectMVP;
+layout(location = 7) in mat4 objectDepthMVP;
+
+out vec4 vColor;
+out vec4 vNormal;
+out vec4 vDepthPosition;
+
+void main()
+{
+    gl_Position = objectMVP * vertexPosition;
+    vDepthPosition = objectDepthMVP * vertexPosition;
+
+    vNormal = vertexNormal;
+    vColor = vertexColor;
+}
@@ -0,0 +1,9 @@
+#version 330 core
+
+layout(location = 0) in vec4 vertexPosition;
+layout(location = 3) in mat4 objectMVP;
+
+void main()
+{
+    gl_Position = objectMVP * vertexPosition;
+}
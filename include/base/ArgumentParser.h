@@ -2,6 +2,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 namespace base {
 class ArgumentParser
@@ -9,6 +10,8 @@ class ArgumentParser
   public:
     ArgumentParser(int argc, char* argv[]);
 
+    ArgumentParser withOverrides(const std::vector<std::string>& args) const;
+
     bool hasArgument(const std::string& argumentName) const;
     std::string getArgument(const std::string& argumentName) const;
     int getIntArgument(const std::string& argumentName) const;
@@ -17,6 +20,8 @@ class ArgumentParser
     const std::string& getPath() const;
 
   private:
+    void parse(const std::vector<std::string>& args);
+
     std::string path;
     std::unordered_map<std::string, std::string> arguments;
 };
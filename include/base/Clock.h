@@ -105,6 +105,12 @@ class Clock
 
     static TimePoint now();
 
+    // Monotonic time in seconds since the first call, doesn't need any windowing library to be initialized
+    static double seconds();
+
+    // CPU time consumed by the calling thread in seconds
+    static double threadCpuSeconds();
+
   private:
     TimePoint _tpLast;
     TimePoint _tpStart;
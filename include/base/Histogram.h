@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace base {
+/**
+ * Log-bucketed (HDR style) histogram of positive values.
+ *
+ * Every power of two between lowestValue and highestValue is split into subBucketCount linear buckets,
+ * so recording is constant-time, memory is bounded and relative error of reported percentiles
+ * stays below 1/subBucketCount. Values outside of the range are clamped into the first/last bucket,
+ * while count, min, max, mean and standard deviation are always computed from exact values.
+ */
+class Histogram
+{
+  public:
+    Histogram(double lowestValue, double highestValue, std::size_t subBucketCount);
+
+    void reset();
+    void record(double value);
+    void merge(const Histogram& other);
+
+    std::size_t count() const;
+    double min() const;
+    double max() const;
+    double mean() const;
+    double stddev() const;
+    double percentile(double percent) const;
+
+  private:
+    std::size_t bucketIndex(double value) const;
+    double bucketMidpoint(std::size_t index) const;
+
+    double _lowestValue;
+    double _highestValue;
+    std::size_t _subBucketCount;
+    std::vector<uint64_t> _buckets;
+
+    std::size_t _count;
+    double _min;
+    double _max;
+    double _mean;
+    double _m2;
+};
+}
@@ -0,0 +1,29 @@
+#pragma once
+
+#include <vector>
+
+namespace base {
+/**
+ * Linear least squares fits of small models (a few terms) by normal equations.
+ *
+ * Each sample is a row of values of the model's terms, fitted coefficients weight the terms so that
+ * their sums are closest to samples' values.
+ */
+class LeastSquares
+{
+  public:
+    using Rows = std::vector<std::vector<double>>;
+
+    // Returns false if terms are linearly dependent on given samples
+    static bool solve(const Rows& rows, const std::vector<double>& values, std::vector<double>& coefficients);
+
+    // All coefficients are non-negative, terms not needed for the best fit get 0; tries every subset of terms
+    static bool solveNonNegative(const Rows& rows,
+                                 const std::vector<double>& values,
+                                 std::vector<double>& coefficients);
+
+    static double squaredError(const Rows& rows,
+                               const std::vector<double>& values,
+                               const std::vector<double>& coefficients);
+};
+}
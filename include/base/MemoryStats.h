@@ -0,0 +1,26 @@
+#pragma once
+
+#include <cstddef>
+
+namespace base {
+/**
+ * Host memory accounting of the whole process.
+ *
+ * Heap statistics come from replaced global `operator new`/`operator delete`, so they cover all C++
+ * allocations (containers of tests as well as C++ parts of drivers), but not plain `malloc`.
+ * Resident set size is read from /proc on Linux, elsewhere it's reported as 0.
+ */
+class MemoryStats
+{
+  public:
+    static std::size_t heapBytes();
+    static std::size_t peakHeapBytes();
+    static std::size_t heapAllocations();
+
+    static std::size_t residentBytes();
+    static std::size_t peakResidentBytes();
+
+    // Peaks start again from current values
+    static void resetPeaks();
+};
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <array>
+#include <string>
+
+namespace base {
+/**
+ * Hardware and software performance counters of the calling thread, read with Linux `perf_event_open`.
+ *
+ * Counters are opened one by one instead of as a group, so any subset allowed by the CPU, the kernel and
+ * `perf_event_paranoid` works, and values are scaled when the kernel has to multiplex them. Hardware events
+ * are counted in user space only. With `withChildThreads` counters also include all threads created by the
+ * calling thread after `open()`. On other systems no counter is ever available.
+ */
+class PerfCounters
+{
+  public:
+    enum Counter
+    {
+        Cycles,
+        Instructions,
+        CacheMisses,
+        BranchMisses,
+        ContextSwitches,
+        CounterCount
+    };
+
+    using Values = std::array<double, CounterCount>;
+
+  public:
+    PerfCounters();
+    PerfCounters(const PerfCounters&) = delete;
+    ~PerfCounters();
+
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    void open(bool withChildThreads);
+    void close();
+
+    bool available() const;
+    bool available(Counter counter) const;
+    const std::string& error() const;
+
+    // Unavailable counters read as 0
+    Values read() const;
+
+    static const char* name(Counter counter);
+    static const char* key(Counter counter);
+
+  private:
+    std::array<int, CounterCount> _fds;
+    std::string _error;
+};
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+
+namespace base {
+/**
+ * Low-overhead CPU zone profiler.
+ *
+ * Each thread records finished zones into its own fixed-size lock-free ring buffer (single producer,
+ * single consumer), so recording never blocks, allocates or prints. Buffers are drained on every
+ * frame boundary (`frame()`), aggregated per zone and optionally kept as Chrome trace events
+ * (chrome://tracing or https://ui.perfetto.dev). Each session (test run) is a separate trace process.
+ *
+ * Zones are usually recorded with `TIME_IT`/`TIME_RESET` macros from <base/ScopedTimer.h>.
+ * GPU zones (already converted to `now()` time base) are only added to the trace, in a separate lane.
+ */
+class Profiler
+{
+  public:
+    static uint64_t now();
+    static void leaveZone(const char* name, uint64_t begin);
+    static void frame(const char* name);
+    static void gpuZone(const char* name, uint64_t begin, uint64_t end);
+
+    static void beginSession(const std::string& name);
+    static void endSession();
+    static void setTracing(bool enabled);
+
+    static void printStatistics(std::ostream& stream);
+    static bool writeChromeTrace(const std::string& path);
+};
+}
@@ -1,5 +1,9 @@
 #pragma once
 
+#include <base/Profiler.h>
+
+#include <cstdint>
+
 #ifdef ENABLE_TIMINGS
 #define TIME_IT(x) auto __scopedTimer = ::base::ScopedTimer{x};
 #define TIME_RESET(x) ::base::ScopedTimer::reset(x);
@@ -9,6 +13,9 @@
 #endif
 
 namespace base {
+/**
+ * Records a single profiler zone spanning its lifetime, `reset()` marks frame boundary (see base::Profiler).
+ */
 class ScopedTimer
 {
   public:
@@ -19,6 +26,6 @@ class ScopedTimer
 
   private:
     const char* _message;
-    double _start;
+    uint64_t _start;
 };
 }
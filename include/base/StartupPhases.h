@@ -0,0 +1,45 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+namespace base {
+/**
+ * Durations of initialization phases of a test (library, window, context and device creation,
+ * shader and pipeline setup), so that startup time can be broken down.
+ *
+ * Phases are recorded by `StartupPhases::Timer` scopes in the code initializing them, from `reset()`
+ * at the beginning of a run. Time of repeated phases with the same key is summed. Phases are recorded
+ * by the main thread only.
+ */
+class StartupPhases
+{
+  public:
+    struct Phase
+    {
+        const char* name;
+        const char* key;
+        double time; // seconds
+    };
+
+    class Timer
+    {
+      public:
+        Timer(const char* name, const char* key);
+        Timer(const Timer&) = delete;
+        ~Timer();
+
+        Timer& operator=(const Timer&) = delete;
+
+      private:
+        const char* _name;
+        const char* _key;
+        double _start;
+    };
+
+  public:
+    static void reset();
+    static void record(const char* name, const char* key, double time);
+    static const std::vector<Phase>& phases();
+};
+}
@@ -0,0 +1,19 @@
+#pragma once
+
+namespace base {
+/**
+ * Readings of CPU frequency and temperature sensors.
+ *
+ * Values are read from sysfs on Linux (cpufreq and thermal zones), elsewhere or when the system
+ * doesn't expose them (e.g. in virtual machines) readings aren't available and `false` is returned.
+ */
+class SystemSensors
+{
+  public:
+    // Average current frequency of all online CPUs in MHz
+    static bool cpuFrequency(double& megahertz);
+
+    // Highest temperature of all thermal zones in degrees Celsius
+    static bool temperature(double& celsius);
+};
+}
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <base/ThreadPool.h>
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+namespace base {
+/**
+ * Stages of a frame and dependencies between them, run by `ThreadPool::dispatch(TaskGraph&)`.
+ *
+ * Each node is a range task with its own ranges, a node starts once all ranges of all nodes preceding
+ * it finish. Nodes without a dependency between them run at the same time and share the workers.
+ * Nodes are added in order of execution, so a node can only precede nodes added after it, which keeps
+ * the graph acyclic. Graph is built once and dispatched every frame, ranges can change between frames.
+ */
+class TaskGraph
+{
+  public:
+    using Node = std::size_t;
+
+    TaskGraph();
+    TaskGraph(const TaskGraph&) = delete;
+
+    TaskGraph& operator=(const TaskGraph&) = delete;
+
+    Node add(const ThreadPool::RangeTask& task);
+    void setRanges(Node node, const std::vector<std::size_t>& boundaries);
+    void precede(Node before, Node after);
+
+    std::size_t size() const;
+
+  private:
+    friend class ThreadPool;
+
+    std::vector<std::unique_ptr<ThreadPool::Job>> _jobs;
+};
+}
@@ -0,0 +1,125 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace base {
+class TaskGraph;
+
+/**
+ * Persistent worker threads for per-frame parallel work of multithreaded tests.
+ *
+ * Workers are started once and wait for work between frames, so a frame doesn't pay for thread creation.
+ * Waiting threads spin for a short while before they park on a condition variable, which keeps wake-up
+ * latency low at high frame rates without burning CPU when the pool is idle for longer.
+ *
+ * Work is a set of ranges of items, given by their boundaries (see `splitEvenly()` and `splitByCost()`).
+ * Ranges are dealt out to workers in contiguous blocks, each worker takes ranges from the front of its
+ * own queue and, once it runs out, steals half of the last block of another worker. Many small ranges
+ * then balance uneven work dynamically. Stages depending on each other are expressed as a `TaskGraph`.
+ *
+ * `dispatch()` queues the work and returns, `wait()` blocks until all of it finishes. Only one thread
+ * should dispatch. A pool without workers runs all the work on the dispatching thread.
+ */
+class ThreadPool
+{
+  public:
+    using Task = std::function<void(std::size_t)>;
+    // Items [begin, end) of a range, worker is index of the thread running it in [0, threads())
+    using RangeTask = std::function<void(std::size_t begin, std::size_t end, std::size_t worker)>;
+
+    ThreadPool(std::size_t threads);
+    ThreadPool(const ThreadPool&) = delete;
+    ~ThreadPool();
+
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    std::size_t threads() const;
+
+    // Task is run for each index 0..count-1 (as a range of its own)
+    void dispatch(std::size_t count, const Task& task);
+    void dispatch(const std::vector<std::size_t>& boundaries, const RangeTask& task);
+    void dispatch(TaskGraph& graph);
+    void wait();
+
+    // Dispatch and wait
+    void parallelFor(std::size_t count, const Task& task);
+    void parallelFor(const std::vector<std::size_t>& boundaries, const RangeTask& task);
+
+    // Ranges stolen from other workers since construction, shows how uneven the work was
+    std::size_t steals() const;
+
+    // Number of ranges per-frame work is split into, several per worker
+    std::size_t workerRanges() const;
+    // Boundaries of `workerRanges()` ranges of [0, count), see `splitEvenly()`
+    std::vector<std::size_t> splitForWorkers(std::size_t count) const;
+
+    // Boundaries of at most `ranges` ranges of [0, count) with sizes differing by at most one, there is
+    // always at least one range (empty when `count` is zero)
+    static std::vector<std::size_t> splitEvenly(std::size_t count, std::size_t ranges);
+    // Boundaries of roughly `ranges` ranges of items with similar sums of costs, items costlier
+    // than a range's share get a range of their own
+    static std::vector<std::size_t> splitByCost(const std::vector<double>& costs, std::size_t ranges);
+
+  private:
+    friend class TaskGraph;
+
+    struct Job
+    {
+        Job();
+
+        RangeTask task;
+        std::vector<std::size_t> boundaries;
+        std::atomic<std::size_t> remainingRanges;
+
+        // Jobs of a graph start when all their predecessors finish
+        std::vector<Job*> successors;
+        std::size_t predecessors;
+        std::atomic<std::size_t> remainingPredecessors;
+    };
+
+    // Ranges [first, last) of a job
+    struct Block
+    {
+        Job* job;
+        std::size_t first;
+        std::size_t last;
+    };
+
+    struct Queue
+    {
+        std::mutex mutex;
+        std::deque<Block> blocks;
+    };
+
+    void submit(Job& job);
+    void finishRange(Job& job);
+    void finishJob(Job& job);
+    bool takeRange(std::size_t worker, Block& range);
+    bool runRange(std::size_t worker);
+    void workerLoop(std::size_t worker);
+
+    std::vector<std::thread> _workers;
+    // One per worker, a pool without workers has one for the dispatching thread
+    std::vector<std::unique_ptr<Queue>> _queues;
+
+    Job _job; // work of plain dispatches
+    Task _indexTask;
+    std::atomic<std::size_t> _pendingJobs;
+    std::atomic<std::size_t> _steals;
+    std::atomic<uint64_t> _epoch; // changes when new work is queued
+    std::atomic<bool> _stopping;
+
+    std::mutex _mutex;
+    std::condition_variable _workAvailable;
+    std::condition_variable _workFinished;
+};
+}
@@ -2,6 +2,7 @@
 
 #include <GL/glew.h>
 
+#include <cstddef>
 #include <functional>
 #include <list>
 #include <vector>
@@ -106,10 +107,18 @@ class Buffer
     template <typename T>
     void setSubData(const std::vector<T>& data, GLintptr offset, GLsizeiptr size);
 
+  public:
+    // Data store sizes of all existing buffers (as requested, drivers may allocate more)
+    static std::size_t allocatedBytes();
+    static std::size_t peakAllocatedBytes();
+    static void resetPeakAllocatedBytes();
+
   protected:
     bool isCreated() const;
+    void trackSize(GLsizeiptr size);
 
     bool _isCreated;
+    GLsizeiptr _size;
     GLuint _bufferID;
     Target _target;
     Usage _usage;
@@ -120,6 +129,7 @@ void Buffer::setData(const std::vector<T>& data)
 {
     glBufferData(static_cast<GLenum>(getTarget()), data.size() * sizeof(T), data.data(),
                  static_cast<GLenum>(getUsage()));
+    trackSize(static_cast<GLsizeiptr>(data.size() * sizeof(T)));
 }
 
 template <typename T>
@@ -0,0 +1,54 @@
+#pragma once
+
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace base {
+namespace gl {
+/**
+ * Per-pass GPU timer built on GL_TIMESTAMP queries.
+ *
+ * Every pass writes timestamp queries at its beginning and end. Queries of one frame are read back
+ * `frameLatency` frames later, when the same queries are about to be reused, and only if they are
+ * already available, so reading results never stalls the pipeline (late results are dropped).
+ * GPU timestamps are converted to `base::Profiler::now()` time base using GL_TIMESTAMP queried
+ * directly from the context, recalibrated periodically to follow clock drift.
+ */
+class GpuTimer
+{
+  public:
+    // pass index, begin and end time in base::Profiler::now() nanoseconds
+    using Callback = std::function<void(std::size_t, uint64_t, uint64_t)>;
+
+  public:
+    GpuTimer(std::size_t passCount, std::size_t frameLatency = 3u);
+    GpuTimer(const GpuTimer&) = delete;
+    ~GpuTimer();
+
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    void create();
+    void destroy();
+
+    void beginFrame(const Callback& callback);
+    void begin(std::size_t pass);
+    void end(std::size_t pass);
+
+  private:
+    std::size_t queryIndex(std::size_t frame, std::size_t pass) const;
+    void calibrate();
+
+    std::size_t _passCount;
+    std::size_t _frameLatency;
+    std::vector<GLuint> _queries;
+    std::vector<bool> _written;
+    std::size_t _frame;
+    std::size_t _framesSinceCalibration;
+    int64_t _offset;
+};
+}
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include <base/gl/Buffer.h>
+
+#include <GL/glew.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace base {
+namespace gl {
+/**
+ * Persistently mapped buffer split into regions, one per frame in flight.
+ *
+ * Current region is written through a plain pointer, also by worker threads without GL context, while
+ * the GL thread sources draws from it (e.g. indirect commands or per-object data). Draws of a region are
+ * fenced by `endRegion()`, `beginRegion()` waits for the fence of the region it makes current, so GPU never
+ * reads data which are being written. Needs GL 4.4 or ARB_buffer_storage (see `isSupported()`).
+ */
+class MappedRingBuffer : public Buffer
+{
+  public:
+    MappedRingBuffer(Target target, std::size_t regions = 3u);
+    MappedRingBuffer(const MappedRingBuffer&) = delete;
+    ~MappedRingBuffer();
+
+    MappedRingBuffer& operator=(const MappedRingBuffer&) = delete;
+
+    static bool isSupported();
+
+    // New data store with given size of each region, the previous one is released (after its draws finish)
+    void allocate(GLsizeiptr regionSize);
+    void destroy();
+
+    void beginRegion();
+    void endRegion();
+
+    std::size_t regionIndex() const;
+    GLsizeiptr regionSize() const;
+    GLintptr regionOffset() const;
+    GLvoid* regionData() const;
+
+  private:
+    std::size_t _regions;
+    std::size_t _region;
+    GLsizeiptr _regionSize;
+    GLvoid* _data;
+    std::vector<GLsync> _fences;
+};
+}
+}
@@ -55,6 +55,8 @@ class VertexArray
     void setAttribPointers();
     void setAttribPointers(const VertexBuffer& vertexBuffer);
     void setAttribPointers(const std::vector<VertexAttrib>& attributes);
+    // Attribute advances once per `divisor` instances instead of once per vertex
+    void setAttribDivisor(GLuint index, GLuint divisor);
 
     void setDrawOffset(GLint offset);
     void setDrawCount(GLsizei count);
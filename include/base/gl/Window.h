@@ -4,11 +4,13 @@
 
 #include <glm/vec2.hpp>
 
+#include <deque>
 #include <functional>
 #include <string>
 #include <vector>
 
 struct GLFWwindow;
+struct __GLsync;
 
 namespace base {
 namespace gl {
@@ -26,6 +28,7 @@ class Window
     void setPosition(const glm::ivec2& position);
     void setTitle(const std::string& title);
     void appendTitle(const std::string& text);
+    void setOffscreen(bool flag);
 
     void setDisplayingFPS(bool flag);
     void setCountingFPS(bool flag);
@@ -45,9 +48,11 @@ class Window
     const std::string& getTitle() const;
 
     bool isCreated() const;
+    bool isOffscreen() const;
     bool shouldClose() const;
     double getFrameTime() const;
     GLFWwindow* getHandle();
+    unsigned int getFramebuffer() const;
 
     static void enableVSync();
     static void disableVSync();
@@ -60,6 +65,9 @@ class Window
 
   protected:
     void setFPSCount(int fpsCount);
+    void createFramebuffer();
+    void destroyFramebuffer();
+    void throttleOffscreenFrames();
 
     int _fpsCount;
     unsigned int _framesCount;
@@ -71,6 +79,11 @@ class Window
     double _fpsRefreshRate;
     double _frameTime;
     GLFWwindow* _handle;
+    bool _isOffscreen;
+    unsigned int _framebuffer;
+    unsigned int _colorRenderbuffer;
+    unsigned int _depthRenderbuffer;
+    std::deque<__GLsync*> _frameFences;
     std::string _title;
     glm::uvec2 _windowSize;
     glm::ivec2 _windowPosition;
@@ -83,6 +96,9 @@ class Window
     static void initializeGLFW();
     static void initializeGLEW();
     static void setFocus(GLFWwindow* window, int focused);
+
+    static bool _glfwInitialized;
+    static bool _glewInitialized;
 };
 }
 }
@@ -16,13 +16,14 @@ namespace vkx {
 class Application
 {
   public:
-    Application(const std::string& name, const glm::vec2& windowSize, bool debugMode);
+    Application(const std::string& name, const glm::vec2& windowSize, bool debugMode, bool offscreen);
     Application(const Application&) = delete;
     virtual ~Application();
 
     Application& operator=(const Application&) = delete;
 
     const std::string& name() const;
+    bool offscreen() const;
     const vk::Instance& instance() const;
     const vk::PhysicalDevice& physicalDevice() const;
     const vk::Device& device() const;
@@ -35,7 +36,7 @@ class Application
 
   private:
     vk::UniqueInstance createInstance(const std::vector<const char*>& layers);
-    vkx::DeviceInfo selectPhysicalDevice(const std::vector<vk::PhysicalDevice>& physicalDevices);
+    vkx::DeviceInfo selectPhysicalDevice();
     vk::UniqueDevice createDevice();
 
     std::vector<std::string> getRequiredExtensions() const;
@@ -44,12 +45,13 @@ class Application
     static void deinitialize();
 
     std::string _name;
+    bool _offscreen;
     vk::UniqueInstance _instance;
     vkx::DeviceInfo _deviceInfo;
     vk::UniqueDevice _device;
     vkx::QueueManager _queueManager;
-    vkx::Window _window;
     vkx::MemoryManager _memory;
+    vkx::Window _window;
 };
 }
 }
@@ -0,0 +1,73 @@
+#pragma once
+
+#include <base/vkx/DeviceInfo.h>
+#include <base/vkx/QueueManager.h>
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+namespace base {
+namespace vkx {
+/**
+ * Per-pass GPU timer built on a timestamp query pool.
+ *
+ * Every frame (command buffer slot) owns two queries per pass, written with `vkCmdWriteTimestamp`
+ * at the top of pipe before the pass and at the bottom of pipe after it. Results are collected when the
+ * slot is reused, after its fence was waited for, so reading them never stalls the queue.
+ * GPU ticks are converted to `base::Profiler::now()` nanoseconds. There is no calibrated timestamps
+ * extension in our Vulkan headers, so the clocks are aligned once using a timestamp written by
+ * a tiny submission, taking the CPU midpoint of the fastest of a few round-trips.
+ */
+class GpuTimer
+{
+  public:
+    // pass index, begin and end time in base::Profiler::now() nanoseconds
+    using Callback = std::function<void(std::size_t, uint64_t, uint64_t)>;
+
+  public:
+    GpuTimer();
+    GpuTimer(const vk::Device& device,
+             const DeviceInfo& deviceInfo,
+             const QueueManager& queues,
+             std::size_t frameCount,
+             std::size_t passCount);
+    GpuTimer(GpuTimer&& other);
+    GpuTimer(const GpuTimer&) = delete;
+
+    ~GpuTimer();
+
+    GpuTimer& operator=(GpuTimer&& other);
+    GpuTimer& operator=(const GpuTimer&) = delete;
+
+    void collect(std::size_t frame, const Callback& callback);
+    void reset(const vk::CommandBuffer& cmdBuffer, std::size_t frame);
+    void begin(const vk::CommandBuffer& cmdBuffer, std::size_t frame, std::size_t pass) const;
+    void end(const vk::CommandBuffer& cmdBuffer, std::size_t frame, std::size_t pass) const;
+
+  private:
+    void create(const DeviceInfo& deviceInfo, const QueueManager& queues);
+    void calibrate(const QueueManager& queues);
+    void destroy();
+    void swap(GpuTimer& other);
+
+    uint32_t queryIndex(std::size_t frame, std::size_t pass) const;
+    uint64_t toProfilerTime(uint64_t ticks) const;
+
+    vk::Device _device;
+    vk::QueryPool _queryPool;
+    std::size_t _frameCount;
+    std::size_t _passCount;
+    std::vector<bool> _written;
+    std::vector<uint64_t> _results;
+
+    double _tickPeriod; // nanoseconds
+    uint64_t _validBitsMask;
+    uint64_t _calibrationTicks;
+    uint64_t _calibrationTime;
+};
+}
+}
@@ -4,6 +4,10 @@
 
 #include <vulkan/vulkan.hpp>
 
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 namespace base {
 namespace vkx {
 
@@ -25,6 +29,13 @@ struct Image
 
 class MemoryManager
 {
+  public:
+    struct HeapUsage
+    {
+        vk::DeviceSize bytes;
+        vk::DeviceSize peakBytes;
+    };
+
   public:
     MemoryManager(const vk::Device& device, const vkx::DeviceInfo& deviceInfo);
     MemoryManager(MemoryManager&& other);
@@ -37,6 +48,7 @@ class MemoryManager
     uint32_t getMemoryTypeIndex(vk::MemoryPropertyFlags flags, uint32_t memoryTypeBits) const;
     vk::DeviceMemory allocateHostVisibleMemory(const vk::MemoryRequirements& memoryRequirements) const;
     vk::DeviceMemory allocateDeviceLocalMemory(const vk::MemoryRequirements& memoryRequirements) const;
+    void freeMemory(vk::DeviceMemory memory) const;
 
     Buffer createStagingBuffer(vk::DeviceSize size) const;
 
@@ -53,9 +65,25 @@ class MemoryManager
     void destroyBuffer(Buffer& buffer) const;
     void destroyImage(Image& image) const;
 
+    // Memory allocated through this manager, indexed by memory heap
+    std::vector<HeapUsage> heapUsage() const;
+
   private:
+    struct Allocation
+    {
+        uint32_t heapIndex;
+        vk::DeviceSize size;
+    };
+
+    vk::DeviceMemory allocateMemory(vk::DeviceSize size, uint32_t memoryTypeIndex) const;
+
     const vk::Device& _device;
     const vkx::DeviceInfo& _deviceInfo;
+
+    // Allocations may be done from worker threads
+    mutable std::mutex _allocationsMutex;
+    mutable std::unordered_map<VkDeviceMemory, Allocation> _allocations;
+    mutable std::vector<HeapUsage> _heapUsage;
 };
 }
 }
@@ -12,17 +12,23 @@ class QueueManager
 {
   public:
     static std::vector<vk::DeviceQueueCreateInfo> createInfos(const vk::Instance& instance,
-                                                              const vk::PhysicalDevice& device);
+                                                              const vk::PhysicalDevice& device,
+                                                              bool presentationRequired);
 
   public:
-    QueueManager(const vk::Instance& instance, const vk::PhysicalDevice& physicalDevice, const vk::Device& device);
+    QueueManager(const vk::Instance& instance,
+                 const vk::PhysicalDevice& physicalDevice,
+                 const vk::Device& device,
+                 bool presentationRequired);
     ~QueueManager();
 
     uint32_t familyIndex() const;
     const vk::Queue& queue() const;
 
   private:
-    uint32_t chooseFamilyIndex(const vk::Instance& instance, const vk::PhysicalDevice& physicalDevice) const;
+    uint32_t chooseFamilyIndex(const vk::Instance& instance,
+                               const vk::PhysicalDevice& physicalDevice,
+                               bool presentationRequired) const;
     vk::Queue createQueue(const vk::Device& device);
 
   private:
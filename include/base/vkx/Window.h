@@ -1,5 +1,7 @@
 #pragma once
 
+#include <base/vkx/MemoryManager.h>
+
 #include <glm/vec2.hpp>
 #include <vulkan/vulkan.hpp>
 
@@ -25,6 +27,9 @@ class Window
     void update();
     bool shouldClose() const;
 
+    uint32_t acquireNextImage(const vk::Semaphore& signalSemaphore) const;
+    void present(const vk::Semaphore& waitSemaphore, uint32_t imageIndex) const;
+
     const std::string& title() const;
     void title(const std::string& title);
     void appendTitle(const std::string& text);
@@ -36,15 +41,18 @@ class Window
     const std::vector<vk::Image>& swapchainImages() const;
     const std::vector<vk::ImageView>& swapchainImageViews() const;
     const vk::Format& swapchainImageFormat() const;
+    vk::ImageLayout presentImageLayout() const;
 
   private:
     GLFWwindow* createWindow();
     vk::SurfaceKHR createSurface();
     vk::SwapchainKHR createSwapchain();
+    std::vector<vkx::Image> createOffscreenImages();
     std::vector<vk::Image> querySwapchainImages();
     std::vector<vk::ImageView> createSwapchainImageViews();
 
     void destroySwapchainImageViews();
+    void destroyOffscreenImages();
     void destroySwapchain();
     void destroySurface();
     void destroyWindow();
@@ -54,6 +62,7 @@ class Window
 
     double _lastFpsMeasure;
     double _thisFpsMeasure;
+    double _lastFrameMeasure;
     double _frameTime;
     unsigned int _framesCount;
 
@@ -64,6 +73,8 @@ class Window
     vk::SurfaceKHR _surface;
     vk::SurfaceFormatKHR _swapchainSurfaceFormat;
     vk::SwapchainKHR _swapchain;
+    std::vector<vkx::Image> _offscreenImages;
+    mutable uint32_t _nextOffscreenImage;
     std::vector<vk::Image> _swapchainImages;
     std::vector<vk::ImageView> _swapchainImageViews;
 };
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <base/vkx/QueueManager.h>
+
+#include <vulkan/vulkan.hpp>
+
+#include <cstddef>
+#include <vector>
+
+namespace base {
+namespace vkx {
+/**
+ * Secondary command buffers recorded by worker threads, one per worker, frame and pass.
+ *
+ * Every worker has a command pool of its own, so workers never share a pool while recording. All ranges
+ * a worker records for a pass in a frame go into one buffer, which is begun with the first of them,
+ * so workers which got no range of a pass have nothing to execute in it.
+ *
+ * `reset()` is called before workers are dispatched, `begin()` by each worker for its ranges and `end()`
+ * after all of them finished, it ends begun buffers of a pass and returns them for `executeCommands`.
+ */
+class WorkerCommandBuffers
+{
+  public:
+    WorkerCommandBuffers();
+    WorkerCommandBuffers(const vk::Device& device,
+                         const QueueManager& queues,
+                         std::size_t workerCount,
+                         std::size_t frameCount,
+                         std::size_t passCount = 1u);
+    WorkerCommandBuffers(WorkerCommandBuffers&& other);
+    WorkerCommandBuffers(const WorkerCommandBuffers&) = delete;
+
+    ~WorkerCommandBuffers();
+
+    WorkerCommandBuffers& operator=(WorkerCommandBuffers&& other);
+    WorkerCommandBuffers& operator=(const WorkerCommandBuffers&) = delete;
+
+    std::size_t workerCount() const;
+
+    void reset(std::size_t frame);
+    // Buffer of the worker, `begun` is set when it was begun by this call and so needs its state bound
+    const vk::CommandBuffer& begin(std::size_t worker,
+                                   std::size_t pass,
+                                   const vk::CommandBufferInheritanceInfo& inheritanceInfo,
+                                   bool& begun);
+    std::vector<vk::CommandBuffer> end(std::size_t pass);
+
+  private:
+    struct Worker
+    {
+        vk::CommandPool cmdPool;
+        std::vector<vk::CommandBuffer> cmdBuffers; // pass-major
+        std::vector<char> recording;               // per pass, written only by the worker while recording
+    };
+
+    void destroy();
+    void swap(WorkerCommandBuffers& other);
+
+    vk::Device _device;
+    std::vector<Worker> _workers;
+    std::size_t _frameCount;
+    std::size_t _passCount;
+    std::size_t _frame;
+};
+}
+}
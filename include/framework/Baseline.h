@@ -0,0 +1,38 @@
+#pragma once
+
+#include <framework/BenchmarkResult.h>
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace framework {
+/**
+ * Performance baseline of a machine, checked against results of new runs.
+ *
+ * Baseline is a results file written with `-output` in JSON format. Runs are matched by their
+ * configuration (test, API, threading, offscreen) and every frame time percentile, stage time and
+ * GPU pass time is compared; repeated runs of the same configuration are reduced to their median.
+ * A metric regresses when it's slower than the baseline by more than the relative tolerance and
+ * also by more than a small absolute slack (so sub-millisecond stages don't fail on noise).
+ */
+class Baseline
+{
+  public:
+    static Baseline load(const std::string& path);
+
+  public:
+    Baseline(std::vector<BenchmarkResult> records);
+
+    // Returns false if any metric of any configuration regressed
+    bool check(const std::vector<BenchmarkResult>& results, double tolerance, std::ostream& stream) const;
+
+  private:
+    static std::string configurationKey(const BenchmarkResult& result);
+    static std::string describeConfiguration(const BenchmarkResult& result);
+    static bool isComparedMetric(const BenchmarkResult::Field& field);
+    static std::vector<BenchmarkResult::Field> medianMetrics(const std::vector<const BenchmarkResult*>& results);
+
+    std::vector<BenchmarkResult> _records;
+};
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace framework {
+/**
+ * Structured record of a single test run.
+ *
+ * Values are grouped in named sections (e.g. `run`, `device`, `stats`) and keep insertion order,
+ * so every record of the same test type serializes to the same set of JSON keys or CSV columns.
+ */
+class BenchmarkResult
+{
+  public:
+    struct Field
+    {
+        std::string section;
+        std::string key;
+        bool isNumber;
+        double number;
+        std::string text;
+    };
+
+    BenchmarkResult() = default;
+
+    // Reads a record written by writeJson(), throws std::invalid_argument on malformed input
+    static BenchmarkResult parseJson(const std::string& json);
+    // Reads records written by writeCsvHeader() and writeCsvRow(), values are read as text,
+    // throws std::invalid_argument on malformed input
+    static std::vector<BenchmarkResult> parseCsv(const std::string& csv);
+
+    void set(const std::string& section, const std::string& key, double value);
+    void set(const std::string& section, const std::string& key, const std::string& value);
+    void set(const std::string& section, const std::string& key, const char* value);
+
+    bool has(const std::string& section, const std::string& key) const;
+    double number(const std::string& section, const std::string& key) const;
+    std::string text(const std::string& section, const std::string& key) const;
+    const std::vector<Field>& fields() const;
+
+    void writeJson(std::ostream& stream) const;
+    // CSV columns are `section.key` of fields
+    std::vector<std::string> csvColumns() const;
+    void writeCsvHeader(std::ostream& stream) const;
+    void writeCsvRow(std::ostream& stream) const;
+    // Values in order of given columns, columns without a field are left empty
+    void writeCsvRow(std::ostream& stream, const std::vector<std::string>& columns) const;
+
+    static void writeCsvHeader(std::ostream& stream, const std::vector<std::string>& columns);
+
+  private:
+    Field& field(const std::string& section, const std::string& key);
+    const Field* findField(const std::string& section, const std::string& key) const;
+
+    std::vector<Field> _fields;
+};
+}
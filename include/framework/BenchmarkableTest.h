@@ -1,34 +1,153 @@
 #pragma once
 
+#include <base/Histogram.h>
+#include <base/PerfCounters.h>
+#include <base/ThreadPool.h>
+#include <framework/BenchmarkResult.h>
+#include <framework/FrameClassifier.h>
+#include <framework/SoakMonitor.h>
+#include <framework/TestConfiguration.h>
 #include <framework/TestInterface.h>
+#include <framework/ThreadUtilization.h>
 
+#include <array>
+#include <atomic>
 #include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
 
 namespace framework {
 class BenchmarkableTest : public TestInterface
 {
   public:
-    BenchmarkableTest(bool benchmarkMode, float benchmarkTime);
+    BenchmarkableTest(const TestConfiguration& configuration);
     virtual ~BenchmarkableTest() = default;
 
     virtual void printStatistics() const;
+    virtual void exportStatistics(BenchmarkResult& result) const;
     void startMeasuring();
     void startMeasuring(double startTime);
 
+    // Phase boundaries of performance counters, warm-up ends together with it in `processFrameTime`
+    void finishSetup();
+    void finishRun();
+
     static double getCurrentTime();
 
   protected:
+    struct GpuMemoryUsage
+    {
+        std::string name;
+        std::string key;
+        std::size_t bytes;
+        std::size_t peakBytes;
+    };
+
+    // Frame ends here, also as a profiler frame (zones of each frame are summed into its statistics)
     bool processFrameTime();
     bool processFrameTime(double frameTime);
 
+    // Time step of scene updates, measured frame time unless the test runs deterministically
+    double simulationTimeStep(double frameTime) const;
+
+    // Number of threads multithreaded tests split their work into
+    std::size_t workerThreads() const;
+
+    // Scene of the next frame is updated while the current one is recorded, tests supporting it check this
+    bool pipelined() const;
+
+    // Persistent workers of multithreaded tests (`workerThreads()` of them), per-frame parallel work runs on them;
+    // pipelined singlethreaded tests have a single worker for scene updates
+    base::ThreadPool& threadPool() const;
+
+    // Draw calls recorded or issued by the test, reported per measured frame; counters are shared by all
+    // threads, so workers count whole ranges at once
+    void countDraws(std::size_t draws, std::size_t vertices) const;
+
+    // GPU passes are measured by API-specific timers, times are in `base::Profiler::now()` nanoseconds
+    std::size_t registerGpuPass(const char* name);
+    void processGpuPassTime(std::size_t pass, uint64_t begin, uint64_t end);
+
+    // GPU memory is tracked by API-specific code, reported together with host memory
+    virtual std::vector<GpuMemoryUsage> gpuMemoryUsage() const;
+
     bool _benchmarkEnabled;
-    bool _firstSecondIgnored;
+    bool _deterministic;
+    bool _pipelined;
+    std::size_t _workerThreads;
+    bool _warmupFinished;
     double _benchmarkTime;
-    double _minFrameTime;
-    double _maxFrameTime;
+    std::size_t _benchmarkFrames;
     double _startTime;
     double _lastMeasureTime;
     double _measuredTime;
     std::size_t _frameCount;
+    base::Histogram _frameTimes;
+
+    // Stages are measured also from const rendering methods of tests
+    mutable FrameClassifier _frameClassifier;
+
+    // Parallel regions of multithreaded tests, workers are measured from const methods as well
+    mutable ThreadUtilization _threadUtilization;
+
+    // Only multithreaded and pipelined tests have workers, they are started once for the whole run
+    std::unique_ptr<base::ThreadPool> _threadPool;
+
+    // Windowed statistics of long runs, disabled unless soak window is set
+    SoakMonitor _soakMonitor;
+
+  private:
+    struct GpuPass
+    {
+        const char* name;
+        base::Histogram times;
+    };
+
+    enum PerfPhase
+    {
+        SetupPhase,
+        WarmupPhase,
+        MeasuredPhase,
+        PerfPhaseCount
+    };
+
+    struct PerfSnapshot
+    {
+        base::PerfCounters::Values mainThread;
+        base::PerfCounters::Values allThreads;
+        bool taken;
+    };
+
+    bool measureFrameTime(double frameTime);
+    double drawsPerFrame() const;
+    double verticesPerFrame() const;
+    void takePerfSnapshot(std::size_t index);
+    void perfPhaseValues(std::size_t phase,
+                         base::PerfCounters::Values& mainThread,
+                         base::PerfCounters::Values& otherThreads) const;
+    void printStartupPhases() const;
+    void exportStartupPhases(BenchmarkResult& result) const;
+    void printThreadUtilization() const;
+    void exportThreadUtilization(BenchmarkResult& result) const;
+    void printMemoryUsage() const;
+    void exportMemoryUsage(BenchmarkResult& result) const;
+    void printPerfCounters() const;
+    void exportPerfCounters(BenchmarkResult& result) const;
+
+    std::vector<GpuPass> _gpuPasses;
+    mutable std::atomic<uint64_t> _drawCalls;
+    mutable std::atomic<uint64_t> _drawnVertices;
+    std::size_t _heapAllocationsAtStart;
+    double _mainThreadCpuStart;
+    double _mainThreadCpuTime;
+    double _setupTime; // from start of the run until setup is finished
+    double _setupPhasesTime;
+
+    // Counters of all threads include worker threads started by the test, and driver threads as well
+    base::PerfCounters _mainThreadCounters;
+    base::PerfCounters _allThreadsCounters;
+    std::array<PerfSnapshot, PerfPhaseCount + 1> _perfSnapshots; // beginning of each phase and end of run
 };
 }
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <framework/BenchmarkResult.h>
+
+#include <cstddef>
+#include <ostream>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace framework {
+/**
+ * Statistical A/B comparison of two test configurations.
+ *
+ * Each benchmark run contributes its mean and median frame time (frames within a run are strongly
+ * correlated, so runs are the independent samples). Confidence intervals come from bootstrap
+ * resampling of runs, significance of the difference of mean frame times from a permutation test.
+ * Resampling uses a fixed seed, so the same results always give the same verdict.
+ */
+class Comparison
+{
+  public:
+    struct Interval
+    {
+        double estimate;
+        double low;
+        double high;
+    };
+
+  public:
+    Comparison(const std::string& labelA, const std::string& labelB);
+
+    // Runs without benchmark statistics are ignored
+    void addRun(bool isB, const BenchmarkResult& result);
+
+    void print(std::ostream& stream) const;
+
+  private:
+    using Statistic = double (*)(const std::vector<double>&);
+
+    struct Side
+    {
+        std::string label;
+        std::vector<double> meanFrameTimes;
+        std::vector<double> medianFrameTimes;
+    };
+
+    Interval bootstrap(const std::vector<double>& samples, Statistic statistic) const;
+    Interval bootstrapRelativeDifference(const std::vector<double>& samplesA,
+                                         const std::vector<double>& samplesB,
+                                         Statistic statistic) const;
+    double permutationTest(const std::vector<double>& samplesA, const std::vector<double>& samplesB) const;
+
+    Side _a;
+    Side _b;
+    mutable std::mt19937 _generator;
+};
+}
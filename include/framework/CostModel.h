@@ -0,0 +1,57 @@
+#pragma once
+
+#include <framework/BenchmarkResult.h>
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace framework {
+/**
+ * Linear cost model of frame time of a test, fitted to runs with different scene sizes.
+ *
+ * Average frame time of each run is modeled as `fixed + perDraw * draws + perVertex * vertices`
+ * (non-negative least squares), with draw calls and vertices per frame counted by the test itself.
+ * Costs per draw and per vertex can be separated only if scene sizes don't change both in the same
+ * proportion, i.e. when number of objects and their detail are varied independently.
+ */
+class CostModel
+{
+  public:
+    struct Model
+    {
+        double fixedTime;
+        double drawTime;
+        double vertexTime;
+        bool separable; // draws and vertices weren't proportional across runs
+        bool valid;
+
+        double frameTime(double draws, double vertices) const;
+    };
+
+  public:
+    CostModel(const std::string& label);
+
+    // Runs without benchmark statistics or without draw calls are ignored
+    void addRun(float sceneScale, float sceneDetail, const BenchmarkResult& result);
+
+    std::size_t sizes() const;
+    Model fit() const;
+
+    void print(std::ostream& stream) const;
+
+  private:
+    struct Sample
+    {
+        float sceneScale;
+        float sceneDetail;
+        double draws;
+        double vertices;
+        double frameTime;
+    };
+
+    std::string _label;
+    std::vector<Sample> _samples;
+};
+}
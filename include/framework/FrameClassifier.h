@@ -0,0 +1,62 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+
+namespace framework {
+enum class FrameStage
+{
+    Application, // own CPU work of the test, everything not measured by other stages
+    Driver,      // API calls doing the work (GL draw calls, VK command buffer recording and submission)
+    GpuWait,     // waiting for GPU to finish previous frames (fences)
+    Present,     // swapping buffers, acquiring and presenting swapchain images
+};
+
+/**
+ * Classifies frames as application-, driver-, GPU wait- or present-bound.
+ *
+ * Render thread measures its driver, GPU wait and present stages with `FrameStageTimer` guards,
+ * the rest of each frame is the application stage. Every frame is counted for the stage it spent
+ * most of its time in.
+ */
+class FrameClassifier
+{
+  public:
+    static const std::size_t kStageCount = 4u;
+
+  public:
+    FrameClassifier();
+
+    void reset();
+    void addStageTime(FrameStage stage, double time);
+    void finishFrame(double frameTime);
+
+    std::size_t frames() const;
+    std::size_t frames(FrameStage boundBy) const;
+    double averageTime(FrameStage stage) const;
+
+    static const char* name(FrameStage stage);
+    static const char* key(FrameStage stage);
+
+  private:
+    std::array<double, kStageCount> _currentFrame;
+    std::array<double, kStageCount> _totalTimes;
+    std::array<std::size_t, kStageCount> _boundFrames;
+    std::size_t _frames;
+};
+
+class FrameStageTimer
+{
+  public:
+    FrameStageTimer(FrameClassifier& classifier, FrameStage stage);
+    FrameStageTimer(const FrameStageTimer&) = delete;
+    ~FrameStageTimer();
+
+    FrameStageTimer& operator=(const FrameStageTimer&) = delete;
+
+  private:
+    FrameClassifier& _classifier;
+    FrameStage _stage;
+    double _start;
+};
+}
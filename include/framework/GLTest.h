@@ -2,20 +2,25 @@
 
 #include <base/gl/Window.h>
 #include <framework/BenchmarkableTest.h>
+#include <framework/TestConfiguration.h>
 
 namespace framework {
 class GLTest : public BenchmarkableTest
 {
   public:
-    GLTest(const std::string& testName, bool benchmarkMode, float benchmarkTime);
+    GLTest(const std::string& testName, const TestConfiguration& configuration);
     virtual ~GLTest() = default;
 
     virtual void setup() override;
     virtual void teardown() override;
 
     void printStatistics() const override;
+    void exportStatistics(BenchmarkResult& result) const override;
 
   protected:
+    void updateWindow();
+    std::vector<GpuMemoryUsage> gpuMemoryUsage() const override;
+
     base::gl::Window window_;
 };
 }
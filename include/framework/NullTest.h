@@ -0,0 +1,57 @@
+#pragma once
+
+#include <framework/BenchmarkableTest.h>
+#include <framework/TestConfiguration.h>
+
+#include <glm/matrix.hpp>
+
+#include <array>
+#include <cstddef>
+#include <string>
+
+namespace framework {
+/**
+ * Base class of tests without any graphics API.
+ *
+ * Tests run the same scene update and walk the same draw lists as their OpenGL/Vulkan versions,
+ * but uniform updates and draw calls go to a no-op sink, so comparing results shows how much
+ * of a frame is spent in the API and its driver.
+ */
+class NullTest : public BenchmarkableTest
+{
+  public:
+    NullTest(const std::string& testName, const TestConfiguration& configuration);
+    virtual ~NullTest() = default;
+
+    virtual void setup() override;
+    virtual void teardown() override;
+
+    void printStatistics() const override;
+    void exportStatistics(BenchmarkResult& result) const override;
+
+  protected:
+    void update();
+    bool shouldClose() const;
+    double frameTime() const;
+    const std::string& title() const;
+
+    void setUniform(const glm::vec4& value);
+    void setUniform(const glm::mat4& value);
+    void draw(std::size_t count, std::ptrdiff_t offset);
+
+  private:
+    void setUniformData(const void* data, std::size_t size);
+
+    std::string _title;
+    double _lastFrameMeasure;
+    double _lastFpsMeasure;
+    double _frameTime;
+    std::size_t _framesCount;
+
+    std::array<unsigned char, sizeof(glm::mat4)> _uniformData;
+    std::size_t _uniformUpdates;
+    std::size_t _drawCalls;
+    std::size_t _drawnElements;
+    std::size_t _frames;
+};
+}
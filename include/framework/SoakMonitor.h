@@ -0,0 +1,82 @@
+#pragma once
+
+#include <base/Histogram.h>
+#include <framework/BenchmarkResult.h>
+
+#include <cstddef>
+#include <ostream>
+#include <vector>
+
+namespace framework {
+/**
+ * Windowed statistics of long (soak) benchmark runs.
+ *
+ * Frame times are streamed into a histogram, which is summarized and reset at the end of every window
+ * together with CPU frequency, temperature and resident set size readings. Memory is bounded by the
+ * histogram and a small record per window (a few hundred records per hour with 10s windows).
+ *
+ * Drift is detected by comparing medians of the first and the last quarter of windows: frame time
+ * creep (median frame time grows), memory growth (resident set grows) and throttling (CPU frequency drops).
+ */
+class SoakMonitor
+{
+  public:
+    struct Window
+    {
+        double startTime; // seconds since start of measurement
+        double length;
+        std::size_t frames;
+        double averageFrameTime;
+        double medianFrameTime;
+        double p99FrameTime;
+        double maxFrameTime;
+        bool hasCpuFrequency;
+        double cpuFrequency; // MHz
+        bool hasTemperature;
+        double temperature; // degrees Celsius
+        std::size_t residentBytes;
+    };
+
+    struct Drift
+    {
+        bool valid; // enough windows to compare
+        double frameTimeChange; // relative
+        bool frameTimeCreep;
+        double memoryGrowth; // bytes
+        double memoryGrowthRate; // bytes per hour
+        bool memoryGrowing;
+        bool hasCpuFrequency;
+        double firstCpuFrequency;
+        double lastCpuFrequency;
+        bool hasTemperature;
+        double firstTemperature;
+        double lastTemperature;
+        bool throttling;
+    };
+
+  public:
+    SoakMonitor(double windowLength);
+
+    bool enabled() const;
+
+    void reset(double now);
+    void addFrame(double frameTime, double now);
+    // Closes last window, unless it's too short to be comparable with the others
+    void finish(double now);
+
+    const std::vector<Window>& windows() const;
+    Drift drift() const;
+
+    void print(std::ostream& stream) const;
+    void exportResults(BenchmarkResult& result) const;
+
+  private:
+    void closeWindow(double now);
+
+    double _windowLength; // seconds, 0 if disabled
+    double _startTime;
+    double _windowStart;
+    base::Histogram _frameTimes;
+    std::vector<Window> _windows;
+};
+}
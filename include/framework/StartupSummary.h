@@ -0,0 +1,41 @@
+#pragma once
+
+#include <framework/BenchmarkResult.h>
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace framework {
+/**
+ * Distribution of startup phase times over repeated runs of a configuration in one process.
+ *
+ * First run is reported as cold (nothing initialized or cached by the process yet), median, minimum
+ * and maximum of the following runs as warm. Drivers and the OS keep some caches across processes
+ * (e.g. shader and pipeline caches), so a cold run isn't necessarily cold for them.
+ */
+class StartupSummary
+{
+  public:
+    StartupSummary(const std::string& label);
+
+    // Runs without startup phases are ignored
+    void addRun(const BenchmarkResult& result);
+
+    std::size_t runs() const;
+
+    void print(std::ostream& stream) const;
+
+  private:
+    struct Phase
+    {
+        std::string key;
+        std::vector<double> times; // milliseconds, by run (negative if the phase wasn't recorded)
+    };
+
+    std::string _label;
+    std::size_t _runs;
+    std::vector<Phase> _phases;
+};
+}
@@ -0,0 +1,34 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+
+namespace framework {
+struct TestConfiguration
+{
+    int testNumber;
+    std::string api;
+    bool multithreaded;
+    std::size_t threads; // worker threads of multithreaded tests, 0 means `std::thread::hardware_concurrency()`
+    bool benchmarkMode;
+    float benchmarkTime;
+    std::size_t benchmarkFrames; // fixed number of measured frames instead of time, if not 0
+    float soakWindow; // length of windows of soak statistics in seconds, 0 disables them
+    bool offscreen;
+
+    // Scene of the next frame is updated on a worker while the current one is recorded and submitted
+    bool pipelined;
+    std::size_t framesInFlight; // frames recorded ahead of GPU, 0 means one per swapchain image
+
+    // Multipliers of number of objects in the scene and of their geometric detail, 1 is the default scene
+    float sceneScale;
+    float sceneDetail;
+
+    std::size_t repetition;
+
+    // Fixed simulation time step and seeded random generator, so frame N is identical across runs and APIs
+    bool deterministic;
+    uint32_t seed;
+};
+}
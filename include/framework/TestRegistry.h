@@ -0,0 +1,56 @@
+#pragma once
+
+#include <framework/BenchmarkableTest.h>
+#include <framework/TestConfiguration.h>
+
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace framework {
+class TestRegistry
+{
+  public:
+    using Factory = std::function<std::unique_ptr<BenchmarkableTest>(const TestConfiguration&)>;
+
+    // Optional parameters of a configuration, which are accepted only by tests using them
+    enum Feature : unsigned int
+    {
+        NoFeatures = 0u,
+        SceneScale = 1u << 0,
+        SceneDetail = 1u << 1,
+        Pipelining = 1u << 2, // `-pipeline` and `-inflight`
+    };
+
+    TestRegistry() = default;
+
+    static TestRegistry createDefault();
+
+    void add(int testNumber, const std::string& api, bool multithreaded, Factory factory,
+             unsigned int features = NoFeatures);
+
+    bool contains(int testNumber, const std::string& api, bool multithreaded) const;
+    bool supports(int testNumber, const std::string& api, bool multithreaded, Feature feature) const;
+    bool containsTest(int testNumber) const;
+    bool containsApi(const std::string& api) const;
+    std::vector<std::string> apis() const;
+    int maxTestNumber() const;
+
+    std::unique_ptr<BenchmarkableTest> create(const TestConfiguration& configuration) const;
+
+  private:
+    struct Entry
+    {
+        int testNumber;
+        std::string api;
+        bool multithreaded;
+        Factory factory;
+        unsigned int features;
+    };
+
+    const Entry* find(int testNumber, const std::string& api, bool multithreaded) const;
+
+    std::vector<Entry> _entries;
+};
+}
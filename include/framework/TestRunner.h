@@ -1,9 +1,14 @@
 #pragma once
 
 #include <base/ArgumentParser.h>
+#include <framework/BenchmarkResult.h>
 #include <framework/BenchmarkableTest.h>
+#include <framework/TestConfiguration.h>
+#include <framework/TestRegistry.h>
 
 #include <memory>
+#include <string>
+#include <vector>
 
 namespace framework {
 class TestRunner
@@ -14,10 +19,35 @@ class TestRunner
     int run();
 
   private:
-    int run_gl(int testNumber, bool multithreaded, bool benchmarkMode, float benchmarkTime, double testStartTime);
-    int run_vk(int testNumber, bool multithreaded, bool benchmarkMode, float benchmarkTime, double testStartTime);
-    int run_any(std::unique_ptr<BenchmarkableTest> test, double testStartTime);
+    int run_suite(const std::vector<TestConfiguration>& configurations,
+                  std::size_t repetitions,
+                  double cooldown,
+                  std::vector<std::vector<BenchmarkResult>>& results);
+    int run_configuration(const TestConfiguration& configuration, BenchmarkResult& result);
+    int run_any(std::unique_ptr<BenchmarkableTest> test, double testStartTime, BenchmarkResult& result);
+    void printMultithreadingSpeedup(const std::vector<TestConfiguration>& configurations,
+                                    const std::vector<std::vector<BenchmarkResult>>& results) const;
+    void printThreadScaling(const std::vector<TestConfiguration>& configurations,
+                            const std::vector<std::vector<BenchmarkResult>>& results) const;
+    void printCostModels(const std::vector<TestConfiguration>& configurations,
+                         const std::vector<std::vector<BenchmarkResult>>& results) const;
+    void printStartupSummaries(const std::vector<TestConfiguration>& configurations,
+                               const std::vector<std::vector<BenchmarkResult>>& results) const;
+
+    std::vector<TestConfiguration> expandConfigurations(const base::ArgumentParser& args) const;
+    std::vector<TestConfiguration> readSuite(const std::string& suitePath) const;
+    std::string describeConfiguration(const TestConfiguration& configuration) const;
+    std::string comparisonLabel(const TestConfiguration& configuration, const TestConfiguration& other) const;
+
+    BenchmarkResult describeRun(const TestConfiguration& configuration) const;
+    bool writeResult(const BenchmarkResult& result) const;
+    bool writeCsvResult(const BenchmarkResult& result) const;
 
     base::ArgumentParser arguments;
+    TestRegistry registry;
+    std::string outputPath;
+    std::string outputFormat;
+    std::string tracePath;
+    bool compareMode;
 };
 }
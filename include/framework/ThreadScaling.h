@@ -0,0 +1,49 @@
+#pragma once
+
+#include <framework/BenchmarkResult.h>
+
+#include <cstddef>
+#include <map>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace framework {
+/**
+ * Scaling of a multithreaded test with number of its worker threads.
+ *
+ * Median of average frame times of runs with each thread count is fitted (non-negative least squares)
+ * with extended Amdahl's model `T(n) = serial + parallel / n + overhead * (n - 1)`, where overhead is
+ * the cost of every additional thread (starting, joining, contention). Serial fraction is
+ * `serial / (serial + parallel)`, the model's best thread count is `sqrt(parallel / overhead)`.
+ */
+class ThreadScaling
+{
+  public:
+    struct Model
+    {
+        double serialTime;
+        double parallelTime;
+        double overheadTime;
+        bool valid;
+
+        double frameTime(double threads) const;
+        double serialFraction() const;
+    };
+
+  public:
+    ThreadScaling(const std::string& label);
+
+    // Runs without benchmark statistics are ignored
+    void addRun(std::size_t threads, const BenchmarkResult& result);
+
+    std::size_t threadCounts() const;
+    Model fit() const;
+
+    void print(std::ostream& stream) const;
+
+  private:
+    std::string _label;
+    std::map<std::size_t, std::vector<double>> _frameTimes; // average frame times of runs by thread count
+};
+}
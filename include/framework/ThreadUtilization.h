@@ -0,0 +1,86 @@
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+
+namespace framework {
+/**
+ * Utilization of worker threads in fork-join parallel regions of multithreaded tests.
+ *
+ * Render thread measures each region (from starting its workers until the last one is joined) with
+ * `ParallelRegionTimer`, workers measure their tasks with `WorkerTimer`. Time the workers could have
+ * worked in a region but didn't (start latency, imbalance, waiting for the slowest one) is idle time.
+ */
+class ThreadUtilization
+{
+  public:
+    ThreadUtilization();
+    ThreadUtilization(const ThreadUtilization&) = delete;
+
+    ThreadUtilization& operator=(const ThreadUtilization&) = delete;
+
+    void reset();
+    void addRegion(std::size_t workers, double regionTime, double joinTime);
+    void addWorkerTask(double wallTime, double cpuTime); // thread-safe
+
+    std::size_t regions() const;
+    double averageWorkers() const;
+
+    // Total times in seconds
+    double regionTime() const;
+    double joinTime() const;
+    double workerTime() const;
+    double workerCpuTime() const;
+    double workerIdleTime() const;
+
+    // Share of available worker time spent in tasks, and work done per region time
+    double efficiency() const;
+    double speedup() const;
+
+  private:
+    std::atomic<uint64_t> _workerTime; // nanoseconds
+    std::atomic<uint64_t> _workerCpuTime;
+
+    std::size_t _regions;
+    std::size_t _workers;
+    double _regionTime;
+    double _joinTime;
+    double _availableWorkerTime;
+};
+
+class ParallelRegionTimer
+{
+  public:
+    ParallelRegionTimer(ThreadUtilization& utilization, std::size_t workers);
+    ParallelRegionTimer(const ParallelRegionTimer&) = delete;
+    ~ParallelRegionTimer();
+
+    ParallelRegionTimer& operator=(const ParallelRegionTimer&) = delete;
+
+    void beginJoin();
+    void end();
+
+  private:
+    ThreadUtilization& _utilization;
+    std::size_t _workers;
+    double _start;
+    double _joinStart;
+    bool _ended;
+};
+
+class WorkerTimer
+{
+  public:
+    WorkerTimer(ThreadUtilization& utilization);
+    WorkerTimer(const WorkerTimer&) = delete;
+    ~WorkerTimer();
+
+    WorkerTimer& operator=(const WorkerTimer&) = delete;
+
+  private:
+    ThreadUtilization& _utilization;
+    double _start;
+    double _cpuStart;
+};
+}
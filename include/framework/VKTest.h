@@ -2,22 +2,31 @@
 
 #include <base/vkx/Application.h>
 #include <framework/BenchmarkableTest.h>
+#include <framework/TestConfiguration.h>
 
+#include <cstddef>
 #include <string>
 
 namespace framework {
 class VKTest : public BenchmarkableTest, public base::vkx::Application
 {
   public:
-    VKTest(const std::string& testName, bool benchmarkMode, float benchmarkTime);
+    VKTest(const std::string& testName, const TestConfiguration& configuration);
     virtual ~VKTest() = default;
 
     virtual void setup() override;
     virtual void teardown() override;
 
     void printStatistics() const override;
+    void exportStatistics(BenchmarkResult& result) const override;
 
   protected:
-    //
+    // Frames recorded ahead of GPU, each needs its own command buffers, fence and semaphores
+    std::size_t framesInFlight() const;
+
+    std::vector<GpuMemoryUsage> gpuMemoryUsage() const override;
+
+  private:
+    std::size_t _framesInFlight; // 0 means one per swapchain image
 };
 }
@@ -23,7 +23,12 @@ class TerrainLoD
     void executeLoD(const glm::vec2& position, const std::function<void(std::size_t, std::ptrdiff_t)>& function) const;
     void executeLoD(const glm::vec2& position,
                     const std::function<void(std::size_t, std::ptrdiff_t)>& function,
-                    std::size_t nodeIndex) const;
+                    const QTNode& node) const;
+
+    // Disjoint subtrees, which together select the same chunks as the whole tree for given position.
+    // Nodes which would be traversed further are split breadth-first until there are at least `count`
+    // subtrees (or none can be split), so they can be traversed in parallel with `executeLoD(..., node)`.
+    void splitLoD(const glm::vec2& position, std::size_t count, std::vector<const QTNode*>& subtrees) const;
 
   private:
     void load(const Heightmap& heightmap);
@@ -31,6 +36,7 @@ class TerrainLoD
                                QTNode& node,
                                const glm::uvec2& offset,
                                const glm::uvec2& size);
+    bool isDetailedEnough(const glm::vec2& position, const QTNode& node) const;
     void executeLoDRecursive(const glm::vec2& position,
                              const std::function<void(std::size_t, std::ptrdiff_t)>& function,
                              const QTNode& node) const;
@@ -26,5 +26,6 @@
 
 #include <tests/test1/gl/MultithreadedBallsSceneTest.h>
 #include <tests/test1/gl/SimpleBallsSceneTest.h>
+#include <tests/test1/null/SimpleBallsSceneTest.h>
 #include <tests/test1/vk/MultithreadedBallsSceneTest.h>
 #include <tests/test1/vk/SimpleBallsSceneTest.h>
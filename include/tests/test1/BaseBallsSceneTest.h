@@ -10,7 +10,7 @@ namespace tests {
 class BaseBallsSceneTest
 {
   public:
-    BaseBallsSceneTest() = default;
+    BaseBallsSceneTest(float sceneScale, float sceneDetail);
     virtual ~BaseBallsSceneTest() = default;
 
   protected:
@@ -19,11 +19,22 @@ class BaseBallsSceneTest
     void updateTestState(float frameTime, std::size_t rangeFrom, std::size_t rangeTo);
     void destroyTestState();
 
+    // Pipelined tests update the next state from the current one, which stays unchanged, so it can be
+    // recorded at the same time; `swapTestState()` then makes the next state current
+    void initNextTestState();
+    void updateNextTestState(float frameTime);
+    void updateNextTestState(float frameTime, std::size_t rangeFrom, std::size_t rangeTo);
+    void swapTestState();
+
     const std::vector<common::Ball>& balls() const;
     const std::vector<glm::vec4>& vertices() const;
 
   private:
+    std::size_t _ballCount;
+    std::size_t _sphereSlices;
+    std::size_t _sphereStacks;
     std::vector<common::Ball> _balls;
+    std::vector<common::Ball> _nextBalls; // only in pipelined tests
     std::vector<glm::vec4> _vertices;
 };
 }
@@ -12,7 +12,7 @@ namespace test_gl {
 class MultithreadedBallsSceneTest : public BaseBallsSceneTest, public framework::GLTest
 {
   public:
-    MultithreadedBallsSceneTest(bool benchmarkMode, float benchmarkTime);
+    MultithreadedBallsSceneTest(const framework::TestConfiguration& configuration);
 
     void setup() override;
     void run() override;
@@ -12,7 +12,7 @@ namespace test_gl {
 class SimpleBallsSceneTest : public BaseBallsSceneTest, public framework::GLTest
 {
   public:
-    SimpleBallsSceneTest(bool benchmarkMode, float benchmarkTime);
+    SimpleBallsSceneTest(const framework::TestConfiguration& configuration);
 
     void setup() override;
     void run() override;
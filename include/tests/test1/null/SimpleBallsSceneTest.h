@@ -0,0 +1,19 @@
+#pragma once
+
+#include <framework/NullTest.h>
+#include <tests/common/Ball.h>
+#include <tests/test1/BaseBallsSceneTest.h>
+
+namespace tests {
+namespace test_null {
+class SimpleBallsSceneTest : public BaseBallsSceneTest, public framework::NullTest
+{
+  public:
+    SimpleBallsSceneTest(const framework::TestConfiguration& configuration);
+
+    void setup() override;
+    void run() override;
+    void teardown() override;
+};
+}
+}
@@ -1,6 +1,8 @@
 #pragma once
 
+#include <base/TaskGraph.h>
 #include <base/vkx/ShaderModule.h>
+#include <base/vkx/WorkerCommandBuffers.h>
 #include <framework/VKTest.h>
 #include <tests/common/Ball.h>
 #include <tests/test1/BaseBallsSceneTest.h>
@@ -10,19 +12,13 @@ namespace test_vk {
 class MultithreadedBallsSceneTest : public BaseBallsSceneTest, public framework::VKTest
 {
   public:
-    MultithreadedBallsSceneTest(bool benchmarkMode, float benchmarkTime);
+    MultithreadedBallsSceneTest(const framework::TestConfiguration& configuration);
 
     void setup() override;
     void run() override;
     void teardown() override;
 
   private:
-    struct PerThreadSecondaryCommandPool
-    {
-        vk::CommandPool cmdPool;
-        std::vector<vk::CommandBuffer> cmdBuffers;
-    };
-
     void createVbo();
     void createCommandBuffers();
     void createSecondaryCommandBuffers();
@@ -33,6 +29,7 @@ class MultithreadedBallsSceneTest : public BaseBallsSceneTest, public framework:
     void createShaders();
     void createPipelineLayout();
     void createPipeline();
+    void createFrameGraph();
 
     void destroyPipeline();
     void destroyPipelineLayout();
@@ -46,23 +43,22 @@ class MultithreadedBallsSceneTest : public BaseBallsSceneTest, public framework:
     void destroyVbo();
 
     std::vector<vk::PipelineShaderStageCreateInfo> getShaderStages() const;
-    uint32_t getNextFrameIndex() const;
+    uint32_t getNextImageIndex() const;
 
-    void prepareSecondaryCommandBuffer(std::size_t frameIndex,
-                                       std::size_t bufferIndex,
-                                       std::size_t rangeFrom,
-                                       std::size_t rangeTo);
+    void updateBalls(std::size_t rangeFrom, std::size_t rangeTo);
+    void recordBalls(std::size_t rangeFrom, std::size_t rangeTo, std::size_t worker);
+    const vk::CommandBuffer& workerCommandBuffer(std::size_t worker);
 
-    void prepareCommandBuffer(std::size_t frameIndex);
-    void submitCommandBuffer(std::size_t frameIndex);
-    void presentFrame(std::size_t frameIndex);
+    void prepareCommandBuffer(std::size_t imageIndex);
+    void submitCommandBuffer();
+    void presentFrame(std::size_t imageIndex);
 
     base::vkx::Buffer _vbo;
     vk::CommandPool _cmdPool;
     std::vector<vk::CommandBuffer> _cmdBuffers;
-    std::vector<PerThreadSecondaryCommandPool> _threadCmdPools;
+    base::vkx::WorkerCommandBuffers _workerCmdBuffers;
     std::vector<vk::Fence> _fences;
-    mutable std::size_t _semaphoreIndex;
+    mutable std::size_t _frameIndex; // frame in flight, which owns command buffers, fence and semaphores in use
     std::vector<vk::Semaphore> _acquireSemaphores;
     std::vector<vk::Semaphore> _renderSemaphores;
     vk::RenderPass _renderPass;
@@ -72,6 +68,11 @@ class MultithreadedBallsSceneTest : public BaseBallsSceneTest, public framework:
     vk::Pipeline _pipeline;
     base::vkx::ShaderModule _vertexModule;
     base::vkx::ShaderModule _fragmentModule;
+
+    // Balls are updated and then recorded, both stages in ranges balanced by the thread pool;
+    // pipelined frames update the next state while the current one is recorded, both stages run at once
+    base::TaskGraph _frameGraph;
+    std::size_t _recordedImageIndex;
 };
 }
 }
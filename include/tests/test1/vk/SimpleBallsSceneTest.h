@@ -11,7 +11,7 @@ namespace test_vk {
 class SimpleBallsSceneTest : public BaseBallsSceneTest, public framework::VKTest
 {
   public:
-    SimpleBallsSceneTest(bool benchmarkMode, float benchmarkTime);
+    SimpleBallsSceneTest(const framework::TestConfiguration& configuration);
 
     void setup() override;
     void run() override;
@@ -39,16 +39,18 @@ class SimpleBallsSceneTest : public BaseBallsSceneTest, public framework::VKTest
     void destroyVbo();
 
     std::vector<vk::PipelineShaderStageCreateInfo> getShaderStages() const;
-    uint32_t getNextFrameIndex() const;
-    void prepareCommandBuffer(std::size_t frameIndex) const;
-    void submitCommandBuffer(std::size_t frameIndex) const;
-    void presentFrame(std::size_t frameIndex) const;
+    void beginStateUpdate();
+    void finishStateUpdate();
+    uint32_t getNextImageIndex() const;
+    void prepareCommandBuffer(std::size_t imageIndex) const;
+    void submitCommandBuffer() const;
+    void presentFrame(std::size_t imageIndex) const;
 
     base::vkx::Buffer _vbo;
     vk::CommandPool _cmdPool;
     std::vector<vk::CommandBuffer> _cmdBuffers;
     std::vector<vk::Fence> _fences;
-    mutable std::size_t _semaphoreIndex;
+    mutable std::size_t _frameIndex; // frame in flight, which owns command buffer, fence and semaphores in use
     std::vector<vk::Semaphore> _acquireSemaphores;
     std::vector<vk::Semaphore> _renderSemaphores;
     vk::RenderPass _renderPass;
@@ -8,7 +8,7 @@ namespace tests {
 class BaseTerrainSceneTest
 {
   public:
-    BaseTerrainSceneTest();
+    BaseTerrainSceneTest(float sceneScale);
     virtual ~BaseTerrainSceneTest() = default;
 
   protected:
@@ -21,5 +21,6 @@ class BaseTerrainSceneTest
   private:
     common::TerrainLoD _terrain;
     glm::vec2 _position;
+    double _time;
 };
 }
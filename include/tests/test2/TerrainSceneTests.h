@@ -16,12 +16,15 @@
  * - level-of-detail change factor.
  * Both of these values are tuned to work nicely, so it's recommended to not change them.
  *
- * OpenGL multithreaded version, due to lack of heavy CPU-related workload, is absent.
- * Vulkan multithreaded version schedules traversal of quad-tree and building secondary
- * command buffers on 4 threads.
+ * OpenGL multithreaded version traverses subtrees of quad-tree on worker threads, which write
+ * indirect draw commands into a persistently mapped buffer, drawn with one multi-draw call.
+ * Vulkan multithreaded version splits quad-tree into subtrees for any number of threads,
+ * traverses them and builds secondary command buffers on all available threads.
  *
  */
 
+#include <tests/test2/gl/MultithreadedTerrainSceneTest.h>
 #include <tests/test2/gl/TerrainSceneTest.h>
+#include <tests/test2/null/TerrainSceneTest.h>
 #include <tests/test2/vk/MultithreadedTerrainSceneTest.h>
 #include <tests/test2/vk/TerrainSceneTest.h>
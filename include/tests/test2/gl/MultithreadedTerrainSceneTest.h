@@ -0,0 +1,68 @@
+#pragma once
+
+#include <base/TaskGraph.h>
+#include <base/gl/MappedRingBuffer.h>
+#include <base/gl/Program.h>
+#include <base/gl/VertexArray.h>
+#include <base/gl/VertexBuffer.h>
+#include <framework/GLTest.h>
+#include <tests/common/QTNode.h>
+#include <tests/test2/BaseTerrainSceneTest.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace tests {
+namespace test_gl {
+class MultithreadedTerrainSceneTest : public BaseTerrainSceneTest, public framework::GLTest
+{
+  public:
+    MultithreadedTerrainSceneTest(const framework::TestConfiguration& configuration);
+
+    void setup() override;
+    void run() override;
+    void teardown() override;
+
+  private:
+    // Layout of indirect indexed draw, as read by GL from the draw indirect buffer
+    struct DrawElementsIndirectCommand
+    {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint firstIndex;
+        GLint baseVertex;
+        GLuint baseInstance;
+    };
+
+    void checkExtensions() const;
+    void initApplication();
+    void initProgram();
+    void initVBO();
+    void initIBO();
+    void initVAO();
+    void initCommandBuffer();
+    void initFrameGraph();
+
+    void traverseSubtrees(std::size_t rangeFrom, std::size_t rangeTo);
+    void gatherCommands();
+    void writeCommands(std::size_t rangeFrom, std::size_t rangeTo);
+    std::size_t commandCapacity() const;
+    void prepareCommands();
+
+    base::gl::Program _program;
+    base::gl::VertexArray _vao;
+    base::gl::VertexBuffer _vbo;
+    base::gl::Buffer _ibo;
+
+    // Workers write indirect draws straight into the mapped buffer, GL thread issues them in one call
+    base::gl::MappedRingBuffer _commands;
+    base::TaskGraph _frameGraph;
+    base::TaskGraph::Node _traverseNode;
+    base::TaskGraph::Node _writeNode;
+    std::vector<const common::QTNode*> _subtrees;
+    std::vector<std::vector<DrawElementsIndirectCommand>> _subtreeCommands;
+    std::vector<std::size_t> _subtreeOffsets;
+    std::size_t _commandCount;
+};
+}
+}
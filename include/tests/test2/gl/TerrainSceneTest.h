@@ -11,7 +11,7 @@ namespace test_gl {
 class TerrainSceneTest : public BaseTerrainSceneTest, public framework::GLTest
 {
   public:
-    TerrainSceneTest(bool benchmarkMode, float benchmarkTime);
+    TerrainSceneTest(const framework::TestConfiguration& configuration);
 
     void setup() override;
     void run() override;
@@ -0,0 +1,18 @@
+#pragma once
+
+#include <framework/NullTest.h>
+#include <tests/test2/BaseTerrainSceneTest.h>
+
+namespace tests {
+namespace test_null {
+class TerrainSceneTest : public BaseTerrainSceneTest, public framework::NullTest
+{
+  public:
+    TerrainSceneTest(const framework::TestConfiguration& configuration);
+
+    void setup() override;
+    void run() override;
+    void teardown() override;
+};
+}
+}
@@ -2,25 +2,31 @@
 
 #include <framework/VKTest.h>
 
+#include <base/TaskGraph.h>
 #include <base/vkx/ShaderModule.h>
+#include <base/vkx/WorkerCommandBuffers.h>
+#include <tests/common/QTNode.h>
 #include <tests/test2/BaseTerrainSceneTest.h>
 
+#include <cstddef>
+#include <vector>
+
 namespace tests {
 namespace test_vk {
 class MultithreadedTerrainSceneTest : public BaseTerrainSceneTest, public framework::VKTest
 {
   public:
-    MultithreadedTerrainSceneTest(bool benchmarkMode, float benchmarkTime);
+    MultithreadedTerrainSceneTest(const framework::TestConfiguration& configuration);
 
     void setup() override;
     void run() override;
     void teardown() override;
 
   private:
-    struct PerThreadSecondaryCommandPool
+    struct Chunk
     {
-        vk::CommandPool cmdPool;
-        std::vector<vk::CommandBuffer> cmdBuffers;
+        std::size_t indexCount;
+        std::ptrdiff_t indexOffset;
     };
 
     void createVbo();
@@ -34,6 +40,7 @@ class MultithreadedTerrainSceneTest : public BaseTerrainSceneTest, public framew
     void createShaders();
     void createPipelineLayout();
     void createPipeline();
+    void createFrameGraph();
 
     void destroyPipeline();
     void destroyPipelineLayout();
@@ -50,8 +57,12 @@ class MultithreadedTerrainSceneTest : public BaseTerrainSceneTest, public framew
     std::vector<vk::PipelineShaderStageCreateInfo> getShaderStages() const;
     uint32_t getNextFrameIndex() const;
 
-    void prepareSecondaryCommandBuffer(std::size_t frameIndex, std::size_t bufferIndex) const;
-    void prepareCommandBuffer(std::size_t frameIndex) const;
+    void traverseSubtrees(std::size_t rangeFrom, std::size_t rangeTo);
+    void gatherChunks();
+    void recordChunks(std::size_t sliceFrom, std::size_t sliceTo, std::size_t worker);
+    const vk::CommandBuffer& workerCommandBuffer(std::size_t worker);
+
+    void prepareCommandBuffer(std::size_t frameIndex);
     void submitCommandBuffer(std::size_t frameIndex) const;
     void presentFrame(std::size_t frameIndex) const;
 
@@ -59,7 +70,7 @@ class MultithreadedTerrainSceneTest : public BaseTerrainSceneTest, public framew
     base::vkx::Buffer _ibo;
     vk::CommandPool _cmdPool;
     std::vector<vk::CommandBuffer> _cmdBuffers;
-    std::vector<PerThreadSecondaryCommandPool> _threadCmdPools;
+    base::vkx::WorkerCommandBuffers _workerCmdBuffers;
     std::vector<vk::Fence> _fences;
     mutable std::size_t _semaphoreIndex;
     std::vector<vk::Semaphore> _acquireSemaphores;
@@ -71,6 +82,14 @@ class MultithreadedTerrainSceneTest : public BaseTerrainSceneTest, public framew
     vk::Pipeline _pipeline;
     base::vkx::ShaderModule _vertexModule;
     base::vkx::ShaderModule _fragmentModule;
+
+    // Subtrees of the terrain are traversed, their chunks gathered and split evenly between recording workers
+    base::TaskGraph _frameGraph;
+    base::TaskGraph::Node _traverseNode;
+    std::vector<const common::QTNode*> _subtrees;
+    std::vector<std::vector<Chunk>> _subtreeChunks;
+    std::vector<Chunk> _chunks;
+    std::size_t _recordedFrameIndex;
 };
 }
 }
@@ -8,7 +8,7 @@ namespace tests {
 class BaseShadowMappingSceneTest
 {
   public:
-    BaseShadowMappingSceneTest();
+    BaseShadowMappingSceneTest(float sceneScale, float sceneDetail);
     virtual ~BaseShadowMappingSceneTest() = default;
 
   protected:
@@ -23,13 +23,15 @@ class BaseShadowMappingSceneTest
 
   private:
     void initMatrices();
-    void createRenderObjects();
+    void createRenderObjects(float sceneScale, float sceneDetail);
 
     std::vector<common::RenderObject> _renderObjects;
     glm::mat4 _renderMatrix;
     glm::mat4 _shadowMatrix;
+    glm::uvec2 _shadowmapSize;
 
     glm::mat4 _projectionMatrix;
     glm::mat4 _viewMatrix;
+    double _time;
 };
 }
@@ -15,11 +15,14 @@
  * - position and direction of light source.
  * Both of these values are tuned to work nicely, so it's recommended to not change them.
  *
- * OpenGL multithreaded version, due to lack of heavy CPU-related workload, is absent.
+ * OpenGL multithreaded version computes matrices and indirect draw commands of objects on worker
+ * threads into persistently mapped buffers, each pass is drawn with one multi-draw call.
  * Vulkan multithreaded version schedules building secondary command buffers on all available threads.
  *
  */
 
+#include <tests/test3/gl/MultithreadedShadowMappingSceneTest.h>
 #include <tests/test3/gl/ShadowMappingSceneTest.h>
+#include <tests/test3/null/ShadowMappingSceneTest.h>
 #include <tests/test3/vk/MultithreadedShadowMappingSceneTest.h>
 #include <tests/test3/vk/ShadowMappingSceneTest.h>
@@ -0,0 +1,87 @@
+#pragma once
+
+#include <base/gl/GpuTimer.h>
+#include <base/gl/MappedRingBuffer.h>
+#include <base/gl/Program.h>
+#include <base/gl/VertexArray.h>
+#include <base/gl/VertexBuffer.h>
+#include <framework/GLTest.h>
+#include <tests/test3/BaseShadowMappingSceneTest.h>
+
+#include <cstddef>
+#include <vector>
+
+namespace tests {
+namespace test_gl {
+class MultithreadedShadowMappingSceneTest : public BaseShadowMappingSceneTest, public framework::GLTest
+{
+  public:
+    MultithreadedShadowMappingSceneTest(const framework::TestConfiguration& configuration);
+
+    void setup() override;
+    void run() override;
+    void teardown() override;
+
+  private:
+    // Objects share one VBO, each one is a range of its vertices
+    struct GLRenderObject
+    {
+        glm::mat4 modelMatrix;
+        GLuint firstVertex;
+        GLuint vertexCount;
+    };
+
+    // Read by both passes as per-instance attributes, each pass takes its own matrices
+    struct ObjectData
+    {
+        glm::mat4 shadowMVP;
+        glm::mat4 MVP;
+        glm::mat4 depthMVP;
+    };
+
+    // Layout of indirect non-indexed draw, as read by GL from the draw indirect buffer
+    struct DrawArraysIndirectCommand
+    {
+        GLuint count;
+        GLuint instanceCount;
+        GLuint first;
+        GLuint baseInstance;
+    };
+
+    void checkExtensions() const;
+    void initApplication();
+    void initShadowmapObjects();
+    void initPrograms();
+    void initRenderObjects();
+    void initObjectBuffers();
+    void initVAO(base::gl::VertexArray& vao, const std::vector<std::size_t>& matrixOffsets);
+
+    void setupShadowStage();
+    void setupRenderStage();
+    void writeObjects(std::size_t rangeFrom, std::size_t rangeTo);
+    void prepareObjects();
+    void render(const base::gl::VertexArray& vao);
+
+    glm::mat4 convertProjectionToImage(const glm::mat4& matrix) const;
+
+    GLuint _shadowmapFramebuffer;
+    GLuint _shadowmapTexture;
+    base::gl::Program _shadowProgram;
+    base::gl::Program _renderProgram;
+    std::vector<GLRenderObject> _glRenderObjects;
+    base::gl::VertexBuffer _vbo;
+    base::gl::VertexArray _shadowVao;
+    base::gl::VertexArray _renderVao;
+
+    // Workers write matrices and indirect draws of objects straight into the mapped buffers,
+    // GL thread draws all objects of a pass in one call
+    base::gl::MappedRingBuffer _objectData;
+    base::gl::MappedRingBuffer _commands;
+
+    // Timer pass indices are the same as registered GPU passes
+    base::gl::GpuTimer _gpuTimer;
+    std::size_t _shadowGpuPass;
+    std::size_t _renderGpuPass;
+};
+}
+}
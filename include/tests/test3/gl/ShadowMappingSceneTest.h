@@ -1,5 +1,6 @@
 #pragma once
 
+#include <base/gl/GpuTimer.h>
 #include <base/gl/Program.h>
 #include <base/gl/VertexArray.h>
 #include <base/gl/VertexBuffer.h>
@@ -11,7 +12,7 @@ namespace test_gl {
 class ShadowMappingSceneTest : public BaseShadowMappingSceneTest, public framework::GLTest
 {
   public:
-    ShadowMappingSceneTest(bool benchmarkMode, float benchmarkTime);
+    ShadowMappingSceneTest(const framework::TestConfiguration& configuration);
 
     void setup() override;
     void run() override;
@@ -54,6 +55,11 @@ class ShadowMappingSceneTest : public BaseShadowMappingSceneTest, public framewo
     base::gl::Program _shadowProgram;
     base::gl::Program _renderProgram;
     std::vector<GLRenderObject> _glRenderObjects;
+
+    // Timer pass indices are the same as registered GPU passes
+    base::gl::GpuTimer _gpuTimer;
+    std::size_t _shadowGpuPass;
+    std::size_t _renderGpuPass;
 };
 }
 }
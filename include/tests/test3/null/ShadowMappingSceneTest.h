@@ -0,0 +1,23 @@
+#pragma once
+
+#include <framework/NullTest.h>
+#include <tests/test3/BaseShadowMappingSceneTest.h>
+
+namespace tests {
+namespace test_null {
+class ShadowMappingSceneTest : public BaseShadowMappingSceneTest, public framework::NullTest
+{
+  public:
+    ShadowMappingSceneTest(const framework::TestConfiguration& configuration);
+
+    void setup() override;
+    void run() override;
+    void teardown() override;
+
+  private:
+    void render(const glm::mat4& viewProjectionMatrix, bool withShadowMatrix);
+
+    glm::mat4 convertProjectionToImage(const glm::mat4& matrix) const;
+};
+}
+}
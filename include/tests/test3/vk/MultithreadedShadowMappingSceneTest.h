@@ -2,7 +2,10 @@
 
 #include <framework/VKTest.h>
 
+#include <base/TaskGraph.h>
+#include <base/vkx/GpuTimer.h>
 #include <base/vkx/ShaderModule.h>
+#include <base/vkx/WorkerCommandBuffers.h>
 #include <tests/test3/BaseShadowMappingSceneTest.h>
 
 #include <string>
@@ -12,7 +15,7 @@ namespace test_vk {
 class MultithreadedShadowMappingSceneTest : public BaseShadowMappingSceneTest, public framework::VKTest
 {
   public:
-    MultithreadedShadowMappingSceneTest(bool benchmarkMode, float benchmarkTime);
+    MultithreadedShadowMappingSceneTest(const framework::TestConfiguration& configuration);
 
     void setup() override;
     void run() override;
@@ -26,6 +29,13 @@ class MultithreadedShadowMappingSceneTest : public BaseShadowMappingSceneTest, p
         base::vkx::Buffer vbo;
     };
 
+    // Written by transform stage of a frame, read by both recording stages
+    struct VkObjectMatrices
+    {
+        glm::mat4 shadowmapMVP;
+        glm::mat4 renderMatrices[2]; // MVP and shadowmap image matrix, pushed together
+    };
+
     struct VkProgram
     {
         VkProgram() {}
@@ -68,13 +78,6 @@ class MultithreadedShadowMappingSceneTest : public BaseShadowMappingSceneTest, p
         std::vector<vk::Framebuffer> framebuffers;
     };
 
-    struct PerThreadSecondaryCommandPool
-    {
-        vk::CommandPool cmdPool;
-        std::vector<vk::CommandBuffer> shadowmapCmdBuffers;
-        std::vector<vk::CommandBuffer> renderCmdBuffers;
-    };
-
     void prepareShadowmapPass();
     void prepareRenderPass();
     void destroyPass(VkPass& pass);
@@ -84,6 +87,7 @@ class MultithreadedShadowMappingSceneTest : public BaseShadowMappingSceneTest, p
     void createSecondaryCommandBuffers();
     void createSemaphores();
     void createFences();
+    void createFrameGraph();
     VkDepthBuffer createDepthBuffer(const glm::uvec2& size, vk::ImageUsageFlags usage);
     vk::RenderPass createShadowmapRenderPass();
     vk::RenderPass createRenderRenderPass();
@@ -126,18 +130,19 @@ class MultithreadedShadowMappingSceneTest : public BaseShadowMappingSceneTest, p
 
     std::vector<vk::PipelineShaderStageCreateInfo> getShaderStages(const VkProgram& program) const;
     uint32_t getNextFrameIndex() const;
-    void prepareSecondaryCommandBuffer(std::size_t threadIndex,
-                                       std::size_t frameIndex,
-                                       std::size_t rangeFrom,
-                                       std::size_t rangeTo) const;
-    void prepareCommandBuffer(std::size_t frameIndex) const;
+    void transformObjects(std::size_t rangeFrom, std::size_t rangeTo);
+    void recordShadowmapObjects(std::size_t rangeFrom, std::size_t rangeTo, std::size_t worker);
+    void recordRenderObjects(std::size_t rangeFrom, std::size_t rangeTo, std::size_t worker);
+    const vk::CommandBuffer& beginWorkerCommandBuffer(const VkPass& pass, std::size_t worker);
+    void prepareCommandBuffer(std::size_t frameIndex);
     void submitCommandBuffer(std::size_t frameIndex) const;
     void presentFrame(std::size_t frameIndex) const;
 
     std::vector<VkRenderObject> _vkRenderObjects;
+    std::vector<VkObjectMatrices> _objectMatrices;
     vk::CommandPool _cmdPool;
     std::vector<vk::CommandBuffer> _cmdBuffers;
-    std::vector<PerThreadSecondaryCommandPool> _threadCmdPools;
+    base::vkx::WorkerCommandBuffers _workerCmdBuffers; // shadowmap and render pass
     std::vector<vk::Fence> _fences;
     mutable std::size_t _semaphoreIndex;
     std::vector<vk::Semaphore> _acquireSemaphores;
@@ -145,6 +150,15 @@ class MultithreadedShadowMappingSceneTest : public BaseShadowMappingSceneTest, p
 
     VkPass _shadowmapPass;
     VkPass _renderPass;
+
+    // Timer pass indices are the same as registered GPU passes
+    base::vkx::GpuTimer _gpuTimer;
+    std::size_t _shadowGpuPass;
+    std::size_t _renderGpuPass;
+
+    // Objects are transformed, then recorded into both passes at the same time
+    base::TaskGraph _frameGraph;
+    std::size_t _recordedFrameIndex;
 };
 }
 }
@@ -2,6 +2,7 @@
 
 #include <framework/VKTest.h>
 
+#include <base/vkx/GpuTimer.h>
 #include <base/vkx/ShaderModule.h>
 #include <tests/test3/BaseShadowMappingSceneTest.h>
 
@@ -12,7 +13,7 @@ namespace test_vk {
 class ShadowMappingSceneTest : public BaseShadowMappingSceneTest, public framework::VKTest
 {
   public:
-    ShadowMappingSceneTest(bool benchmarkMode, float benchmarkTime);
+    ShadowMappingSceneTest(const framework::TestConfiguration& configuration);
 
     void setup() override;
     void run() override;
@@ -117,7 +118,7 @@ class ShadowMappingSceneTest : public BaseShadowMappingSceneTest, public framewo
 
     std::vector<vk::PipelineShaderStageCreateInfo> getShaderStages(const VkProgram& program) const;
     uint32_t getNextFrameIndex() const;
-    void prepareCommandBuffer(std::size_t frameIndex) const;
+    void prepareCommandBuffer(std::size_t frameIndex);
     void submitCommandBuffer(std::size_t frameIndex) const;
     void presentFrame(std::size_t frameIndex) const;
 
@@ -131,6 +132,11 @@ class ShadowMappingSceneTest : public BaseShadowMappingSceneTest, public framewo
 
     VkPass _shadowmapPass;
     VkPass _renderPass;
+
+    // Timer pass indices are the same as registered GPU passes
+    base::vkx::GpuTimer _gpuTimer;
+    std::size_t _shadowGpuPass;
+    std::size_t _renderGpuPass;
 };
 }
 }
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <framework/TestConfiguration.h>
+
 #include <glm/vec4.hpp>
 
 #include <vector>
@@ -12,6 +14,8 @@ class BaseInitializationTest
     virtual ~BaseInitializationTest() = default;
 
   protected:
+    static framework::TestConfiguration benchmarkConfiguration(const framework::TestConfiguration& configuration);
+
     const std::vector<glm::vec4>& vertices() const;
 };
 }
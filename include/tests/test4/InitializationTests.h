@@ -11,6 +11,8 @@
  * Both versions measures time from start of application (right before touching graphics API)
  * and includes time for window creation, as some APIs might do some work at that time
  * (e.g. create default frame buffers, pipeline objects etc.).
+ * Time is also broken down into phases (library, instance/context, device, swapchain, shaders,
+ * pipeline with or without cache, first frame), run it with `-repeat N` to compare cold and warm runs.
  *
  * This test doesn't have any configuration options.
  *
@@ -11,7 +11,7 @@ namespace test_gl {
 class InitializationTest : public BaseInitializationTest, public framework::GLTest
 {
   public:
-    InitializationTest();
+    InitializationTest(const framework::TestConfiguration& configuration);
 
     void setup() override;
     void run() override;
@@ -9,7 +9,7 @@ namespace test_vk {
 class InitializationTest : public BaseInitializationTest, public framework::VKTest
 {
   public:
-    InitializationTest();
+    InitializationTest(const framework::TestConfiguration& configuration);
 
     void setup() override;
     void run() override;
@@ -61,6 +61,8 @@ class InitializationTest : public BaseInitializationTest, public framework::VKTe
     vk::Pipeline _pipeline;
     base::vkx::ShaderModule _vertexModule;
     base::vkx::ShaderModule _fragmentModule;
+    mutable bool _firstSubmitted;
+    bool _pipelineCacheLoaded; // from data saved by previous run
 };
 }
 }
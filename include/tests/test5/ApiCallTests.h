@@ -0,0 +1,22 @@
+#pragma once
+
+/**
+ *
+ * Test #5 - API call overhead
+ *
+ * Microbenchmarks of single API operations: draw without any state change, update of shader
+ * constants (push constants vs glUniform4fv), pipeline/program switch, vertex buffer bind,
+ * descriptor set bind (uniform buffer bind in OpenGL) and small buffer update. Each operation
+ * is repeated in a tight loop, loop count is scaled until the loop takes long enough to be
+ * measured reliably and time per call in nanoseconds is reported. State changes alternate
+ * between two objects and are followed by a draw, as drivers usually validate state lazily.
+ *
+ * Vulkan version measures recording of a command buffer (it's never submitted), OpenGL version
+ * measures issuing of the calls (with glFinish after each loop, outside of measured time).
+ *
+ * This test doesn't have any configuration options and always runs in benchmark mode.
+ *
+ */
+
+#include <tests/test5/gl/ApiCallTest.h>
+#include <tests/test5/vk/ApiCallTest.h>
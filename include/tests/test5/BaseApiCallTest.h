@@ -0,0 +1,57 @@
+#pragma once
+
+#include <framework/BenchmarkResult.h>
+#include <framework/TestConfiguration.h>
+
+#include <glm/vec4.hpp>
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace tests {
+class BaseApiCallTest
+{
+  public:
+    BaseApiCallTest() = default;
+    virtual ~BaseApiCallTest() = default;
+
+  protected:
+    // Issues (or records) given number of calls of the measured operation
+    using Batch = std::function<void(std::size_t iterations)>;
+    // Waits until work of the last batch is done, it isn't part of the measured time
+    using Synchronize = std::function<void()>;
+
+    static framework::TestConfiguration benchmarkConfiguration(const framework::TestConfiguration& configuration);
+
+    const std::vector<glm::vec4>& vertices() const;
+
+    // Batch size is doubled until a batch takes long enough for the clock, median of several batches is reported.
+    // State changes are measured together with a draw (drivers validate state lazily), reported also as the extra
+    // time over plain draw, which has to be measured first with key "draw".
+    void measureCall(const std::string& name,
+                     const std::string& key,
+                     bool withDraw,
+                     const Batch& batch,
+                     const Synchronize& synchronize);
+
+    void printCallTimes() const;
+    void exportCallTimes(framework::BenchmarkResult& result) const;
+
+  private:
+    struct CallTime
+    {
+        std::string name;
+        std::string key;
+        bool withDraw;
+        std::size_t iterations;
+        double medianTime; // nanoseconds per call
+        double minTime;
+    };
+
+    const CallTime* findCallTime(const std::string& key) const;
+
+    std::vector<CallTime> _callTimes;
+};
+}
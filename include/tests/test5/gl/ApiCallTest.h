@@ -0,0 +1,42 @@
+#pragma once
+
+#include <base/gl/Buffer.h>
+#include <base/gl/Program.h>
+#include <base/gl/VertexArray.h>
+#include <base/gl/VertexBuffer.h>
+#include <framework/GLTest.h>
+#include <tests/test5/BaseApiCallTest.h>
+
+#include <array>
+
+namespace tests {
+namespace test_gl {
+class ApiCallTest : public BaseApiCallTest, public framework::GLTest
+{
+  public:
+    ApiCallTest(const framework::TestConfiguration& configuration);
+
+    void setup() override;
+    void run() override;
+    void teardown() override;
+
+    void printStatistics() const override;
+    void exportStatistics(framework::BenchmarkResult& result) const override;
+
+  private:
+    void initApplication();
+    void initPrograms();
+    void initVBOs();
+    void initVAOs();
+    void initUBOs();
+
+    void measureCalls();
+
+    // Pairs of objects, so that binds alternate between them and always change the state
+    std::array<base::gl::Program, 2> programs_;
+    std::array<base::gl::VertexArray, 2> vaos_;
+    std::array<base::gl::VertexBuffer, 2> vbos_;
+    std::array<base::gl::Buffer, 2> ubos_;
+};
+}
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include <base/vkx/ShaderModule.h>
+#include <framework/VKTest.h>
+#include <tests/test5/BaseApiCallTest.h>
+
+#include <array>
+
+namespace tests {
+namespace test_vk {
+class ApiCallTest : public BaseApiCallTest, public framework::VKTest
+{
+  public:
+    ApiCallTest(const framework::TestConfiguration& configuration);
+
+    void setup() override;
+    void run() override;
+    void teardown() override;
+
+    void printStatistics() const override;
+    void exportStatistics(framework::BenchmarkResult& result) const override;
+
+  private:
+    void createCommandBuffers();
+    void createVbos();
+    void createUbo();
+    void createRenderPass();
+    void createFramebuffer();
+    void createShaders();
+    void createDescriptorSets();
+    void createPipelineLayout();
+    void createPipelines();
+
+    void destroyPipelines();
+    void destroyPipelineLayout();
+    void destroyDescriptorSets();
+    void destroyShaders();
+    void destroyFramebuffer();
+    void destroyRenderPass();
+    void destroyUbo();
+    void destroyVbos();
+    void destroyCommandBuffers();
+
+    std::vector<vk::PipelineShaderStageCreateInfo> getShaderStages() const;
+    vk::Pipeline createPipeline(vk::CullModeFlags cullMode) const;
+
+    void measureCalls();
+    // Records given commands (inside of the render pass or out of it) into the command buffer
+    template <typename Commands>
+    void recordCommandBuffer(bool insideRenderPass, const Commands& commands) const;
+
+    vk::CommandPool _cmdPool;
+    vk::CommandBuffer _cmdBuffer;
+    // Pairs of objects, so that binds alternate between them and always change the state
+    std::array<base::vkx::Buffer, 2> _vbos;
+    base::vkx::Buffer _ubo;
+    vk::RenderPass _renderPass;
+    vk::Framebuffer _framebuffer;
+    vk::DescriptorSetLayout _setLayout;
+    vk::DescriptorPool _descriptorPool;
+    std::vector<vk::DescriptorSet> _descriptorSets;
+    vk::PipelineLayout _pipelineLayout;
+    std::array<vk::Pipeline, 2> _pipelines;
+    base::vkx::ShaderModule _vertexModule;
+    base::vkx::ShaderModule _fragmentModule;
+};
+}
+}
@@ -14,6 +14,18 @@ ArgumentParser::ArgumentParser(int argc, char* argv[])
         args.push_back(argv[i]);
     }
 
+    parse(args);
+}
+
+ArgumentParser ArgumentParser::withOverrides(const std::vector<std::string>& args) const
+{
+    ArgumentParser result = *this;
+    result.parse(args);
+    return result;
+}
+
+void ArgumentParser::parse(const std::vector<std::string>& args)
+{
     // Parse strings
     for (std::size_t i = 0; i < args.size(); ++i) {
         if (args[i].empty() || args[i][0] != '-')
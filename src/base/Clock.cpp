@@ -1,5 +1,11 @@
 #include <base/Clock.h>
 
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <time.h>
+#endif
+
 #include <fstream>
 #include <string>
 
@@ -21,6 +27,34 @@ Clock::TimePoint Clock::now()
     return _NativeClock::now();
 }
 
+double Clock::seconds()
+{
+    static const auto start = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+double Clock::threadCpuSeconds()
+{
+#ifdef _WIN32
+    FILETIME creationTime, exitTime, kernelTime, userTime;
+    if (!GetThreadTimes(GetCurrentThread(), &creationTime, &exitTime, &kernelTime, &userTime))
+        return 0.0;
+
+    // 100ns units
+    auto toSeconds = [](const FILETIME& time) -> double {
+        return static_cast<double>((static_cast<unsigned long long>(time.dwHighDateTime) << 32) | time.dwLowDateTime) *
+               1.0e-7;
+    };
+    return toSeconds(kernelTime) + toSeconds(userTime);
+#else
+    timespec time;
+    if (clock_gettime(CLOCK_THREAD_CPUTIME_ID, &time) != 0)
+        return 0.0;
+
+    return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_nsec) * 1.0e-9;
+#endif
+}
+
 Clock::Duration Clock::getElapsedTime()
 {
     TimePoint tpNow = now();
@@ -0,0 +1,150 @@
+#include <base/Histogram.h>
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <stdexcept>
+
+namespace base {
+Histogram::Histogram(double lowestValue, double highestValue, std::size_t subBucketCount)
+    : _lowestValue(lowestValue)
+    , _highestValue(highestValue)
+    , _subBucketCount(subBucketCount)
+    , _buckets()
+    , _count(0u)
+    , _min(std::numeric_limits<double>::max())
+    , _max(0.0)
+    , _mean(0.0)
+    , _m2(0.0)
+{
+    if (lowestValue <= 0.0 || highestValue <= lowestValue || subBucketCount == 0u) {
+        throw std::invalid_argument("Histogram - invalid value range or sub-bucket count");
+    }
+
+    auto octaves = static_cast<std::size_t>(std::ceil(std::log2(highestValue / lowestValue))) + 1u;
+    _buckets.resize(octaves * subBucketCount, 0u);
+}
+
+void Histogram::reset()
+{
+    std::fill(_buckets.begin(), _buckets.end(), 0u);
+    _count = 0u;
+    _min = std::numeric_limits<double>::max();
+    _max = 0.0;
+    _mean = 0.0;
+    _m2 = 0.0;
+}
+
+void Histogram::record(double value)
+{
+    ++_buckets[bucketIndex(value)];
+
+    // Welford's online algorithm, numerically stable for long runs
+    ++_count;
+    double delta = value - _mean;
+    _mean += delta / static_cast<double>(_count);
+    _m2 += delta * (value - _mean);
+
+    _min = std::min(_min, value);
+    _max = std::max(_max, value);
+}
+
+void Histogram::merge(const Histogram& other)
+{
+    if (other._buckets.size() != _buckets.size() || other._lowestValue != _lowestValue ||
+        other._subBucketCount != _subBucketCount) {
+        throw std::invalid_argument("Histogram - merging histograms with different layouts");
+    }
+
+    if (other._count == 0u) {
+        return;
+    }
+
+    for (std::size_t i = 0; i < _buckets.size(); ++i) {
+        _buckets[i] += other._buckets[i];
+    }
+
+    // Chan et al. parallel variance combination
+    auto count = _count + other._count;
+    double delta = other._mean - _mean;
+    _mean += delta * static_cast<double>(other._count) / static_cast<double>(count);
+    _m2 += other._m2 +
+           delta * delta * static_cast<double>(_count) * static_cast<double>(other._count) / static_cast<double>(count);
+    _count = count;
+
+    _min = std::min(_min, other._min);
+    _max = std::max(_max, other._max);
+}
+
+std::size_t Histogram::count() const
+{
+    return _count;
+}
+
+double Histogram::min() const
+{
+    return (_count > 0u) ? _min : 0.0;
+}
+
+double Histogram::max() const
+{
+    return _max;
+}
+
+double Histogram::mean() const
+{
+    return _mean;
+}
+
+double Histogram::stddev() const
+{
+    return (_count > 1u) ? std::sqrt(_m2 / static_cast<double>(_count - 1u)) : 0.0;
+}
+
+double Histogram::percentile(double percent) const
+{
+    if (_count == 0u) {
+        return 0.0;
+    }
+
+    percent = std::min(std::max(percent, 0.0), 100.0);
+    auto rank = static_cast<uint64_t>(std::ceil(percent / 100.0 * static_cast<double>(_count)));
+    rank = std::max<uint64_t>(rank, 1u);
+
+    uint64_t accumulated = 0u;
+    for (std::size_t i = 0; i < _buckets.size(); ++i) {
+        accumulated += _buckets[i];
+        if (accumulated >= rank) {
+            return std::min(std::max(bucketMidpoint(i), _min), _max);
+        }
+    }
+
+    return _max;
+}
+
+std::size_t Histogram::bucketIndex(double value) const
+{
+    value = std::min(std::max(value, _lowestValue), _highestValue);
+
+    // value / lowest = mantissa * 2^exponent, mantissa in [0.5, 1)
+    int exponent = 0;
+    double mantissa = std::frexp(value / _lowestValue, &exponent);
+
+    auto octave = static_cast<std::size_t>(exponent - 1);
+    auto subBucket = static_cast<std::size_t>((mantissa * 2.0 - 1.0) * static_cast<double>(_subBucketCount));
+    subBucket = std::min(subBucket, _subBucketCount - 1u);
+
+    return std::min(octave * _subBucketCount + subBucket, _buckets.size() - 1u);
+}
+
+double Histogram::bucketMidpoint(std::size_t index) const
+{
+    auto octave = index / _subBucketCount;
+    auto subBucket = index % _subBucketCount;
+
+    double octaveStart = std::ldexp(_lowestValue, static_cast<int>(octave));
+    double bucketWidth = octaveStart / static_cast<double>(_subBucketCount);
+
+    return octaveStart + (static_cast<double>(subBucket) + 0.5) * bucketWidth;
+}
+}
@@ -0,0 +1,116 @@
+#include <base/LeastSquares.h>
+
+#include <cmath>
+#include <cstddef>
+#include <limits>
+#include <utility>
+
+namespace {
+const double kSingularPivot = 1.0e-12;
+}
+
+namespace base {
+bool LeastSquares::solve(const Rows& rows, const std::vector<double>& values, std::vector<double>& coefficients)
+{
+    std::size_t size = rows.empty() ? 0u : rows.front().size();
+    if (size == 0u || rows.size() < size)
+        return false;
+
+    // Normal equations, augmented with right-hand side
+    std::vector<std::vector<double>> matrix(size, std::vector<double>(size + 1u, 0.0));
+    for (std::size_t sample = 0; sample < rows.size(); ++sample) {
+        for (std::size_t row = 0; row < size; ++row) {
+            for (std::size_t column = 0; column < size; ++column) {
+                matrix[row][column] += rows[sample][row] * rows[sample][column];
+            }
+            matrix[row][size] += rows[sample][row] * values[sample];
+        }
+    }
+
+    // Gauss-Jordan elimination with partial pivoting
+    for (std::size_t column = 0; column < size; ++column) {
+        std::size_t pivot = column;
+        for (std::size_t row = column + 1u; row < size; ++row) {
+            if (std::fabs(matrix[row][column]) > std::fabs(matrix[pivot][column]))
+                pivot = row;
+        }
+        if (std::fabs(matrix[pivot][column]) < kSingularPivot)
+            return false;
+        std::swap(matrix[pivot], matrix[column]);
+
+        for (std::size_t row = 0; row < size; ++row) {
+            if (row == column)
+                continue;
+            double factor = matrix[row][column] / matrix[column][column];
+            for (std::size_t index = column; index <= size; ++index) {
+                matrix[row][index] -= factor * matrix[column][index];
+            }
+        }
+    }
+
+    coefficients.resize(size);
+    for (std::size_t row = 0; row < size; ++row) {
+        coefficients[row] = matrix[row][size] / matrix[row][row];
+    }
+    return true;
+}
+
+bool LeastSquares::solveNonNegative(const Rows& rows,
+                                    const std::vector<double>& values,
+                                    std::vector<double>& coefficients)
+{
+    std::size_t size = rows.empty() ? 0u : rows.front().size();
+
+    bool found = false;
+    double bestError = std::numeric_limits<double>::max();
+    for (unsigned int subset = 1u; subset < (1u << size); ++subset) {
+        Rows subsetRows(rows.size());
+        for (std::size_t sample = 0; sample < rows.size(); ++sample) {
+            for (std::size_t term = 0; term < size; ++term) {
+                if (subset & (1u << term))
+                    subsetRows[sample].push_back(rows[sample][term]);
+            }
+        }
+
+        std::vector<double> subsetCoefficients;
+        if (!solve(subsetRows, values, subsetCoefficients))
+            continue;
+
+        bool negative = false;
+        for (double coefficient : subsetCoefficients) {
+            negative = negative || (coefficient < 0.0);
+        }
+        if (negative)
+            continue;
+
+        double error = squaredError(subsetRows, values, subsetCoefficients);
+        if (error < bestError) {
+            bestError = error;
+            found = true;
+
+            coefficients.assign(size, 0.0);
+            for (std::size_t term = 0, used = 0; term < size; ++term) {
+                if (subset & (1u << term))
+                    coefficients[term] = subsetCoefficients[used++];
+            }
+        }
+    }
+
+    return found;
+}
+
+double LeastSquares::squaredError(const Rows& rows,
+                                  const std::vector<double>& values,
+                                  const std::vector<double>& coefficients)
+{
+    double error = 0.0;
+    for (std::size_t sample = 0; sample < rows.size(); ++sample) {
+        double residual = -values[sample];
+        for (std::size_t term = 0; term < coefficients.size(); ++term) {
+            residual += coefficients[term] * rows[sample][term];
+        }
+        error += residual * residual;
+    }
+    return error;
+}
+}
@@ -0,0 +1,156 @@
+#include <base/MemoryStats.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <fstream>
+#include <new>
+#include <string>
+
+namespace {
+// Allocation size is stored in front of each block, keeping the alignment `malloc` guarantees
+const std::size_t kHeaderSize = alignof(std::max_align_t);
+
+struct HeapCounters
+{
+    std::atomic<std::size_t> bytes;
+    std::atomic<std::size_t> peakBytes;
+    std::atomic<std::size_t> allocations;
+};
+
+HeapCounters& heapCounters()
+{
+    // Constant-initialized, so it's usable by allocations done during static initialization
+    static HeapCounters counters{{0u}, {0u}, {0u}};
+    return counters;
+}
+
+void* allocate(std::size_t size)
+{
+    void* block = nullptr;
+    while ((block = std::malloc(size + kHeaderSize)) == nullptr) {
+        std::new_handler handler = std::get_new_handler();
+        if (!handler)
+            return nullptr;
+        handler();
+    }
+
+    *static_cast<std::size_t*>(block) = size;
+
+    HeapCounters& counters = heapCounters();
+    counters.allocations.fetch_add(1u, std::memory_order_relaxed);
+    std::size_t bytes = counters.bytes.fetch_add(size, std::memory_order_relaxed) + size;
+    std::size_t peakBytes = counters.peakBytes.load(std::memory_order_relaxed);
+    while (bytes > peakBytes && !counters.peakBytes.compare_exchange_weak(peakBytes, bytes)) {
+    }
+
+    return static_cast<char*>(block) + kHeaderSize;
+}
+
+void deallocate(void* pointer)
+{
+    if (!pointer)
+        return;
+
+    void* block = static_cast<char*>(pointer) - kHeaderSize;
+    heapCounters().bytes.fetch_sub(*static_cast<std::size_t*>(block), std::memory_order_relaxed);
+    std::free(block);
+}
+
+// Value of `field` from /proc/self/status in bytes, 0 if it's not available
+std::size_t readProcessStatus(const std::string& field)
+{
+#ifdef __linux__
+    std::ifstream status("/proc/self/status");
+    std::string line;
+    while (std::getline(status, line)) {
+        if (line.compare(0, field.size(), field) == 0 && line.size() > field.size() && line[field.size()] == ':') {
+            return static_cast<std::size_t>(std::strtoull(line.c_str() + field.size() + 1u, nullptr, 10)) * 1024u;
+        }
+    }
+#else
+    (void)field;
+#endif
+    return 0u;
+}
+}
+
+void* operator new(std::size_t size)
+{
+    void* pointer = allocate(size);
+    if (!pointer)
+        throw std::bad_alloc{};
+    return pointer;
+}
+
+void* operator new[](std::size_t size)
+{
+    return operator new(size);
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return allocate(size);
+}
+
+void operator delete(void* pointer) noexcept
+{
+    deallocate(pointer);
+}
+
+void operator delete[](void* pointer) noexcept
+{
+    deallocate(pointer);
+}
+
+void operator delete(void* pointer, const std::nothrow_t&) noexcept
+{
+    deallocate(pointer);
+}
+
+void operator delete[](void* pointer, const std::nothrow_t&) noexcept
+{
+    deallocate(pointer);
+}
+
+namespace base {
+std::size_t MemoryStats::heapBytes()
+{
+    return heapCounters().bytes.load(std::memory_order_relaxed);
+}
+
+std::size_t MemoryStats::peakHeapBytes()
+{
+    return heapCounters().peakBytes.load(std::memory_order_relaxed);
+}
+
+std::size_t MemoryStats::heapAllocations()
+{
+    return heapCounters().allocations.load(std::memory_order_relaxed);
+}
+
+std::size_t MemoryStats::residentBytes()
+{
+    return readProcessStatus("VmRSS");
+}
+
+std::size_t MemoryStats::peakResidentBytes()
+{
+    return readProcessStatus("VmHWM");
+}
+
+void MemoryStats::resetPeaks()
+{
+    heapCounters().peakBytes.store(heapBytes(), std::memory_order_relaxed);
+
+#ifdef __linux__
+    // Resets VmHWM to current RSS (Linux 4.0+), otherwise it stays the peak of the whole process
+    std::ofstream clearRefs("/proc/self/clear_refs");
+    clearRefs << "5";
+#endif
+}
+}
@@ -0,0 +1,157 @@
+#include <base/PerfCounters.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#endif
+
+namespace {
+struct CounterInfo
+{
+    const char* name;
+    const char* key;
+    unsigned int type;
+    unsigned long long config;
+};
+
+#ifdef __linux__
+const CounterInfo kCounters[] = {
+    {"cycles", "cycles", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {"instructions", "instructions", PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {"LLC misses", "llcMisses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {"branch misses", "branchMisses", PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+    {"context switches", "contextSwitches", PERF_TYPE_SOFTWARE, PERF_COUNT_SW_CONTEXT_SWITCHES},
+};
+
+int openCounter(const CounterInfo& info, bool withChildThreads)
+{
+    perf_event_attr attributes;
+    std::memset(&attributes, 0, sizeof(attributes));
+    attributes.size = sizeof(attributes);
+    attributes.type = info.type;
+    attributes.config = info.config;
+    attributes.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+    attributes.inherit = withChildThreads ? 1 : 0;
+    attributes.exclude_hv = 1;
+    // Context switches happen in the kernel, hardware events are limited to user space, which also
+    // keeps them available with default `perf_event_paranoid`
+    attributes.exclude_kernel = (info.type == PERF_TYPE_HARDWARE) ? 1 : 0;
+
+    // Calling thread on any CPU
+    return static_cast<int>(syscall(__NR_perf_event_open, &attributes, 0, -1, -1, 0));
+}
+#else
+const CounterInfo kCounters[] = {
+    {"cycles", "cycles", 0u, 0u},
+    {"instructions", "instructions", 0u, 0u},
+    {"LLC misses", "llcMisses", 0u, 0u},
+    {"branch misses", "branchMisses", 0u, 0u},
+    {"context switches", "contextSwitches", 0u, 0u},
+};
+#endif
+
+static_assert(sizeof(kCounters) / sizeof(kCounters[0]) == base::PerfCounters::CounterCount,
+              "PerfCounters - counter descriptions don't match counters");
+}
+
+namespace base {
+PerfCounters::PerfCounters()
+    : _error()
+{
+    _fds.fill(-1);
+}
+
+PerfCounters::~PerfCounters()
+{
+    close();
+}
+
+void PerfCounters::open(bool withChildThreads)
+{
+    close();
+
+#ifdef __linux__
+    for (std::size_t index = 0; index < CounterCount; ++index) {
+        _fds[index] = openCounter(kCounters[index], withChildThreads);
+        if (_fds[index] < 0 && _error.empty()) {
+            _error = std::string{"perf_event_open failed: "} + std::strerror(errno);
+        }
+    }
+#else
+    (void)withChildThreads;
+    _error = "not supported on this platform";
+#endif
+}
+
+void PerfCounters::close()
+{
+    for (int& fd : _fds) {
+#ifdef __linux__
+        if (fd >= 0) {
+            ::close(fd);
+        }
+#endif
+        fd = -1;
+    }
+    _error.clear();
+}
+
+bool PerfCounters::available() const
+{
+    for (int fd : _fds) {
+        if (fd >= 0)
+            return true;
+    }
+    return false;
+}
+
+bool PerfCounters::available(Counter counter) const
+{
+    return (_fds[counter] >= 0);
+}
+
+const std::string& PerfCounters::error() const
+{
+    return _error;
+}
+
+PerfCounters::Values PerfCounters::read() const
+{
+    Values result;
+    result.fill(0.0);
+
+#ifdef __linux__
+    for (std::size_t index = 0; index < CounterCount; ++index) {
+        if (_fds[index] < 0)
+            continue;
+
+        // value, time enabled, time running
+        uint64_t data[3] = {};
+        if (::read(_fds[index], data, sizeof(data)) != static_cast<ssize_t>(sizeof(data)))
+            continue;
+
+        // Counter was multiplexed with others for part of the time, value is extrapolated
+        if (data[2] > 0u) {
+            result[index] = static_cast<double>(data[0]) * static_cast<double>(data[1]) / static_cast<double>(data[2]);
+        }
+    }
+#endif
+
+    return result;
+}
+
+const char* PerfCounters::name(Counter counter)
+{
+    return kCounters[counter].name;
+}
+
+const char* PerfCounters::key(Counter counter)
+{
+    return kCounters[counter].key;
+}
+}
@@ -0,0 +1,393 @@
+#include <base/Profiler.h>
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <utility>
+#include <vector>
+
+namespace {
+const std::size_t kThreadBufferCapacity = 16384u; // zones recorded by one thread between two frame boundaries
+const std::size_t kMaxTraceEvents = 1000000u;     // roughly 40MB of trace data
+const std::size_t kGpuThread = 1000000u;          // trace lane of GPU zones, far from thread buffer indices
+
+struct ZoneEvent
+{
+    const char* name;
+    uint64_t begin;
+    uint64_t end;
+};
+
+struct ThreadBuffer
+{
+    ThreadBuffer(std::size_t bufferIndex)
+        : events()
+        , head(0u)
+        , tail(0u)
+        , dropped(0u)
+        , index(bufferIndex)
+    {
+    }
+
+    std::array<ZoneEvent, kThreadBufferCapacity> events;
+    std::atomic<uint64_t> head; // written only by the owning thread
+    std::atomic<uint64_t> tail; // written only by the collector
+    std::atomic<uint64_t> dropped;
+    std::size_t index;
+};
+
+struct TraceEvent
+{
+    const char* name;
+    std::size_t session;
+    std::size_t thread;
+    uint64_t begin;
+    uint64_t end;
+};
+
+struct ZoneTimes
+{
+    uint64_t calls;
+    uint64_t time;
+};
+
+struct ZoneStatistics
+{
+    uint64_t calls;
+    uint64_t totalTime;
+    uint64_t maxFrameTime;
+};
+
+struct ProfilerState
+{
+    // Buffers are never destroyed, threads return them to the free list on exit, so short-lived
+    // worker threads (spawned every frame) reuse the same buffers and show up as the same trace lanes.
+    std::mutex buffersMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> buffers;
+    std::vector<ThreadBuffer*> freeBuffers;
+
+    // Collector side, zones are keyed by name pointer as string literals are used
+    std::mutex collectorMutex;
+    std::map<const char*, ZoneTimes> currentFrame;
+    std::map<const char*, ZoneStatistics> zones;
+    uint64_t frames = 0u;
+    uint64_t lastFrame = 0u;
+    std::size_t lastFrameThread = 0u;
+    const char* lastFrameName = nullptr;
+
+    bool tracing = false;
+    std::vector<TraceEvent> trace;
+    uint64_t droppedTraceEvents = 0u;
+    std::vector<std::string> sessions;
+};
+
+ProfilerState& state()
+{
+    static ProfilerState instance;
+    return instance;
+}
+
+struct ThreadBufferHolder
+{
+    ~ThreadBufferHolder()
+    {
+        if (buffer) {
+            std::lock_guard<std::mutex> lock(state().buffersMutex);
+            state().freeBuffers.push_back(buffer);
+        }
+    }
+
+    ThreadBuffer* buffer = nullptr;
+};
+
+thread_local ThreadBufferHolder tlsBuffer;
+
+ThreadBuffer& threadBuffer()
+{
+    if (!tlsBuffer.buffer) {
+        ProfilerState& profiler = state();
+        std::lock_guard<std::mutex> lock(profiler.buffersMutex);
+
+        if (profiler.freeBuffers.empty()) {
+            profiler.buffers.emplace_back(new ThreadBuffer(profiler.buffers.size()));
+            tlsBuffer.buffer = profiler.buffers.back().get();
+        } else {
+            tlsBuffer.buffer = profiler.freeBuffers.back();
+            profiler.freeBuffers.pop_back();
+        }
+    }
+
+    return *tlsBuffer.buffer;
+}
+
+std::size_t currentSession(const ProfilerState& profiler)
+{
+    return profiler.sessions.empty() ? 0u : (profiler.sessions.size() - 1u);
+}
+
+void addTraceEvent(ProfilerState& profiler, const TraceEvent& event)
+{
+    if (!profiler.tracing)
+        return;
+
+    if (profiler.trace.size() < kMaxTraceEvents) {
+        profiler.trace.push_back(event);
+    } else {
+        ++profiler.droppedTraceEvents;
+    }
+}
+
+// Must be called with collectorMutex locked
+void drainBuffers(ProfilerState& profiler)
+{
+    std::lock_guard<std::mutex> lock(profiler.buffersMutex);
+
+    for (const auto& buffer : profiler.buffers) {
+        uint64_t tail = buffer->tail.load(std::memory_order_relaxed);
+        uint64_t head = buffer->head.load(std::memory_order_acquire);
+
+        for (; tail != head; ++tail) {
+            const ZoneEvent& event = buffer->events[tail % kThreadBufferCapacity];
+
+            ZoneTimes& times = profiler.currentFrame[event.name];
+            times.calls += 1u;
+            times.time += event.end - event.begin;
+
+            addTraceEvent(profiler,
+                          TraceEvent{event.name, currentSession(profiler), buffer->index, event.begin, event.end});
+        }
+
+        buffer->tail.store(tail, std::memory_order_release);
+    }
+}
+
+// Must be called with collectorMutex locked, after buffers are drained
+void finishFrame(ProfilerState& profiler, uint64_t time)
+{
+    if (!profiler.lastFrameName)
+        return;
+
+    for (const auto& zone : profiler.currentFrame) {
+        ZoneStatistics& statistics = profiler.zones[zone.first];
+        statistics.calls += zone.second.calls;
+        statistics.totalTime += zone.second.time;
+        statistics.maxFrameTime = std::max(statistics.maxFrameTime, zone.second.time);
+    }
+    ++profiler.frames;
+
+    addTraceEvent(profiler, TraceEvent{profiler.lastFrameName, currentSession(profiler), profiler.lastFrameThread,
+                                       profiler.lastFrame, time});
+
+    profiler.currentFrame.clear();
+    profiler.lastFrameName = nullptr;
+}
+
+std::string escapeJson(const std::string& text)
+{
+    std::string result;
+    for (char c : text) {
+        if (c == '"' || c == '\\') {
+            result += '\\';
+        }
+        result += (static_cast<unsigned char>(c) < 0x20) ? ' ' : c;
+    }
+    return result;
+}
+
+std::string formatMicroseconds(uint64_t nanoseconds)
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.3f", static_cast<double>(nanoseconds) / 1000.0);
+    return buffer;
+}
+
+std::string formatMilliseconds(double nanoseconds)
+{
+    return std::to_string(nanoseconds / 1000000.0) + "ms";
+}
+}
+
+namespace base {
+uint64_t Profiler::now()
+{
+    static const auto epoch = std::chrono::steady_clock::now();
+    return static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - epoch).count());
+}
+
+void Profiler::leaveZone(const char* name, uint64_t begin)
+{
+    uint64_t end = now();
+    ThreadBuffer& buffer = threadBuffer();
+
+    // Single producer: only this thread writes `head`, collector only moves `tail` forward
+    uint64_t head = buffer.head.load(std::memory_order_relaxed);
+    if (head - buffer.tail.load(std::memory_order_acquire) >= kThreadBufferCapacity) {
+        buffer.dropped.fetch_add(1u, std::memory_order_relaxed);
+        return;
+    }
+
+    buffer.events[head % kThreadBufferCapacity] = ZoneEvent{name, begin, end};
+    buffer.head.store(head + 1u, std::memory_order_release);
+}
+
+void Profiler::frame(const char* name)
+{
+    uint64_t time = now();
+    std::size_t thread = threadBuffer().index;
+
+    ProfilerState& profiler = state();
+    std::lock_guard<std::mutex> lock(profiler.collectorMutex);
+
+    drainBuffers(profiler);
+    finishFrame(profiler, time);
+
+    // Zones recorded before the first frame boundary are not part of any frame
+    profiler.currentFrame.clear();
+    profiler.lastFrame = time;
+    profiler.lastFrameThread = thread;
+    profiler.lastFrameName = name;
+}
+
+void Profiler::gpuZone(const char* name, uint64_t begin, uint64_t end)
+{
+    ProfilerState& profiler = state();
+    std::lock_guard<std::mutex> lock(profiler.collectorMutex);
+
+    addTraceEvent(profiler, TraceEvent{name, currentSession(profiler), kGpuThread, begin, end});
+}
+
+void Profiler::beginSession(const std::string& name)
+{
+    ProfilerState& profiler = state();
+    std::lock_guard<std::mutex> lock(profiler.collectorMutex);
+
+    // Zones left from previous session (if any) still belong to it
+    drainBuffers(profiler);
+
+    profiler.sessions.push_back(name);
+    profiler.currentFrame.clear();
+    profiler.zones.clear();
+    profiler.frames = 0u;
+    profiler.lastFrameName = nullptr;
+}
+
+void Profiler::endSession()
+{
+    ProfilerState& profiler = state();
+    std::lock_guard<std::mutex> lock(profiler.collectorMutex);
+
+    // Tests stop after a complete frame, so the last one is finished here
+    uint64_t time = now();
+    drainBuffers(profiler);
+    finishFrame(profiler, time);
+    profiler.currentFrame.clear();
+}
+
+void Profiler::setTracing(bool enabled)
+{
+    ProfilerState& profiler = state();
+    std::lock_guard<std::mutex> lock(profiler.collectorMutex);
+
+    profiler.tracing = enabled;
+}
+
+void Profiler::printStatistics(std::ostream& stream)
+{
+    ProfilerState& profiler = state();
+    std::lock_guard<std::mutex> lock(profiler.collectorMutex);
+
+    if (profiler.zones.empty() || profiler.frames == 0u)
+        return;
+
+    // Different pointers might point to literals with the same text
+    std::map<std::string, ZoneStatistics> zones;
+    for (const auto& zone : profiler.zones) {
+        ZoneStatistics& statistics = zones[zone.first];
+        statistics.calls += zone.second.calls;
+        statistics.totalTime += zone.second.totalTime;
+        statistics.maxFrameTime = std::max(statistics.maxFrameTime, zone.second.maxFrameTime);
+    }
+
+    auto frames = static_cast<double>(profiler.frames);
+
+    stream << "CPU profiler zones (per frame)" << std::endl;
+    stream << "==============================" << std::endl;
+    stream << "  Frames: " << profiler.frames << std::endl;
+    for (const auto& zone : zones) {
+        stream << "  " << zone.first << ": avg " << formatMilliseconds(zone.second.totalTime / frames) << ", max "
+               << formatMilliseconds(static_cast<double>(zone.second.maxFrameTime)) << ", calls "
+               << (static_cast<double>(zone.second.calls) / frames) << std::endl;
+    }
+
+    uint64_t droppedZones = 0u;
+    {
+        std::lock_guard<std::mutex> buffersLock(profiler.buffersMutex);
+        for (const auto& buffer : profiler.buffers) {
+            droppedZones += buffer->dropped.load(std::memory_order_relaxed);
+        }
+    }
+    if (droppedZones > 0u) {
+        stream << "  Dropped zones (full thread buffers): " << droppedZones << std::endl;
+    }
+    stream << std::endl;
+}
+
+bool Profiler::writeChromeTrace(const std::string& path)
+{
+    ProfilerState& profiler = state();
+    std::lock_guard<std::mutex> lock(profiler.collectorMutex);
+
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    if (!file) {
+        return false;
+    }
+
+    // Trace event format: each session is a process, each thread buffer is a thread
+    file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+    bool first = true;
+    auto separator = [&first]() -> const char* {
+        const char* result = (first ? "\n" : ",\n");
+        first = false;
+        return result;
+    };
+
+    for (std::size_t session = 0; session < profiler.sessions.size(); ++session) {
+        file << separator() << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":" << (session + 1u)
+             << ",\"args\":{\"name\":\"" << escapeJson(profiler.sessions[session]) << "\"}}";
+    }
+
+    std::set<std::pair<std::size_t, std::size_t>> threads;
+    for (const TraceEvent& event : profiler.trace) {
+        threads.insert({event.session, event.thread});
+    }
+    for (const auto& thread : threads) {
+        file << separator() << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":" << (thread.first + 1u)
+             << ",\"tid\":" << thread.second << ",\"args\":{\"name\":\""
+             << ((thread.second == kGpuThread) ? "GPU" : ("Thread " + std::to_string(thread.second))) << "\"}}";
+    }
+
+    for (const TraceEvent& event : profiler.trace) {
+        file << separator() << "{\"name\":\"" << escapeJson(event.name) << "\",\"ph\":\"X\",\"pid\":"
+             << (event.session + 1u) << ",\"tid\":" << event.thread << ",\"ts\":" << formatMicroseconds(event.begin)
+             << ",\"dur\":" << formatMicroseconds(event.end - event.begin) << "}";
+    }
+
+    file << "\n]}" << std::endl;
+
+    if (profiler.droppedTraceEvents > 0u) {
+        std::fprintf(stderr, "Profiler trace is truncated, %llu events were dropped\n",
+                     static_cast<unsigned long long>(profiler.droppedTraceEvents));
+    }
+
+    return file.good();
+}
+}
@@ -1,23 +1,19 @@
 #include <base/ScopedTimer.h>
 
-#include <GLFW/glfw3.h>
-
-#include <cstdio>
-
 namespace base {
 ScopedTimer::ScopedTimer(const char* message)
     : _message(message)
-    , _start(glfwGetTime())
+    , _start(Profiler::now())
 {
 }
 
 ScopedTimer::~ScopedTimer()
 {
-    fprintf(stderr, "-- %s (%.3f ms)\n", _message, (glfwGetTime() - _start) * 1000.0);
+    Profiler::leaveZone(_message, _start);
 }
 
 void ScopedTimer::reset(const char* message)
 {
-    fprintf(stderr, "\n%s\n", message);
+    Profiler::frame(message);
 }
 }
@@ -0,0 +1,48 @@
+#include <base/Clock.h>
+#include <base/StartupPhases.h>
+
+#include <cstring>
+
+namespace {
+std::vector<base::StartupPhases::Phase>& recordedPhases()
+{
+    static std::vector<base::StartupPhases::Phase> phases;
+    return phases;
+}
+}
+
+namespace base {
+StartupPhases::Timer::Timer(const char* name, const char* key)
+    : _name(name)
+    , _key(key)
+    , _start(Clock::seconds())
+{
+}
+
+StartupPhases::Timer::~Timer()
+{
+    record(_name, _key, Clock::seconds() - _start);
+}
+
+void StartupPhases::reset()
+{
+    recordedPhases().clear();
+}
+
+void StartupPhases::record(const char* name, const char* key, double time)
+{
+    std::vector<Phase>& phases = recordedPhases();
+    for (Phase& phase : phases) {
+        if (std::strcmp(phase.key, key) == 0) {
+            phase.time += time;
+            return;
+        }
+    }
+    phases.push_back(Phase{name, key, time});
+}
+
+const std::vector<StartupPhases::Phase>& StartupPhases::phases()
+{
+    return recordedPhases();
+}
+}
@@ -0,0 +1,61 @@
+#include <base/SystemSensors.h>
+
+#include <algorithm>
+#include <fstream>
+#include <string>
+#include <thread>
+
+namespace {
+#ifdef __linux__
+bool readNumber(const std::string& path, double& value)
+{
+    std::ifstream file(path);
+    return static_cast<bool>(file >> value);
+}
+#endif
+}
+
+namespace base {
+bool SystemSensors::cpuFrequency(double& megahertz)
+{
+#ifdef __linux__
+    // Offline CPUs don't have cpufreq directory, so missing ones are skipped
+    unsigned int cpuCount = std::max(std::thread::hardware_concurrency(), 1u);
+    double sum = 0.0;
+    unsigned int count = 0u;
+    for (unsigned int cpu = 0u; cpu < cpuCount; ++cpu) {
+        double kilohertz = 0.0;
+        if (readNumber("/sys/devices/system/cpu/cpu" + std::to_string(cpu) + "/cpufreq/scaling_cur_freq", kilohertz)) {
+            sum += kilohertz;
+            ++count;
+        }
+    }
+
+    if (count > 0u) {
+        megahertz = sum / static_cast<double>(count) / 1000.0;
+        return true;
+    }
+#else
+    (void)megahertz;
+#endif
+    return false;
+}
+
+bool SystemSensors::temperature(double& celsius)
+{
+#ifdef __linux__
+    // Thermal zones are numbered contiguously
+    bool found = false;
+    double millicelsius = 0.0;
+    unsigned int zone = 0u;
+    while (readNumber("/sys/class/thermal/thermal_zone" + std::to_string(zone++) + "/temp", millicelsius)) {
+        celsius = found ? std::max(celsius, millicelsius / 1000.0) : millicelsius / 1000.0;
+        found = true;
+    }
+    return found;
+#else
+    (void)celsius;
+    return false;
+#endif
+}
+}
@@ -0,0 +1,36 @@
+#include <base/TaskGraph.h>
+
+#include <stdexcept>
+
+namespace base {
+TaskGraph::TaskGraph()
+    : _jobs()
+{
+}
+
+TaskGraph::Node TaskGraph::add(const ThreadPool::RangeTask& task)
+{
+    _jobs.emplace_back(new ThreadPool::Job());
+    _jobs.back()->task = task;
+    return _jobs.size() - 1u;
+}
+
+void TaskGraph::setRanges(Node node, const std::vector<std::size_t>& boundaries)
+{
+    _jobs.at(node)->boundaries = boundaries;
+}
+
+void TaskGraph::precede(Node before, Node after)
+{
+    if (before >= after || after >= _jobs.size())
+        throw std::invalid_argument("Task graph node can only precede nodes added after it!");
+
+    _jobs[before]->successors.push_back(_jobs[after].get());
+    ++_jobs[after]->predecessors;
+}
+
+std::size_t TaskGraph::size() const
+{
+    return _jobs.size();
+}
+}
@@ -0,0 +1,366 @@
+#include <base/TaskGraph.h>
+#include <base/ThreadPool.h>
+
+#include <algorithm>
+#include <numeric>
+
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+#include <immintrin.h>
+#endif
+
+namespace {
+// Ranges are small enough for idle workers to steal some, and big enough to amortize taking them
+const std::size_t kRangesPerWorker = 8u;
+
+// Roughly tens of microseconds of spinning before a waiting thread parks
+const std::size_t kSpinIterations = 4096u;
+
+inline void cpuRelax()
+{
+#if defined(__i386__) || defined(__x86_64__) || defined(_M_IX86) || defined(_M_X64)
+    _mm_pause();
+#else
+    std::this_thread::yield();
+#endif
+}
+
+// Spinning only delays the thread it waits for when there is no other core to run it
+std::size_t spinIterations()
+{
+    static const std::size_t iterations = (std::thread::hardware_concurrency() > 1u) ? kSpinIterations : 0u;
+    return iterations;
+}
+
+template <typename Predicate>
+bool spinUntil(Predicate predicate)
+{
+    for (std::size_t iteration = 0, count = spinIterations(); iteration < count; ++iteration) {
+        if (predicate())
+            return true;
+        cpuRelax();
+    }
+    return predicate();
+}
+}
+
+namespace base {
+ThreadPool::Job::Job()
+    : task()
+    , boundaries()
+    , remainingRanges(0u)
+    , successors()
+    , predecessors(0u)
+    , remainingPredecessors(0u)
+{
+}
+
+ThreadPool::ThreadPool(std::size_t threads)
+    : _workers()
+    , _queues()
+    , _job()
+    , _indexTask()
+    , _pendingJobs(0u)
+    , _steals(0u)
+    , _epoch(0u)
+    , _stopping(false)
+    , _mutex()
+    , _workAvailable()
+    , _workFinished()
+{
+    for (std::size_t index = 0; index < std::max<std::size_t>(threads, 1u); ++index) {
+        _queues.emplace_back(new Queue());
+    }
+
+    _workers.reserve(threads);
+    for (std::size_t worker = 0; worker < threads; ++worker) {
+        _workers.emplace_back(&ThreadPool::workerLoop, this, worker);
+    }
+}
+
+ThreadPool::~ThreadPool()
+{
+    wait();
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _stopping.store(true);
+    }
+    _workAvailable.notify_all();
+
+    for (std::thread& worker : _workers) {
+        worker.join();
+    }
+}
+
+std::size_t ThreadPool::threads() const
+{
+    return _workers.size();
+}
+
+void ThreadPool::dispatch(std::size_t count, const Task& task)
+{
+    // Previous work may still run, it would see the new one half-written otherwise
+    wait();
+
+    // Each index is a range of its own
+    _indexTask = task;
+    _job.task = [this](std::size_t begin, std::size_t end, std::size_t) {
+        for (std::size_t index = begin; index < end; ++index) {
+            _indexTask(index);
+        }
+    };
+    _job.boundaries.resize(count + 1u);
+    std::iota(_job.boundaries.begin(), _job.boundaries.end(), std::size_t{0u});
+
+    _pendingJobs.fetch_add(1u);
+    submit(_job);
+    if (_workers.empty()) {
+        while (runRange(0u)) {
+        }
+    }
+}
+
+void ThreadPool::dispatch(const std::vector<std::size_t>& boundaries, const RangeTask& task)
+{
+    wait();
+
+    _job.task = task;
+    _job.boundaries = boundaries;
+
+    _pendingJobs.fetch_add(1u);
+    submit(_job);
+    if (_workers.empty()) {
+        while (runRange(0u)) {
+        }
+    }
+}
+
+void ThreadPool::dispatch(TaskGraph& graph)
+{
+    wait();
+
+    // All counters are set before any job starts, finished jobs start their successors
+    _pendingJobs.fetch_add(graph._jobs.size());
+    for (auto& job : graph._jobs) {
+        job->remainingPredecessors.store(job->predecessors);
+    }
+    for (auto& job : graph._jobs) {
+        if (job->predecessors == 0u) {
+            submit(*job);
+        }
+    }
+
+    if (_workers.empty()) {
+        while (runRange(0u)) {
+        }
+    }
+}
+
+void ThreadPool::wait()
+{
+    auto finished = [this]() { return _pendingJobs.load(std::memory_order_acquire) == 0u; };
+    if (spinUntil(finished))
+        return;
+
+    std::unique_lock<std::mutex> lock(_mutex);
+    _workFinished.wait(lock, finished);
+}
+
+void ThreadPool::parallelFor(std::size_t count, const Task& task)
+{
+    dispatch(count, task);
+    wait();
+}
+
+void ThreadPool::parallelFor(const std::vector<std::size_t>& boundaries, const RangeTask& task)
+{
+    dispatch(boundaries, task);
+    wait();
+}
+
+std::size_t ThreadPool::steals() const
+{
+    return _steals.load(std::memory_order_relaxed);
+}
+
+std::size_t ThreadPool::workerRanges() const
+{
+    // Pool without workers runs the work on the dispatching thread
+    return std::max<std::size_t>(threads(), 1u) * kRangesPerWorker;
+}
+
+std::vector<std::size_t> ThreadPool::splitForWorkers(std::size_t count) const
+{
+    return splitEvenly(count, workerRanges());
+}
+
+std::vector<std::size_t> ThreadPool::splitEvenly(std::size_t count, std::size_t ranges)
+{
+    ranges = std::max<std::size_t>(std::min(ranges, count), 1u);
+
+    std::vector<std::size_t> boundaries{0u};
+    for (std::size_t range = 1; range <= ranges; ++range) {
+        boundaries.push_back(count * range / ranges);
+    }
+    return boundaries;
+}
+
+std::vector<std::size_t> ThreadPool::splitByCost(const std::vector<double>& costs, std::size_t ranges)
+{
+    double total = std::accumulate(costs.begin(), costs.end(), 0.0);
+    if (total <= 0.0 || ranges == 0u)
+        return splitEvenly(costs.size(), ranges);
+
+    double share = total / static_cast<double>(ranges);
+    std::vector<std::size_t> boundaries{0u};
+    double rangeCost = 0.0;
+    for (std::size_t index = 0; index < costs.size(); ++index) {
+        bool costly = costs[index] >= share;
+
+        // Range is closed before an item, which would overflow its share by more than a half of itself
+        if (index > boundaries.back() && (costly || rangeCost + 0.5 * costs[index] > share)) {
+            boundaries.push_back(index);
+            rangeCost = 0.0;
+        }
+        rangeCost += costs[index];
+
+        if (costly && index + 1u < costs.size()) {
+            boundaries.push_back(index + 1u);
+            rangeCost = 0.0;
+        }
+    }
+    if (boundaries.back() != costs.size()) {
+        boundaries.push_back(costs.size());
+    }
+    return boundaries;
+}
+
+void ThreadPool::submit(Job& job)
+{
+    std::size_t ranges = job.boundaries.empty() ? 0u : job.boundaries.size() - 1u;
+    job.remainingRanges.store(ranges);
+    if (ranges == 0u) {
+        finishJob(job);
+        return;
+    }
+
+    // Contiguous blocks keep neighbouring items on one worker, unless they get stolen
+    for (std::size_t queue = 0; queue < _queues.size(); ++queue) {
+        std::size_t first = ranges * queue / _queues.size();
+        std::size_t last = ranges * (queue + 1u) / _queues.size();
+        if (first == last)
+            continue;
+
+        std::lock_guard<std::mutex> lock(_queues[queue]->mutex);
+        _queues[queue]->blocks.push_back(Block{&job, first, last});
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _epoch.fetch_add(1u);
+    }
+    _workAvailable.notify_all();
+}
+
+void ThreadPool::finishRange(Job& job)
+{
+    if (job.remainingRanges.fetch_sub(1u, std::memory_order_acq_rel) == 1u) {
+        finishJob(job);
+    }
+}
+
+void ThreadPool::finishJob(Job& job)
+{
+    // Successors are queued first, so waiting thread can't see the work finished in between
+    for (Job* successor : job.successors) {
+        if (successor->remainingPredecessors.fetch_sub(1u, std::memory_order_acq_rel) == 1u) {
+            submit(*successor);
+        }
+    }
+
+    if (_pendingJobs.fetch_sub(1u, std::memory_order_acq_rel) == 1u) {
+        std::lock_guard<std::mutex> lock(_mutex);
+        _workFinished.notify_all();
+    }
+}
+
+bool ThreadPool::takeRange(std::size_t worker, Block& range)
+{
+    {
+        Queue& queue = *_queues[worker];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.blocks.empty()) {
+            Block& block = queue.blocks.front();
+            range = Block{block.job, block.first, block.first + 1u};
+            if (++block.first == block.last) {
+                queue.blocks.pop_front();
+            }
+            return true;
+        }
+    }
+
+    // Victims are tried starting from the next worker, so thieves don't all go after the same one
+    for (std::size_t offset = 1; offset < _queues.size(); ++offset) {
+        Block stolen{nullptr, 0u, 0u};
+        {
+            Queue& victim = *_queues[(worker + offset) % _queues.size()];
+            std::lock_guard<std::mutex> lock(victim.mutex);
+            if (victim.blocks.empty())
+                continue;
+
+            // Back half of the victim's last block, which it would get to last
+            Block& block = victim.blocks.back();
+            std::size_t count = (block.last - block.first + 1u) / 2u;
+            stolen = Block{block.job, block.last - count, block.last};
+            block.last -= count;
+            if (block.first == block.last) {
+                victim.blocks.pop_back();
+            }
+        }
+        _steals.fetch_add(1u, std::memory_order_relaxed);
+
+        range = Block{stolen.job, stolen.first, stolen.first + 1u};
+        if (stolen.first + 1u < stolen.last) {
+            Queue& queue = *_queues[worker];
+            std::lock_guard<std::mutex> lock(queue.mutex);
+            queue.blocks.push_back(Block{stolen.job, stolen.first + 1u, stolen.last});
+        }
+        return true;
+    }
+
+    return false;
+}
+
+bool ThreadPool::runRange(std::size_t worker)
+{
+    Block range{nullptr, 0u, 0u};
+    if (!takeRange(worker, range))
+        return false;
+
+    Job& job = *range.job;
+    job.task(job.boundaries[range.first], job.boundaries[range.first + 1u], worker);
+    finishRange(job);
+    return true;
+}
+
+void ThreadPool::workerLoop(std::size_t worker)
+{
+    while (true) {
+        uint64_t epoch = _epoch.load(std::memory_order_acquire);
+        if (runRange(worker))
+            continue;
+
+        // Work queued after the epoch was read changes it, so it can't be missed
+        auto woken = [this, epoch]() {
+            return _epoch.load(std::memory_order_acquire) != epoch || _stopping.load();
+        };
+        if (!spinUntil(woken)) {
+            std::unique_lock<std::mutex> lock(_mutex);
+            _workAvailable.wait(lock, woken);
+        }
+
+        if (_stopping.load())
+            return;
+    }
+}
+}
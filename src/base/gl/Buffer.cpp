@@ -1,5 +1,13 @@
 #include <base/gl/Buffer.h>
 
+#include <algorithm>
+
+namespace {
+// Buffers are used only from the thread owning GL context
+std::size_t allocatedBufferBytes = 0u;
+std::size_t peakAllocatedBufferBytes = 0u;
+}
+
 namespace base {
 namespace gl {
 Buffer::Buffer()
@@ -11,6 +19,7 @@ Buffer::Buffer(Target target, Usage usage)
 {
     _isCreated = false;
     _bufferID = 0;
+    _size = 0;
 
     setTarget(target);
     setUsage(usage);
@@ -19,7 +28,9 @@ Buffer::Buffer(Target target, Usage usage)
 Buffer::Buffer(Buffer&& buffer)
 {
     _isCreated = false;
+    _size = 0;
 
+    std::swap(_size, buffer._size);
     std::swap(_usage, buffer._usage);
     std::swap(_target, buffer._target);
     std::swap(_bufferID, buffer._bufferID);
@@ -33,6 +44,7 @@ Buffer::~Buffer()
 
 Buffer& Buffer::operator=(Buffer&& buffer)
 {
+    std::swap(_size, buffer._size);
     std::swap(_usage, buffer._usage);
     std::swap(_target, buffer._target);
     std::swap(_bufferID, buffer._bufferID);
@@ -53,6 +65,7 @@ void Buffer::destroy()
 {
     if (isCreated()) {
         glDeleteBuffers(1, &_bufferID);
+        trackSize(0);
 
         _isCreated = false;
     }
@@ -77,6 +90,7 @@ void Buffer::unbind() const
 void Buffer::resize(GLsizeiptr size)
 {
     glBufferData(static_cast<GLenum>(getTarget()), size, nullptr, static_cast<GLenum>(getUsage()));
+    trackSize(size);
 }
 
 void Buffer::setData(const Buffer::Data& data)
@@ -87,12 +101,14 @@ void Buffer::setData(const Buffer::Data& data)
 void Buffer::setData(GLsizeiptr size, const GLvoid* data)
 {
     glBufferData(static_cast<GLenum>(getTarget()), size, data, static_cast<GLenum>(getUsage()));
+    trackSize(size);
 }
 
 void Buffer::setData(GLsizeiptr size, const GLvoid* data, Usage usage)
 {
     setUsage(usage);
     glBufferData(static_cast<GLenum>(getTarget()), size, data, static_cast<GLenum>(getUsage()));
+    trackSize(size);
 }
 
 void Buffer::setSubData(GLintptr offset, GLsizeiptr size, const GLvoid* data)
@@ -128,9 +144,31 @@ Buffer::Target Buffer::getTarget() const
     return _target;
 }
 
+std::size_t Buffer::allocatedBytes()
+{
+    return allocatedBufferBytes;
+}
+
+std::size_t Buffer::peakAllocatedBytes()
+{
+    return peakAllocatedBufferBytes;
+}
+
+void Buffer::resetPeakAllocatedBytes()
+{
+    peakAllocatedBufferBytes = allocatedBufferBytes;
+}
+
 bool Buffer::isCreated() const
 {
     return _isCreated;
 }
+
+void Buffer::trackSize(GLsizeiptr size)
+{
+    allocatedBufferBytes = allocatedBufferBytes - static_cast<std::size_t>(_size) + static_cast<std::size_t>(size);
+    peakAllocatedBufferBytes = std::max(peakAllocatedBufferBytes, allocatedBufferBytes);
+    _size = size;
+}
 }
 }
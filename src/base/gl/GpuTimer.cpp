@@ -0,0 +1,128 @@
+#include <base/Profiler.h>
+#include <base/gl/GpuTimer.h>
+
+#include <cassert>
+
+namespace {
+const std::size_t kCalibrationInterval = 256u; // frames
+}
+
+namespace base {
+namespace gl {
+GpuTimer::GpuTimer(std::size_t passCount, std::size_t frameLatency)
+    : _passCount(passCount)
+    , _frameLatency(frameLatency)
+    , _queries()
+    , _written()
+    , _frame(0u)
+    , _framesSinceCalibration(0u)
+    , _offset(0)
+{
+    assert(frameLatency > 0u);
+}
+
+GpuTimer::~GpuTimer()
+{
+    destroy();
+}
+
+void GpuTimer::create()
+{
+    destroy();
+
+    // Implementations may report no timestamp support, timer is then silently disabled
+    GLint counterBits = 0;
+    glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &counterBits);
+    if (counterBits == 0)
+        return;
+
+    _queries.resize(_frameLatency * _passCount * 2u);
+    glGenQueries(static_cast<GLsizei>(_queries.size()), _queries.data());
+    _written.assign(_frameLatency * _passCount, false);
+    _frame = 0u;
+
+    calibrate();
+}
+
+void GpuTimer::destroy()
+{
+    if (!_queries.empty()) {
+        glDeleteQueries(static_cast<GLsizei>(_queries.size()), _queries.data());
+        _queries.clear();
+        _written.clear();
+    }
+}
+
+void GpuTimer::beginFrame(const Callback& callback)
+{
+    if (_queries.empty())
+        return;
+
+    if (++_framesSinceCalibration >= kCalibrationInterval) {
+        calibrate();
+    }
+
+    // Queries of this slot were written `frameLatency` frames ago
+    _frame = (_frame + 1u) % _frameLatency;
+
+    for (std::size_t pass = 0; pass < _passCount; ++pass) {
+        if (!_written[_frame * _passCount + pass])
+            continue;
+        _written[_frame * _passCount + pass] = false;
+
+        GLuint beginQuery = _queries[queryIndex(_frame, pass)];
+        GLuint endQuery = _queries[queryIndex(_frame, pass) + 1u];
+
+        GLint beginAvailable = GL_FALSE;
+        GLint endAvailable = GL_FALSE;
+        glGetQueryObjectiv(beginQuery, GL_QUERY_RESULT_AVAILABLE, &beginAvailable);
+        glGetQueryObjectiv(endQuery, GL_QUERY_RESULT_AVAILABLE, &endAvailable);
+        if (beginAvailable == GL_FALSE || endAvailable == GL_FALSE) {
+            continue; // Waiting for results would stall the CPU, sample is dropped
+        }
+
+        GLuint64 begin = 0;
+        GLuint64 end = 0;
+        glGetQueryObjectui64v(beginQuery, GL_QUERY_RESULT, &begin);
+        glGetQueryObjectui64v(endQuery, GL_QUERY_RESULT, &end);
+
+        callback(pass, static_cast<uint64_t>(static_cast<int64_t>(begin) + _offset),
+                 static_cast<uint64_t>(static_cast<int64_t>(end) + _offset));
+    }
+}
+
+void GpuTimer::begin(std::size_t pass)
+{
+    if (_queries.empty())
+        return;
+
+    glQueryCounter(_queries[queryIndex(_frame, pass)], GL_TIMESTAMP);
+}
+
+void GpuTimer::end(std::size_t pass)
+{
+    if (_queries.empty())
+        return;
+
+    glQueryCounter(_queries[queryIndex(_frame, pass) + 1u], GL_TIMESTAMP);
+    _written[_frame * _passCount + pass] = true;
+}
+
+std::size_t GpuTimer::queryIndex(std::size_t frame, std::size_t pass) const
+{
+    return (frame * _passCount + pass) * 2u;
+}
+
+void GpuTimer::calibrate()
+{
+    // GPU time is sampled between two CPU timestamps, their midpoint is the best estimate of the same moment
+    uint64_t before = base::Profiler::now();
+    GLint64 gpuTime = 0;
+    glGetInteger64v(GL_TIMESTAMP, &gpuTime);
+    uint64_t after = base::Profiler::now();
+
+    _offset = static_cast<int64_t>(before + (after - before) / 2u) - static_cast<int64_t>(gpuTime);
+    _framesSinceCalibration = 0u;
+}
+}
+}
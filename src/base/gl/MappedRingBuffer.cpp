@@ -0,0 +1,115 @@
+#include <base/gl/MappedRingBuffer.h>
+
+#include <cassert>
+#include <stdexcept>
+
+namespace {
+const GLbitfield kMappingFlags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+const GLuint64 kFenceWaitTimeout = 1000000000u; // 1 second
+}
+
+namespace base {
+namespace gl {
+MappedRingBuffer::MappedRingBuffer(Target target, std::size_t regions)
+    : Buffer(target, Usage::StreamDraw)
+    , _regions(regions)
+    , _region(0u)
+    , _regionSize(0)
+    , _data(nullptr)
+    , _fences()
+{
+    assert(regions > 0u);
+}
+
+MappedRingBuffer::~MappedRingBuffer()
+{
+    destroy();
+}
+
+bool MappedRingBuffer::isSupported()
+{
+    return GLEW_VERSION_4_4 || GLEW_ARB_buffer_storage;
+}
+
+void MappedRingBuffer::allocate(GLsizeiptr regionSize)
+{
+    destroy();
+    create();
+
+    // Coherent mapping makes writes visible to GPU without explicit flushes
+    GLsizeiptr size = regionSize * static_cast<GLsizeiptr>(_regions);
+    bind();
+    glBufferStorage(static_cast<GLenum>(getTarget()), size, nullptr, kMappingFlags);
+    _data = glMapBufferRange(static_cast<GLenum>(getTarget()), 0, size, kMappingFlags);
+    unbind();
+
+    if (_data == nullptr)
+        throw std::runtime_error("base::gl::MappedRingBuffer > Couldn't map buffer persistently.");
+
+    trackSize(size);
+    _regionSize = regionSize;
+    _fences.assign(_regions, nullptr);
+    _region = _regions - 1u; // first region is the next one
+}
+
+void MappedRingBuffer::destroy()
+{
+    for (GLsync fence : _fences) {
+        if (fence != nullptr)
+            glDeleteSync(fence);
+    }
+    _fences.clear();
+
+    // Deleting the buffer unmaps it, draws already issued from it still finish
+    _data = nullptr;
+    _regionSize = 0;
+    Buffer::destroy();
+}
+
+void MappedRingBuffer::beginRegion()
+{
+    _region = (_region + 1u) % _regions;
+
+    GLsync& fence = _fences[_region];
+    if (fence != nullptr) {
+        GLenum result = GL_TIMEOUT_EXPIRED;
+        while (result == GL_TIMEOUT_EXPIRED) {
+            // keep waiting, GPU still reads this region
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, kFenceWaitTimeout);
+        }
+
+        // Writing the region without the fence signaled would race with the GPU reading it
+        if (result == GL_WAIT_FAILED)
+            throw std::runtime_error("base::gl::MappedRingBuffer > Waiting for region fence failed.");
+
+        glDeleteSync(fence);
+        fence = nullptr;
+    }
+}
+
+void MappedRingBuffer::endRegion()
+{
+    _fences[_region] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+}
+
+std::size_t MappedRingBuffer::regionIndex() const
+{
+    return _region;
+}
+
+GLsizeiptr MappedRingBuffer::regionSize() const
+{
+    return _regionSize;
+}
+
+GLintptr MappedRingBuffer::regionOffset() const
+{
+    return _regionSize * static_cast<GLintptr>(_region);
+}
+
+GLvoid* MappedRingBuffer::regionData() const
+{
+    return static_cast<char*>(_data) + regionOffset();
+}
+}
+}
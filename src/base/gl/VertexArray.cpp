@@ -135,6 +135,11 @@ void VertexArray::setAttribPointers(const std::vector<VertexAttrib>& attributes)
     }
 }
 
+void VertexArray::setAttribDivisor(GLuint index, GLuint divisor)
+{
+    glVertexAttribDivisor(index, divisor);
+}
+
 void VertexArray::setDrawOffset(GLint offset)
 {
     _drawOffset = offset;
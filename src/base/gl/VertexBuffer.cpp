@@ -24,6 +24,7 @@ VertexBuffer::~VertexBuffer()
 
 VertexBuffer& VertexBuffer::operator=(VertexBuffer&& vbo)
 {
+    std::swap(_size, vbo._size);
     std::swap(_usage, vbo._usage);
     std::swap(_target, vbo._target);
     std::swap(_bufferID, vbo._bufferID);
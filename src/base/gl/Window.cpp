@@ -1,19 +1,35 @@
 #include <base/gl/Window.h>
 
+#include <base/StartupPhases.h>
+
 #include <GL/glew.h>
 #include <GLFW/glfw3.h>
 
 #include <iostream>
+#include <stdexcept>
+
+namespace {
+// Offscreen frames are not throttled by buffer swaps, so limit the number of frames queued on the GPU instead
+const std::size_t kMaxOffscreenFramesInFlight = 3u;
+const GLuint64 kFenceWaitTimeout = 1000000000u; // 1 second
+}
 
 namespace base {
 namespace gl {
 bool Window::_hintsSet = false;
+bool Window::_glfwInitialized = false;
+bool Window::_glewInitialized = false;
 
 Window::Window(const glm::uvec2& size, const std::string& title)
 {
     _handle = nullptr;
     _hintsSet = false;
     _framesCount = 0;
+    _frameTime = 0.0;
+    _isOffscreen = false;
+    _framebuffer = 0;
+    _colorRenderbuffer = 0;
+    _depthRenderbuffer = 0;
 
     setSize(size);
     setTitle(title);
@@ -38,12 +54,22 @@ bool Window::create()
     if (_hintsSet == false)
         setDefaultHints();
 
-    _handle = glfwCreateWindow(getWidth(), getHeight(), _title.c_str(), nullptr, nullptr);
+    // Offscreen mode still needs a (hidden) window for the context, GLFW doesn't support headless contexts
+    glfwWindowHint(GLFW_VISIBLE, isOffscreen() ? GL_FALSE : GL_TRUE);
+
+    {
+        StartupPhases::Timer phase{"Window and context creation", "context"};
+        _handle = glfwCreateWindow(getWidth(), getHeight(), _title.c_str(), nullptr, nullptr);
+        if (isCreated())
+            glfwMakeContextCurrent(getHandle());
+    }
 
     if (isCreated()) {
-        glfwMakeContextCurrent(getHandle());
         initializeGLEW();
 
+        if (isOffscreen())
+            createFramebuffer();
+
         _lastFpsMeasure = _thisFpsMeasure = glfwGetTime();
 
     } else {
@@ -62,7 +88,11 @@ void Window::update()
         return;
     }
 
-    glfwSwapBuffers(_handle);
+    if (isOffscreen()) {
+        throttleOffscreenFrames();
+    } else {
+        glfwSwapBuffers(_handle);
+    }
     glfwPollEvents();
 
     if (isCountingFPS()) {
@@ -90,6 +120,7 @@ void Window::update()
 void Window::destroy()
 {
     if (isCreated()) {
+        destroyFramebuffer();
         glfwDestroyWindow(_handle);
         _handle = nullptr;
     }
@@ -127,6 +158,14 @@ void Window::appendTitle(const std::string& text)
         glfwSetWindowTitle(_handle, appendedTitle.c_str());
 }
 
+void Window::setOffscreen(bool flag)
+{
+    if (isCreated())
+        throw std::logic_error("base::gl::Window > Offscreen mode has to be set before window creation.");
+
+    _isOffscreen = flag;
+}
+
 void Window::setDisplayingFPS(bool flag)
 {
     _isDisplayingFPS = flag;
@@ -207,6 +246,11 @@ bool Window::isCreated() const
     return (_handle != nullptr);
 }
 
+bool Window::isOffscreen() const
+{
+    return _isOffscreen;
+}
+
 bool Window::shouldClose() const
 {
     return glfwWindowShouldClose(_handle) == GL_TRUE;
@@ -222,16 +266,25 @@ GLFWwindow* Window::getHandle()
     return _handle;
 }
 
+unsigned int Window::getFramebuffer() const
+{
+    return _framebuffer;
+}
+
 void Window::deinitialize()
 {
     glfwTerminate();
+
+    // Allow re-initialization when more than one test is run in a single process
+    _glfwInitialized = false;
+    _glewInitialized = false;
 }
 
 void Window::initializeGLFW()
 {
-    static bool initialized = false;
+    if (_glfwInitialized == false) {
+        StartupPhases::Timer phase{"GLFW initialization", "glfw"};
 
-    if (initialized == false) {
         // Setting error callback
         static auto errorCallbackFunc = [](int error, const char* description) {
             std::cerr << "[GLFW] Error #" + std::to_string(error) + std::string(": ") + description << std::endl;
@@ -245,15 +298,14 @@ void Window::initializeGLFW()
             throw std::runtime_error("Failed to initialize GLFW library.");
         }
 
-        initialized = true;
+        _glfwInitialized = true;
     }
 }
 
 void Window::initializeGLEW()
 {
-    static bool initialized = false;
-
-    if (initialized == false) {
+    if (_glewInitialized == false) {
+        StartupPhases::Timer phase{"GLEW initialization", "glew"};
         glewExperimental = GL_TRUE;
 
         if (glewInit() != GLEW_OK) {
@@ -261,7 +313,7 @@ void Window::initializeGLEW()
             throw std::runtime_error("Failed to initialize GLEW library.");
         }
 
-        initialized = true;
+        _glewInitialized = true;
     }
 }
 
@@ -292,6 +344,9 @@ void Window::setHints(const std::vector<std::pair<int, int>>& hints)
 
 void Window::setDefaultHints()
 {
+    // Reset hints left by other windows (e.g. Vulkan ones without client API) created in this process
+    glfwDefaultWindowHints();
+
     setHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);
     setHint(GLFW_CONTEXT_VERSION_MAJOR, 3);
     setHint(GLFW_CONTEXT_VERSION_MINOR, 3);
@@ -304,5 +359,66 @@ void Window::setFPSCount(int fpsCount)
 {
     _fpsCount = fpsCount;
 }
+
+void Window::createFramebuffer()
+{
+    glGenRenderbuffers(1, &_colorRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, _colorRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_RGBA8, getWidth(), getHeight());
+
+    glGenRenderbuffers(1, &_depthRenderbuffer);
+    glBindRenderbuffer(GL_RENDERBUFFER, _depthRenderbuffer);
+    glRenderbufferStorage(GL_RENDERBUFFER, GL_DEPTH_COMPONENT24, getWidth(), getHeight());
+    glBindRenderbuffer(GL_RENDERBUFFER, 0);
+
+    glGenFramebuffers(1, &_framebuffer);
+    glBindFramebuffer(GL_FRAMEBUFFER, _framebuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_RENDERBUFFER, _colorRenderbuffer);
+    glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, _depthRenderbuffer);
+
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        throw std::runtime_error("base::gl::Window > Offscreen framebuffer is not complete.");
+    }
+
+    // Framebuffer stays bound, so tests render offscreen without any changes
+    glViewport(0, 0, getWidth(), getHeight());
+}
+
+void Window::destroyFramebuffer()
+{
+    for (GLsync fence : _frameFences)
+        glDeleteSync(fence);
+    _frameFences.clear();
+
+    if (_framebuffer != 0) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+        glDeleteFramebuffers(1, &_framebuffer);
+        glDeleteRenderbuffers(1, &_depthRenderbuffer);
+        glDeleteRenderbuffers(1, &_colorRenderbuffer);
+
+        _framebuffer = _colorRenderbuffer = _depthRenderbuffer = 0;
+    }
+}
+
+void Window::throttleOffscreenFrames()
+{
+    _frameFences.push_back(glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0));
+
+    while (_frameFences.size() > kMaxOffscreenFramesInFlight) {
+        GLsync fence = _frameFences.front();
+        GLenum result = GL_TIMEOUT_EXPIRED;
+        while (result == GL_TIMEOUT_EXPIRED) {
+            // keep waiting, GPU is still busy with older frames
+            result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, kFenceWaitTimeout);
+        }
+
+        // Frames wouldn't be capped any more, so the run would measure something else than asked for
+        if (result == GL_WAIT_FAILED)
+            throw std::runtime_error("base::gl::Window > Waiting for offscreen frame fence failed.");
+
+        glDeleteSync(fence);
+        _frameFences.pop_front();
+    }
+}
 }
 }
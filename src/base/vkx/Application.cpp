@@ -1,6 +1,7 @@
 #include <base/vkx/Application.h>
 
 #include <base/ContainerUtils.h>
+#include <base/StartupPhases.h>
 
 #include <GLFW/glfw3.h>
 
@@ -16,14 +17,15 @@ const std::vector<const char*> kDebugInstanceLayers{{"VK_LAYER_LUNARG_standard_v
 
 namespace base {
 namespace vkx {
-Application::Application(const std::string& name, const glm::vec2& windowSize, bool debugMode)
+Application::Application(const std::string& name, const glm::vec2& windowSize, bool debugMode, bool offscreen)
     : _name(name)
+    , _offscreen(offscreen)
     , _instance(createInstance((debugMode ? kDebugInstanceLayers : kInstanceLayers)))
-    , _deviceInfo(selectPhysicalDevice(instance().enumeratePhysicalDevices()))
+    , _deviceInfo(selectPhysicalDevice())
     , _device(createDevice())
-    , _queueManager(instance(), physicalDevice(), device())
-    , _window(*this, windowSize, name)
+    , _queueManager(instance(), physicalDevice(), device(), !offscreen)
     , _memory(device(), deviceInfo())
+    , _window(*this, windowSize, name)
 {
 }
 
@@ -36,6 +38,11 @@ const std::string& Application::name() const
     return _name;
 }
 
+bool Application::offscreen() const
+{
+    return _offscreen;
+}
+
 const vk::Instance& Application::instance() const
 {
     return *_instance;
@@ -78,8 +85,12 @@ Window& Application::window()
 
 vk::UniqueInstance Application::createInstance(const std::vector<const char*>& layers)
 {
-    initialize();
+    // Offscreen mode doesn't need any window system, so it works without a display
+    if (!offscreen()) {
+        initialize();
+    }
 
+    StartupPhases::Timer phase{"Instance creation", "instance"};
     std::vector<std::string> extensions = getRequiredExtensions();
     std::vector<const char*> extensionsView = viewOf(extensions);
     vk::ApplicationInfo applicationInfo{name().c_str(), VK_MAKE_VERSION(1, 0, 0), "LunarG SDK",
@@ -94,8 +105,11 @@ vk::UniqueInstance Application::createInstance(const std::vector<const char*>& l
     return vk::createInstanceUnique(instanceInfo);
 }
 
-DeviceInfo Application::selectPhysicalDevice(const std::vector<vk::PhysicalDevice>& physicalDevices)
+DeviceInfo Application::selectPhysicalDevice()
 {
+    StartupPhases::Timer phase{"Physical device selection", "physicalDevice"};
+    std::vector<vk::PhysicalDevice> physicalDevices = instance().enumeratePhysicalDevices();
+
     const auto deviceScore = [](const vk::PhysicalDevice& device) {
         switch (device.getProperties().deviceType) {
         case vk::PhysicalDeviceType::eOther:
@@ -126,12 +140,17 @@ DeviceInfo Application::selectPhysicalDevice(const std::vector<vk::PhysicalDevic
 
 vk::UniqueDevice Application::createDevice()
 {
-    std::vector<std::string> extensions = {{VK_KHR_SWAPCHAIN_EXTENSION_NAME}};
+    StartupPhases::Timer phase{"Device creation", "device"};
+    std::vector<std::string> extensions;
+    if (!offscreen()) {
+        extensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+    }
     std::vector<const char*> extensionsView = viewOf(extensions);
 
     vk::PhysicalDeviceFeatures features{};
     features.fillModeNonSolid = VK_TRUE;
-    std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos = QueueManager::createInfos(instance(), physicalDevice());
+    std::vector<vk::DeviceQueueCreateInfo> queueCreateInfos =
+        QueueManager::createInfos(instance(), physicalDevice(), !offscreen());
     vk::DeviceCreateInfo deviceCreateInfo{
         {},      static_cast<uint32_t>(queueCreateInfos.size()), queueCreateInfos.data(), 0,
         nullptr, static_cast<uint32_t>(extensionsView.size()),   extensionsView.data(),   &features};
@@ -141,6 +160,10 @@ vk::UniqueDevice Application::createDevice()
 
 std::vector<std::string> Application::getRequiredExtensions() const
 {
+    if (offscreen()) {
+        return {};
+    }
+
     std::set<std::string> extensions;
 
     // GLFW-required extensions
@@ -158,6 +181,7 @@ std::vector<std::string> Application::getRequiredExtensions() const
 
 void Application::initialize()
 {
+    StartupPhases::Timer phase{"GLFW initialization", "glfw"};
     if (!glfwInit()) {
         throw std::system_error(vk::Result::eErrorInitializationFailed, "Could not initialize GLFW");
     }
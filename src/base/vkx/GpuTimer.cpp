@@ -0,0 +1,196 @@
+#include <base/Profiler.h>
+#include <base/vkx/GpuTimer.h>
+
+#include <limits>
+#include <utility>
+
+namespace {
+const std::size_t kCalibrationSamples = 8u;
+}
+
+namespace base {
+namespace vkx {
+GpuTimer::GpuTimer()
+    : _device()
+    , _queryPool()
+    , _frameCount(0u)
+    , _passCount(0u)
+    , _written()
+    , _results()
+    , _tickPeriod(1.0)
+    , _validBitsMask(0u)
+    , _calibrationTicks(0u)
+    , _calibrationTime(0u)
+{
+}
+
+GpuTimer::GpuTimer(const vk::Device& device,
+                   const DeviceInfo& deviceInfo,
+                   const QueueManager& queues,
+                   std::size_t frameCount,
+                   std::size_t passCount)
+    : GpuTimer()
+{
+    _device = device;
+    _frameCount = frameCount;
+    _passCount = passCount;
+    create(deviceInfo, queues);
+}
+
+GpuTimer::GpuTimer(GpuTimer&& other)
+    : GpuTimer()
+{
+    swap(other);
+}
+
+GpuTimer::~GpuTimer()
+{
+    destroy();
+}
+
+GpuTimer& GpuTimer::operator=(GpuTimer&& other)
+{
+    destroy();
+    swap(other);
+
+    return *this;
+}
+
+void GpuTimer::collect(std::size_t frame, const Callback& callback)
+{
+    if (!_queryPool || !_written[frame])
+        return;
+    _written[frame] = false;
+
+    // Fence of the frame was already waited for, so results are normally available. If they are not,
+    // the sample is dropped rather than waited for.
+    vk::Result result = _device.getQueryPoolResults(
+        _queryPool, queryIndex(frame, 0u), static_cast<uint32_t>(_results.size()), _results.size() * sizeof(uint64_t),
+        _results.data(), sizeof(uint64_t), vk::QueryResultFlagBits::e64);
+    if (result != vk::Result::eSuccess)
+        return;
+
+    for (std::size_t pass = 0; pass < _passCount; ++pass) {
+        callback(pass, toProfilerTime(_results[2u * pass]), toProfilerTime(_results[2u * pass + 1u]));
+    }
+}
+
+void GpuTimer::reset(const vk::CommandBuffer& cmdBuffer, std::size_t frame)
+{
+    if (!_queryPool)
+        return;
+
+    // Must be recorded outside of a render pass
+    cmdBuffer.resetQueryPool(_queryPool, queryIndex(frame, 0u), static_cast<uint32_t>(2u * _passCount));
+    _written[frame] = true;
+}
+
+void GpuTimer::begin(const vk::CommandBuffer& cmdBuffer, std::size_t frame, std::size_t pass) const
+{
+    if (_queryPool) {
+        cmdBuffer.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, _queryPool, queryIndex(frame, pass));
+    }
+}
+
+void GpuTimer::end(const vk::CommandBuffer& cmdBuffer, std::size_t frame, std::size_t pass) const
+{
+    if (_queryPool) {
+        cmdBuffer.writeTimestamp(vk::PipelineStageFlagBits::eBottomOfPipe, _queryPool, queryIndex(frame, pass) + 1u);
+    }
+}
+
+void GpuTimer::create(const DeviceInfo& deviceInfo, const QueueManager& queues)
+{
+    // Queue families without timestamp support report 0 valid bits, timer is then silently disabled
+    uint32_t validBits = deviceInfo.device.getQueueFamilyProperties()[queues.familyIndex()].timestampValidBits;
+    if (validBits == 0u)
+        return;
+
+    _validBitsMask = (validBits >= 64u) ? std::numeric_limits<uint64_t>::max() : ((uint64_t{1} << validBits) - 1u);
+    _tickPeriod = static_cast<double>(deviceInfo.properties.limits.timestampPeriod);
+
+    uint32_t queryCount = static_cast<uint32_t>(_frameCount * _passCount * 2u);
+    _queryPool = _device.createQueryPool({{}, vk::QueryType::eTimestamp, queryCount, {}});
+    _written.assign(_frameCount, false);
+    _results.resize(2u * _passCount);
+
+    calibrate(queues);
+}
+
+void GpuTimer::calibrate(const QueueManager& queues)
+{
+    vk::CommandPoolCreateFlags cmdPoolFlags = vk::CommandPoolCreateFlagBits::eTransient;
+    vk::CommandPool cmdPool = _device.createCommandPool({cmdPoolFlags, queues.familyIndex()});
+    vk::CommandBuffer cmdBuffer =
+        _device.allocateCommandBuffers({cmdPool, vk::CommandBufferLevel::ePrimary, 1}).front();
+    vk::Fence fence = _device.createFence({});
+
+    cmdBuffer.begin({vk::CommandBufferUsageFlags{}, nullptr});
+    cmdBuffer.resetQueryPool(_queryPool, 0u, 1u);
+    cmdBuffer.writeTimestamp(vk::PipelineStageFlagBits::eTopOfPipe, _queryPool, 0u);
+    cmdBuffer.end();
+
+    // Timestamp is written somewhere between submission and fence signal, the shortest round-trip
+    // gives the smallest error of its midpoint estimate
+    uint64_t shortestRoundTrip = std::numeric_limits<uint64_t>::max();
+    for (std::size_t sample = 0; sample < kCalibrationSamples; ++sample) {
+        uint64_t before = base::Profiler::now();
+        queues.queue().submit(vk::SubmitInfo{0, nullptr, nullptr, 1, &cmdBuffer, 0, nullptr}, fence);
+        _device.waitForFences(1, &fence, VK_FALSE, UINT64_MAX);
+        uint64_t after = base::Profiler::now();
+        _device.resetFences(1, &fence);
+
+        uint64_t ticks = 0u;
+        _device.getQueryPoolResults(_queryPool, 0u, 1u, sizeof(ticks), &ticks, sizeof(ticks),
+                                    vk::QueryResultFlagBits::e64 | vk::QueryResultFlagBits::eWait);
+
+        if (after - before < shortestRoundTrip) {
+            shortestRoundTrip = after - before;
+            _calibrationTicks = ticks & _validBitsMask;
+            _calibrationTime = before + (after - before) / 2u;
+        }
+    }
+
+    _device.destroyFence(fence);
+    _device.destroyCommandPool(cmdPool);
+}
+
+void GpuTimer::destroy()
+{
+    if (_queryPool) {
+        _device.destroyQueryPool(_queryPool);
+    }
+
+    _device = vk::Device{};
+    _queryPool = vk::QueryPool{};
+    _written.clear();
+    _results.clear();
+}
+
+void GpuTimer::swap(GpuTimer& other)
+{
+    std::swap(_device, other._device);
+    std::swap(_queryPool, other._queryPool);
+    std::swap(_frameCount, other._frameCount);
+    std::swap(_passCount, other._passCount);
+    std::swap(_written, other._written);
+    std::swap(_results, other._results);
+    std::swap(_tickPeriod, other._tickPeriod);
+    std::swap(_validBitsMask, other._validBitsMask);
+    std::swap(_calibrationTicks, other._calibrationTicks);
+    std::swap(_calibrationTime, other._calibrationTime);
+}
+
+uint32_t GpuTimer::queryIndex(std::size_t frame, std::size_t pass) const
+{
+    return static_cast<uint32_t>((frame * _passCount + pass) * 2u);
+}
+
+uint64_t GpuTimer::toProfilerTime(uint64_t ticks) const
+{
+    // Masked difference stays correct even if the counter wrapped around since calibration
+    uint64_t elapsedTicks = ((ticks & _validBitsMask) - _calibrationTicks) & _validBitsMask;
+    return _calibrationTime + static_cast<uint64_t>(static_cast<double>(elapsedTicks) * _tickPeriod);
+}
+}
+}
@@ -2,6 +2,7 @@
 
 #include <base/vkx/DeviceInfo.h>
 
+#include <algorithm>
 #include <exception>
 #include <utility>
 
@@ -10,12 +11,18 @@ namespace vkx {
 MemoryManager::MemoryManager(const vk::Device& device, const vkx::DeviceInfo& deviceInfo)
     : _device(device)
     , _deviceInfo(deviceInfo)
+    , _allocationsMutex()
+    , _allocations()
+    , _heapUsage(deviceInfo.memory.memoryHeapCount, HeapUsage{0u, 0u})
 {
 }
 
 MemoryManager::MemoryManager(MemoryManager&& other)
     : MemoryManager(other._device, other._deviceInfo)
 {
+    std::lock_guard<std::mutex> lock(other._allocationsMutex);
+    std::swap(_allocations, other._allocations);
+    std::swap(_heapUsage, other._heapUsage);
 }
 
 MemoryManager::~MemoryManager()
@@ -40,14 +47,28 @@ vk::DeviceMemory MemoryManager::allocateHostVisibleMemory(const vk::MemoryRequir
 {
     auto flags = vk::MemoryPropertyFlagBits::eHostVisible | vk::MemoryPropertyFlagBits::eHostCoherent;
     auto memoryTypeIndex = getMemoryTypeIndex(flags, memoryRequirements.memoryTypeBits);
-    return _device.allocateMemory({memoryRequirements.size, memoryTypeIndex});
+    return allocateMemory(memoryRequirements.size, memoryTypeIndex);
 }
 
 vk::DeviceMemory MemoryManager::allocateDeviceLocalMemory(const vk::MemoryRequirements& memoryRequirements) const
 {
     auto flags = vk::MemoryPropertyFlagBits::eDeviceLocal;
     auto memoryTypeIndex = getMemoryTypeIndex(flags, memoryRequirements.memoryTypeBits);
-    return _device.allocateMemory({memoryRequirements.size, memoryTypeIndex});
+    return allocateMemory(memoryRequirements.size, memoryTypeIndex);
+}
+
+void MemoryManager::freeMemory(vk::DeviceMemory memory) const
+{
+    {
+        std::lock_guard<std::mutex> lock(_allocationsMutex);
+        auto allocation = _allocations.find(static_cast<VkDeviceMemory>(memory));
+        if (allocation != _allocations.end()) {
+            _heapUsage[allocation->second.heapIndex].bytes -= allocation->second.size;
+            _allocations.erase(allocation);
+        }
+    }
+
+    _device.freeMemory(memory);
 }
 
 Buffer MemoryManager::createStagingBuffer(vk::DeviceSize size) const
@@ -105,7 +126,7 @@ Buffer MemoryManager::copyToDeviceLocalMemoryAsync(const Buffer& sourceBuffer,
 
 void MemoryManager::destroyBuffer(Buffer& buffer) const
 {
-    _device.freeMemory(buffer.memory);
+    freeMemory(buffer.memory);
     _device.destroyBuffer(buffer.buffer);
 
     buffer.memory = vk::DeviceMemory{};
@@ -114,11 +135,31 @@ void MemoryManager::destroyBuffer(Buffer& buffer) const
 
 void MemoryManager::destroyImage(Image& image) const
 {
-    _device.freeMemory(image.memory);
+    freeMemory(image.memory);
     _device.destroyImage(image.image);
 
     image.memory = vk::DeviceMemory{};
     image.image = vk::Image{};
 }
+
+std::vector<MemoryManager::HeapUsage> MemoryManager::heapUsage() const
+{
+    std::lock_guard<std::mutex> lock(_allocationsMutex);
+    return _heapUsage;
+}
+
+vk::DeviceMemory MemoryManager::allocateMemory(vk::DeviceSize size, uint32_t memoryTypeIndex) const
+{
+    vk::DeviceMemory memory = _device.allocateMemory({size, memoryTypeIndex});
+
+    uint32_t heapIndex = _deviceInfo.memory.memoryTypes[memoryTypeIndex].heapIndex;
+    std::lock_guard<std::mutex> lock(_allocationsMutex);
+    _allocations[static_cast<VkDeviceMemory>(memory)] = Allocation{heapIndex, size};
+    HeapUsage& usage = _heapUsage[heapIndex];
+    usage.bytes += size;
+    usage.peakBytes = std::max(usage.peakBytes, usage.bytes);
+
+    return memory;
+}
 }
 }
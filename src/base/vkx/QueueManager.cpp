@@ -5,7 +5,8 @@
 namespace base {
 namespace vkx {
 std::vector<vk::DeviceQueueCreateInfo> QueueManager::createInfos(const vk::Instance& instance,
-                                                                 const vk::PhysicalDevice& device)
+                                                                 const vk::PhysicalDevice& device,
+                                                                 bool presentationRequired)
 {
     static const std::array<float, 1> priorities = {1.0f};
 
@@ -15,7 +16,8 @@ std::vector<vk::DeviceQueueCreateInfo> QueueManager::createInfos(const vk::Insta
     // According to spec, each queue supporting GRAPHICS operations also supports TRANSFER operations,
     // so let's look only for GRAPHICS flag.
     for (uint32_t queueFamilyIndex = 0; queueFamilyIndex < queueFamilyProperties.size(); ++queueFamilyIndex) {
-        if (!glfwGetPhysicalDevicePresentationSupport(static_cast<const VkInstance>(instance),
+        if (presentationRequired &&
+            !glfwGetPhysicalDevicePresentationSupport(static_cast<const VkInstance>(instance),
                                                       static_cast<const VkPhysicalDevice>(device), queueFamilyIndex)) {
             // Skip queue family which cannot be used for presentation
             continue;
@@ -36,8 +38,9 @@ std::vector<vk::DeviceQueueCreateInfo> QueueManager::createInfos(const vk::Insta
 
 QueueManager::QueueManager(const vk::Instance& instance,
                            const vk::PhysicalDevice& physicalDevice,
-                           const vk::Device& device)
-    : _familyIndex(chooseFamilyIndex(instance, physicalDevice))
+                           const vk::Device& device,
+                           bool presentationRequired)
+    : _familyIndex(chooseFamilyIndex(instance, physicalDevice, presentationRequired))
     , _queue(createQueue(device))
 {
 }
@@ -56,9 +59,11 @@ const vk::Queue& QueueManager::queue() const
     return _queue;
 }
 
-uint32_t QueueManager::chooseFamilyIndex(const vk::Instance& instance, const vk::PhysicalDevice& physicalDevice) const
+uint32_t QueueManager::chooseFamilyIndex(const vk::Instance& instance,
+                                         const vk::PhysicalDevice& physicalDevice,
+                                         bool presentationRequired) const
 {
-    return createInfos(instance, physicalDevice).front().queueFamilyIndex;
+    return createInfos(instance, physicalDevice, presentationRequired).front().queueFamilyIndex;
 }
 
 vk::Queue QueueManager::createQueue(const vk::Device& device)
@@ -1,14 +1,23 @@
 #include <base/vkx/Window.h>
 
+#include <base/Clock.h>
+#include <base/StartupPhases.h>
 #include <base/vkx/Application.h>
 
 #include <GLFW/glfw3.h>
 
+namespace {
+// Same number of images as requested from swapchain in onscreen mode
+const uint32_t kOffscreenImageCount = 3u;
+const vk::Format kOffscreenImageFormat = vk::Format::eR8G8B8A8Unorm;
+}
+
 namespace base {
 namespace vkx {
 Window::Window(const Application& application, const glm::uvec2& size, const std::string& windowTitle)
     : _lastFpsMeasure(0.0)
     , _thisFpsMeasure(0.0)
+    , _lastFrameMeasure(Clock::seconds())
     , _frameTime(1.0)
     , _framesCount(0u)
     , _application(application)
@@ -18,6 +27,8 @@ Window::Window(const Application& application, const glm::uvec2& size, const std
     , _surface(createSurface())
     , _swapchainSurfaceFormat(getSupportedSwapchainSurfaceFormat())
     , _swapchain(createSwapchain())
+    , _offscreenImages(createOffscreenImages())
+    , _nextOffscreenImage(0u)
     , _swapchainImages(querySwapchainImages())
     , _swapchainImageViews(createSwapchainImageViews())
 {
@@ -27,6 +38,7 @@ Window::Window(const Application& application, const glm::uvec2& size, const std
 Window::~Window()
 {
     destroySwapchainImageViews();
+    destroyOffscreenImages();
     destroySwapchain();
     destroySurface();
     destroyWindow();
@@ -38,12 +50,13 @@ void Window::update()
         return;
     }
 
-    glfwPollEvents();
+    if (!_application.offscreen()) {
+        glfwPollEvents();
+    }
 
-    static double _lastMeasure = glfwGetTime();
-    _thisFpsMeasure = glfwGetTime();
-    _frameTime = _thisFpsMeasure - _lastMeasure;
-    _lastMeasure = _thisFpsMeasure;
+    _thisFpsMeasure = Clock::seconds();
+    _frameTime = _thisFpsMeasure - _lastFrameMeasure;
+    _lastFrameMeasure = _thisFpsMeasure;
 
     _framesCount += 1;
     double fpsTime = _thisFpsMeasure - _lastFpsMeasure;
@@ -60,7 +73,42 @@ void Window::update()
 
 bool Window::shouldClose() const
 {
-    return (glfwWindowShouldClose(_handle) != 0);
+    return (_handle && glfwWindowShouldClose(_handle) != 0);
+}
+
+uint32_t Window::acquireNextImage(const vk::Semaphore& signalSemaphore) const
+{
+    if (_application.offscreen()) {
+        // Images are used round-robin, an empty batch signals semaphore the same way image acquisition would
+        uint32_t imageIndex = _nextOffscreenImage;
+        _nextOffscreenImage = (_nextOffscreenImage + 1) % static_cast<uint32_t>(_offscreenImages.size());
+
+        _application.queues().queue().submit(vk::SubmitInfo{0, nullptr, nullptr, 0, nullptr, 1, &signalSemaphore},
+                                             {});
+        return imageIndex;
+    }
+
+    auto nextFrameAcquireStatus =
+        _application.device().acquireNextImageKHR(swapchain(), UINT64_MAX, signalSemaphore, {});
+    if (nextFrameAcquireStatus.result != vk::Result::eSuccess) {
+        throw std::system_error(nextFrameAcquireStatus.result, "Error during acquiring next frame index");
+    }
+
+    return nextFrameAcquireStatus.value;
+}
+
+void Window::present(const vk::Semaphore& waitSemaphore, uint32_t imageIndex) const
+{
+    if (_application.offscreen()) {
+        // Nothing to present, but the semaphore has to be waited on before it's signaled again
+        vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eBottomOfPipe;
+        _application.queues().queue().submit(vk::SubmitInfo{1, &waitSemaphore, &waitStage, 0, nullptr, 0, nullptr},
+                                             {});
+        return;
+    }
+
+    vk::PresentInfoKHR presentInfo{1, &waitSemaphore, 1, &swapchain(), &imageIndex, nullptr};
+    _application.queues().queue().presentKHR(presentInfo);
 }
 
 const std::string& Window::title() const
@@ -71,13 +119,19 @@ const std::string& Window::title() const
 void Window::title(const std::string& title)
 {
     _title = title;
-    glfwSetWindowTitle(_handle, _title.c_str());
+
+    if (_handle) {
+        glfwSetWindowTitle(_handle, _title.c_str());
+    }
 }
 
 void Window::appendTitle(const std::string& text)
 {
     std::string appendedTitle = title() + text;
-    glfwSetWindowTitle(_handle, appendedTitle.c_str());
+
+    if (_handle) {
+        glfwSetWindowTitle(_handle, appendedTitle.c_str());
+    }
 }
 
 double Window::frameTime() const
@@ -115,8 +169,19 @@ const vk::Format& Window::swapchainImageFormat() const
     return _swapchainSurfaceFormat.format;
 }
 
+vk::ImageLayout Window::presentImageLayout() const
+{
+    return (_application.offscreen() ? vk::ImageLayout::eColorAttachmentOptimal : vk::ImageLayout::ePresentSrcKHR);
+}
+
 GLFWwindow* Window::createWindow()
 {
+    if (_application.offscreen()) {
+        _lastFpsMeasure = _thisFpsMeasure = Clock::seconds();
+        return nullptr;
+    }
+
+    StartupPhases::Timer phase{"Window creation", "window"};
     glfwWindowHint(GLFW_CLIENT_API, GLFW_NO_API);
     glfwWindowHint(GLFW_RESIZABLE, GL_FALSE);
     GLFWwindow* handle = glfwCreateWindow(size().x, size().y, title().c_str(), nullptr, nullptr);
@@ -125,13 +190,18 @@ GLFWwindow* Window::createWindow()
         throw std::system_error(vk::Result::eErrorInitializationFailed, "Could not create GLFW window");
     }
 
-    _lastFpsMeasure = _thisFpsMeasure = glfwGetTime();
+    _lastFpsMeasure = _thisFpsMeasure = Clock::seconds();
 
     return handle;
 }
 
 vk::SurfaceKHR Window::createSurface()
 {
+    StartupPhases::Timer phase{"Swapchain creation", "swapchain"};
+    if (_application.offscreen()) {
+        return {};
+    }
+
     VkSurfaceKHR surfaceHandle = VK_NULL_HANDLE;
     glfwCreateWindowSurface(static_cast<VkInstance>(_application.instance()), _handle, nullptr, &surfaceHandle);
 
@@ -146,6 +216,11 @@ vk::SurfaceKHR Window::createSurface()
 
 vk::SwapchainKHR Window::createSwapchain()
 {
+    StartupPhases::Timer phase{"Swapchain creation", "swapchain"};
+    if (_application.offscreen()) {
+        return {};
+    }
+
     vk::SurfaceCapabilitiesKHR surfaceCapabilities = _application.physicalDevice().getSurfaceCapabilitiesKHR(surface());
 
     if (!(surfaceCapabilities.supportedUsageFlags & vk::ImageUsageFlagBits::eColorAttachment)) {
@@ -178,13 +253,61 @@ vk::SwapchainKHR Window::createSwapchain()
     return _application.device().createSwapchainKHR(swapchainInfo);
 }
 
+std::vector<vkx::Image> Window::createOffscreenImages()
+{
+    StartupPhases::Timer phase{"Swapchain creation", "swapchain"};
+    std::vector<vkx::Image> images;
+    if (!_application.offscreen()) {
+        return images;
+    }
+
+    images.reserve(kOffscreenImageCount);
+    for (uint32_t index = 0; index < kOffscreenImageCount; ++index) {
+        vk::ImageCreateInfo imageInfo{{},
+                                      vk::ImageType::e2D,
+                                      _swapchainSurfaceFormat.format,
+                                      vk::Extent3D{size().x, size().y, 1},
+                                      1,
+                                      1,
+                                      vk::SampleCountFlagBits::e1,
+                                      vk::ImageTiling::eOptimal,
+                                      vk::ImageUsageFlagBits::eColorAttachment | vk::ImageUsageFlagBits::eTransferSrc,
+                                      vk::SharingMode::eExclusive,
+                                      0,
+                                      nullptr,
+                                      vk::ImageLayout::eUndefined};
+
+        vkx::Image image{};
+        image.image = _application.device().createImage(imageInfo);
+
+        vk::MemoryRequirements memoryRequirements = _application.device().getImageMemoryRequirements(image.image);
+        image.memory = _application.memory().allocateDeviceLocalMemory(memoryRequirements);
+        image.size = memoryRequirements.size;
+        _application.device().bindImageMemory(image.image, image.memory, 0);
+
+        images.push_back(image);
+    }
+
+    return images;
+}
+
 std::vector<vk::Image> Window::querySwapchainImages()
 {
+    StartupPhases::Timer phase{"Swapchain creation", "swapchain"};
+    if (_application.offscreen()) {
+        std::vector<vk::Image> images;
+        for (const vkx::Image& image : _offscreenImages) {
+            images.push_back(image.image);
+        }
+        return images;
+    }
+
     return _application.device().getSwapchainImagesKHR(swapchain());
 }
 
 std::vector<vk::ImageView> Window::createSwapchainImageViews()
 {
+    StartupPhases::Timer phase{"Swapchain creation", "swapchain"};
     std::vector<vk::ImageView> views;
 
     views.reserve(_swapchainImages.size());
@@ -209,24 +332,43 @@ void Window::destroySwapchainImageViews()
     _swapchainImageViews.clear();
 }
 
+void Window::destroyOffscreenImages()
+{
+    for (vkx::Image& image : _offscreenImages) {
+        _application.memory().destroyImage(image);
+    }
+    _offscreenImages.clear();
+}
+
 void Window::destroySwapchain()
 {
     _swapchainImages.clear();
-    _application.device().destroySwapchainKHR(_swapchain);
+
+    if (_swapchain) {
+        _application.device().destroySwapchainKHR(_swapchain);
+    }
 }
 
 void Window::destroySurface()
 {
-    _application.instance().destroySurfaceKHR(surface());
+    if (surface()) {
+        _application.instance().destroySurfaceKHR(surface());
+    }
 }
 
 void Window::destroyWindow()
 {
-    glfwDestroyWindow(_handle);
+    if (_handle) {
+        glfwDestroyWindow(_handle);
+    }
 }
 
 vk::SurfaceFormatKHR Window::getSupportedSwapchainSurfaceFormat() const
 {
+    if (_application.offscreen()) {
+        return {kOffscreenImageFormat, vk::ColorSpaceKHR::eSrgbNonlinear};
+    }
+
     const std::vector<vk::SurfaceFormatKHR> usableFormats = {
         {vk::Format::eB8G8R8A8Unorm, vk::ColorSpaceKHR::eSrgbNonlinear},
         {vk::Format::eR8G8B8A8Unorm, vk::ColorSpaceKHR::eSrgbNonlinear}};
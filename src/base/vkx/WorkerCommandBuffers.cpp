@@ -0,0 +1,120 @@
+#include <base/vkx/WorkerCommandBuffers.h>
+
+#include <utility>
+
+namespace base {
+namespace vkx {
+WorkerCommandBuffers::WorkerCommandBuffers()
+    : _device()
+    , _workers()
+    , _frameCount(0u)
+    , _passCount(0u)
+    , _frame(0u)
+{
+}
+
+WorkerCommandBuffers::WorkerCommandBuffers(const vk::Device& device,
+                                           const QueueManager& queues,
+                                           std::size_t workerCount,
+                                           std::size_t frameCount,
+                                           std::size_t passCount)
+    : WorkerCommandBuffers()
+{
+    _device = device;
+    _frameCount = frameCount;
+    _passCount = passCount;
+
+    _workers.resize(workerCount);
+    for (Worker& worker : _workers) {
+        vk::CommandPoolCreateFlags cmdPoolFlags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
+        worker.cmdPool = _device.createCommandPool({cmdPoolFlags, queues.familyIndex()});
+        worker.cmdBuffers = _device.allocateCommandBuffers(
+            {worker.cmdPool, vk::CommandBufferLevel::eSecondary, static_cast<uint32_t>(_frameCount * _passCount)});
+        worker.recording.assign(_passCount, 0);
+    }
+}
+
+WorkerCommandBuffers::WorkerCommandBuffers(WorkerCommandBuffers&& other)
+    : WorkerCommandBuffers()
+{
+    swap(other);
+}
+
+WorkerCommandBuffers::~WorkerCommandBuffers()
+{
+    destroy();
+}
+
+WorkerCommandBuffers& WorkerCommandBuffers::operator=(WorkerCommandBuffers&& other)
+{
+    destroy();
+    swap(other);
+
+    return *this;
+}
+
+std::size_t WorkerCommandBuffers::workerCount() const
+{
+    return _workers.size();
+}
+
+void WorkerCommandBuffers::reset(std::size_t frame)
+{
+    _frame = frame;
+    for (Worker& worker : _workers) {
+        worker.recording.assign(_passCount, 0);
+    }
+}
+
+const vk::CommandBuffer& WorkerCommandBuffers::begin(std::size_t worker,
+                                                     std::size_t pass,
+                                                     const vk::CommandBufferInheritanceInfo& inheritanceInfo,
+                                                     bool& begun)
+{
+    Worker& state = _workers[worker];
+    const vk::CommandBuffer& cmdBuffer = state.cmdBuffers[pass * _frameCount + _frame];
+
+    begun = !state.recording[pass];
+    if (begun) {
+        cmdBuffer.reset({});
+        cmdBuffer.begin(vk::CommandBufferBeginInfo{vk::CommandBufferUsageFlagBits::eRenderPassContinue |
+                                                       vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
+                                                   &inheritanceInfo});
+        state.recording[pass] = 1;
+    }
+    return cmdBuffer;
+}
+
+std::vector<vk::CommandBuffer> WorkerCommandBuffers::end(std::size_t pass)
+{
+    std::vector<vk::CommandBuffer> result;
+    for (Worker& worker : _workers) {
+        if (worker.recording[pass]) {
+            const vk::CommandBuffer& cmdBuffer = worker.cmdBuffers[pass * _frameCount + _frame];
+            cmdBuffer.end();
+            result.push_back(cmdBuffer);
+            worker.recording[pass] = 0;
+        }
+    }
+    return result;
+}
+
+void WorkerCommandBuffers::destroy()
+{
+    // Buffers are freed with their pools
+    for (Worker& worker : _workers) {
+        _device.destroyCommandPool(worker.cmdPool);
+    }
+    _workers.clear();
+}
+
+void WorkerCommandBuffers::swap(WorkerCommandBuffers& other)
+{
+    std::swap(_device, other._device);
+    std::swap(_workers, other._workers);
+    std::swap(_frameCount, other._frameCount);
+    std::swap(_passCount, other._passCount);
+    std::swap(_frame, other._frame);
+}
+}
+}
@@ -0,0 +1,245 @@
+#include <base/File.h>
+#include <base/String.h>
+#include <framework/Baseline.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <stdexcept>
+#include <utility>
+
+namespace {
+const double kAbsoluteSlackMs = 0.05; // differences below this are always noise
+const double kAbsoluteSlackMiB = 1.0;
+
+// Lower is better for all compared metrics, min/max/deviation are too noisy to gate on and total time depends on
+// the benchmark length rather than on the frame cost
+const char* kComparedSections[] = {"stats", "bound", "gpu"};
+const char* kIgnoredKeyPrefixes[] = {"min", "max", "stddev", "total"};
+const char* kIgnoredKeySuffixes[] = {"MaxMs"};
+
+// Memory is compared by its peaks only
+const char kMemorySection[] = "memory";
+const char kMemoryKeyPrefix[] = "peak";
+
+bool isMemoryMetric(const framework::BenchmarkResult::Field& field)
+{
+    return field.section == kMemorySection;
+}
+
+std::string formatValue(const framework::BenchmarkResult::Field& field, double value)
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), isMemoryMetric(field) ? "%.1fMiB" : "%.3fms", value);
+    return buffer;
+}
+}
+
+namespace framework {
+Baseline Baseline::load(const std::string& path)
+{
+    if (!base::File::exists(path))
+        throw std::invalid_argument("Couldn't open baseline file: " + path);
+
+    std::vector<BenchmarkResult> records;
+    std::size_t lineNumber = 0u;
+    for (std::string line : base::String::split(base::File::readText(path), '\n', false)) {
+        ++lineNumber;
+
+        base::String::trim(line);
+        if (line.empty())
+            continue;
+
+        try {
+            records.push_back(BenchmarkResult::parseJson(line));
+        } catch (const std::invalid_argument& exception) {
+            throw std::invalid_argument("Baseline line " + std::to_string(lineNumber) + ": " + exception.what());
+        }
+    }
+
+    return Baseline(std::move(records));
+}
+
+Baseline::Baseline(std::vector<BenchmarkResult> records)
+    : _records(std::move(records))
+{
+}
+
+bool Baseline::check(const std::vector<BenchmarkResult>& results, double tolerance, std::ostream& stream) const
+{
+    char title[64];
+    std::snprintf(title, sizeof(title), "Baseline check (tolerance %.1f%%)", tolerance * 100.0);
+
+    stream << title << std::endl;
+    stream << std::string(std::string{title}.size(), '=') << std::endl;
+
+    // Configurations in order of their first run
+    std::vector<std::string> keys;
+    for (const BenchmarkResult& result : results) {
+        std::string key = configurationKey(result);
+        if (std::find(keys.begin(), keys.end(), key) == keys.end()) {
+            keys.push_back(key);
+        }
+    }
+
+    bool passed = true;
+    for (const std::string& key : keys) {
+        std::vector<const BenchmarkResult*> current;
+        std::vector<const BenchmarkResult*> baseline;
+        for (const BenchmarkResult& result : results) {
+            if (configurationKey(result) == key)
+                current.push_back(&result);
+        }
+        for (const BenchmarkResult& record : _records) {
+            if (configurationKey(record) == key)
+                baseline.push_back(&record);
+        }
+
+        stream << "  " << describeConfiguration(*current.front()) << ": ";
+        if (baseline.empty()) {
+            stream << "no baseline" << std::endl;
+            continue;
+        }
+
+        std::vector<BenchmarkResult::Field> currentMetrics = medianMetrics(current);
+        std::vector<BenchmarkResult::Field> baselineMetrics = medianMetrics(baseline);
+
+        std::vector<std::string> regressions;
+        std::size_t comparedMetrics = 0u;
+        for (const BenchmarkResult::Field& metric : currentMetrics) {
+            auto reference = std::find_if(baselineMetrics.begin(), baselineMetrics.end(),
+                                          [&metric](const BenchmarkResult::Field& field) {
+                                              return field.section == metric.section && field.key == metric.key;
+                                          });
+            if (reference == baselineMetrics.end())
+                continue;
+            ++comparedMetrics;
+
+            double difference = metric.number - reference->number;
+            double slack = isMemoryMetric(metric) ? kAbsoluteSlackMiB : kAbsoluteSlackMs;
+            if (difference > reference->number * tolerance && difference > slack) {
+                char change[32];
+                std::snprintf(change, sizeof(change), "%+.1f%%", 100.0 * difference / reference->number);
+                regressions.push_back(metric.section + "." + metric.key + ": " +
+                                      formatValue(metric, reference->number) + " -> " +
+                                      formatValue(metric, metric.number) + " (" + change + ")");
+            }
+        }
+
+        if (regressions.empty()) {
+            stream << "OK (" << comparedMetrics << " metrics, " << current.size() << " vs " << baseline.size()
+                   << " runs)" << std::endl;
+        } else {
+            stream << "REGRESSION" << std::endl;
+            for (const std::string& regression : regressions) {
+                stream << "    " << regression << std::endl;
+            }
+            passed = false;
+        }
+    }
+    stream << std::endl;
+
+    return passed;
+}
+
+std::string Baseline::configurationKey(const BenchmarkResult& result)
+{
+    auto field = [&result](const std::string& key) -> std::string {
+        return result.has("run", key) ? result.text("run", key) : std::string{};
+    };
+
+    // Default values of later added fields aren't part of the key, so it matches baselines recorded before them
+    auto optionalField = [&field](const std::string& key, const std::string& defaultValue) -> std::string {
+        std::string value = field(key);
+        return (value.empty() || value == defaultValue) ? std::string{} : "|" + key + "=" + value;
+    };
+
+    return field("test") + "|" + field("api") + "|" + field("multithreaded") + "|" + field("offscreen") +
+           optionalField("threads", "0") + optionalField("sceneScale", "1") + optionalField("sceneDetail", "1") +
+           optionalField("pipelined", "0") + optionalField("framesInFlight", "0");
+}
+
+std::string Baseline::describeConfiguration(const BenchmarkResult& result)
+{
+    bool multithreaded = result.has("run", "multithreaded") && result.number("run", "multithreaded") != 0.0;
+    bool offscreen = result.has("run", "offscreen") && result.number("run", "offscreen") != 0.0;
+    double threads = result.has("run", "threads") ? result.number("run", "threads") : 0.0;
+    bool pipelined = result.has("run", "pipelined") && result.number("run", "pipelined") != 0.0;
+    double framesInFlight = result.has("run", "framesInFlight") ? result.number("run", "framesInFlight") : 0.0;
+
+    std::string threadCount = (threads > 0.0) ? " (" + result.text("run", "threads") + " threads)" : std::string{};
+    std::string sceneSize;
+    const std::pair<const char*, const char*> sceneSizes[] = {{"sceneScale", "scale"}, {"sceneDetail", "detail"}};
+    for (const auto& size : sceneSizes) {
+        if (result.has("run", size.first) && result.number("run", size.first) != 1.0) {
+            char buffer[64];
+            std::snprintf(buffer, sizeof(buffer), ", %s %g", size.second, result.number("run", size.first));
+            sceneSize += buffer;
+        }
+    }
+
+    std::string frames = pipelined ? ", pipelined" : "";
+    if (framesInFlight > 0.0) {
+        frames += ", " + result.text("run", "framesInFlight") + " frames in flight";
+    }
+
+    return "test " + result.text("run", "test") + ", api `" + result.text("run", "api") + "`" +
+           (multithreaded ? ", multithreaded" + threadCount : "") + frames + sceneSize +
+           (offscreen ? ", offscreen" : "");
+}
+
+bool Baseline::isComparedMetric(const BenchmarkResult::Field& field)
+{
+    if (!field.isNumber)
+        return false;
+
+    if (isMemoryMetric(field))
+        return base::String::startsWith(field.key, kMemoryKeyPrefix) && base::String::endsWith(field.key, "MiB");
+
+    if (!base::String::endsWith(field.key, "Ms"))
+        return false;
+
+    bool comparedSection = false;
+    for (const char* section : kComparedSections) {
+        comparedSection = comparedSection || (field.section == section);
+    }
+
+    bool ignoredKey = false;
+    for (const char* prefix : kIgnoredKeyPrefixes) {
+        ignoredKey = ignoredKey || base::String::startsWith(field.key, prefix);
+    }
+    for (const char* suffix : kIgnoredKeySuffixes) {
+        ignoredKey = ignoredKey || base::String::endsWith(field.key, suffix);
+    }
+
+    return comparedSection && !ignoredKey;
+}
+
+std::vector<BenchmarkResult::Field> Baseline::medianMetrics(const std::vector<const BenchmarkResult*>& results)
+{
+    std::vector<BenchmarkResult::Field> metrics;
+    for (const BenchmarkResult::Field& field : results.front()->fields()) {
+        if (!isComparedMetric(field))
+            continue;
+
+        std::vector<double> values;
+        for (const BenchmarkResult* result : results) {
+            if (result->has(field.section, field.key)) {
+                double value = result->number(field.section, field.key);
+                if (std::isfinite(value))
+                    values.push_back(value);
+            }
+        }
+        if (values.empty())
+            continue;
+        std::sort(values.begin(), values.end());
+
+        std::size_t middle = values.size() / 2u;
+        BenchmarkResult::Field metric = field;
+        metric.number = (values.size() % 2u == 1u) ? values[middle] : 0.5 * (values[middle - 1u] + values[middle]);
+        metrics.push_back(metric);
+    }
+
+    return metrics;
+}
+}
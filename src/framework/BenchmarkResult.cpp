@@ -0,0 +1,469 @@
+#include <framework/BenchmarkResult.h>
+
+#include <cctype>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+std::string formatNumber(double value)
+{
+    if (!std::isfinite(value)) {
+        return "";
+    }
+
+    std::ostringstream stream;
+    stream << std::setprecision(std::numeric_limits<double>::max_digits10) << value;
+    return stream.str();
+}
+
+std::string escapeJson(const std::string& text)
+{
+    std::string result;
+    result.reserve(text.size() + 2);
+
+    result += '"';
+    for (char c : text) {
+        switch (c) {
+        case '"':
+            result += "\\\"";
+            break;
+        case '\\':
+            result += "\\\\";
+            break;
+        case '\n':
+            result += "\\n";
+            break;
+        case '\r':
+            result += "\\r";
+            break;
+        case '\t':
+            result += "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                char buffer[8];
+                std::snprintf(buffer, sizeof(buffer), "\\u%04x", static_cast<unsigned int>(c));
+                result += buffer;
+            } else {
+                result += c;
+            }
+        }
+    }
+    result += '"';
+
+    return result;
+}
+
+std::string escapeCsv(const std::string& text)
+{
+    if (text.find_first_of(",\"\r\n") == std::string::npos) {
+        return text;
+    }
+
+    std::string result = "\"";
+    for (char c : text) {
+        if (c == '"') {
+            result += '"';
+        }
+        result += c;
+    }
+    result += '"';
+
+    return result;
+}
+
+std::string formatCsv(const framework::BenchmarkResult::Field& field)
+{
+    return (field.isNumber ? formatNumber(field.number) : escapeCsv(field.text));
+}
+
+// Records of CSV text, quoted fields may contain separators, quotes (doubled) and line breaks
+std::vector<std::vector<std::string>> splitCsv(const std::string& csv)
+{
+    std::vector<std::vector<std::string>> records;
+    std::vector<std::string> record;
+    std::string value;
+    bool quoted = false;
+
+    for (std::size_t position = 0; position < csv.size(); ++position) {
+        char c = csv[position];
+        if (quoted) {
+            if (c != '"') {
+                value += c;
+            } else if (position + 1u < csv.size() && csv[position + 1u] == '"') {
+                value += '"';
+                ++position;
+            } else {
+                quoted = false;
+            }
+        } else if (c == '"') {
+            quoted = true;
+        } else if (c == ',') {
+            record.push_back(value);
+            value.clear();
+        } else if (c == '\n') {
+            record.push_back(value);
+            value.clear();
+            records.push_back(record);
+            record.clear();
+        } else if (c != '\r') {
+            value += c;
+        }
+    }
+
+    if (quoted)
+        throw std::invalid_argument("Malformed CSV results (unterminated quoted value)");
+    if (!value.empty() || !record.empty()) {
+        record.push_back(value);
+        records.push_back(record);
+    }
+
+    return records;
+}
+
+// Minimal reader of our own JSON records: an object of section objects holding strings, numbers or nulls
+class JsonReader
+{
+  public:
+    JsonReader(const std::string& json)
+        : _json(json)
+        , _position(0u)
+    {
+    }
+
+    void skipWhitespace()
+    {
+        while (_position < _json.size() && std::isspace(static_cast<unsigned char>(_json[_position]))) {
+            ++_position;
+        }
+    }
+
+    bool consume(char expected)
+    {
+        skipWhitespace();
+        if (_position < _json.size() && _json[_position] == expected) {
+            ++_position;
+            return true;
+        }
+        return false;
+    }
+
+    void expect(char expected)
+    {
+        if (!consume(expected)) {
+            fail(std::string{"expected '"} + expected + "'");
+        }
+    }
+
+    bool atEnd()
+    {
+        skipWhitespace();
+        return (_position == _json.size());
+    }
+
+    bool peekString()
+    {
+        skipWhitespace();
+        return (_position < _json.size() && _json[_position] == '"');
+    }
+
+    std::string readString()
+    {
+        expect('"');
+
+        std::string result;
+        while (_position < _json.size() && _json[_position] != '"') {
+            char c = _json[_position++];
+            if (c != '\\') {
+                result += c;
+                continue;
+            }
+
+            if (_position >= _json.size())
+                break;
+
+            char escaped = _json[_position++];
+            switch (escaped) {
+            case 'n':
+                result += '\n';
+                break;
+            case 'r':
+                result += '\r';
+                break;
+            case 't':
+                result += '\t';
+                break;
+            case 'u':
+                // Writer escapes only control characters this way
+                if (_position + 4u > _json.size())
+                    fail("truncated escape sequence");
+                result += static_cast<char>(std::strtol(_json.substr(_position, 4u).c_str(), nullptr, 16));
+                _position += 4u;
+                break;
+            default:
+                result += escaped;
+            }
+        }
+
+        expect('"');
+        return result;
+    }
+
+    double readNumber()
+    {
+        skipWhitespace();
+        if (_json.compare(_position, 4u, "null") == 0) {
+            _position += 4u;
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+
+        const char* begin = _json.c_str() + _position;
+        char* end = nullptr;
+        double value = std::strtod(begin, &end);
+        if (end == begin)
+            fail("expected a number");
+
+        _position += static_cast<std::size_t>(end - begin);
+        return value;
+    }
+
+    [[noreturn]] void fail(const std::string& message) const
+    {
+        throw std::invalid_argument("Malformed result record (" + message + " at offset " + std::to_string(_position) +
+                                    ")");
+    }
+
+  private:
+    const std::string& _json;
+    std::size_t _position;
+};
+}
+
+namespace framework {
+BenchmarkResult BenchmarkResult::parseJson(const std::string& json)
+{
+    BenchmarkResult result;
+    JsonReader reader(json);
+
+    reader.expect('{');
+    if (!reader.consume('}')) {
+        do {
+            std::string section = reader.readString();
+            reader.expect(':');
+            reader.expect('{');
+
+            if (!reader.consume('}')) {
+                do {
+                    std::string key = reader.readString();
+                    reader.expect(':');
+
+                    if (reader.peekString()) {
+                        result.set(section, key, reader.readString());
+                    } else {
+                        result.set(section, key, reader.readNumber());
+                    }
+                } while (reader.consume(','));
+                reader.expect('}');
+            }
+        } while (reader.consume(','));
+        reader.expect('}');
+    }
+
+    if (!reader.atEnd())
+        reader.fail("unexpected trailing characters");
+
+    return result;
+}
+
+std::vector<BenchmarkResult> BenchmarkResult::parseCsv(const std::string& csv)
+{
+    std::vector<std::vector<std::string>> records = splitCsv(csv);
+    if (records.empty())
+        return {};
+
+    const std::vector<std::string>& header = records.front();
+    std::vector<BenchmarkResult> results;
+    for (std::size_t row = 1; row < records.size(); ++row) {
+        if (records[row].size() != header.size()) {
+            throw std::invalid_argument("Malformed CSV results (row " + std::to_string(row) + " has " +
+                                        std::to_string(records[row].size()) + " values, header has " +
+                                        std::to_string(header.size()) + ")");
+        }
+
+        BenchmarkResult result;
+        for (std::size_t column = 0; column < header.size(); ++column) {
+            std::size_t separator = header[column].find('.');
+            if (separator == std::string::npos)
+                throw std::invalid_argument("Malformed CSV results (column without section: " + header[column] + ")");
+
+            result.set(header[column].substr(0u, separator), header[column].substr(separator + 1u),
+                       records[row][column]);
+        }
+        results.push_back(result);
+    }
+
+    return results;
+}
+
+void BenchmarkResult::set(const std::string& section, const std::string& key, double value)
+{
+    Field& result = field(section, key);
+    result.isNumber = true;
+    result.number = value;
+    result.text.clear();
+}
+
+void BenchmarkResult::set(const std::string& section, const std::string& key, const std::string& value)
+{
+    Field& result = field(section, key);
+    result.isNumber = false;
+    result.number = 0.0;
+    result.text = value;
+}
+
+void BenchmarkResult::set(const std::string& section, const std::string& key, const char* value)
+{
+    set(section, key, std::string{value ? value : ""});
+}
+
+bool BenchmarkResult::has(const std::string& section, const std::string& key) const
+{
+    return (findField(section, key) != nullptr);
+}
+
+double BenchmarkResult::number(const std::string& section, const std::string& key) const
+{
+    const Field* result = findField(section, key);
+    if (!result || !result->isNumber) {
+        throw std::out_of_range("BenchmarkResult - missing numeric field: " + section + "." + key);
+    }
+
+    return result->number;
+}
+
+std::string BenchmarkResult::text(const std::string& section, const std::string& key) const
+{
+    const Field* result = findField(section, key);
+    if (!result) {
+        throw std::out_of_range("BenchmarkResult - missing field: " + section + "." + key);
+    }
+
+    return (result->isNumber ? formatNumber(result->number) : result->text);
+}
+
+const std::vector<BenchmarkResult::Field>& BenchmarkResult::fields() const
+{
+    return _fields;
+}
+
+void BenchmarkResult::writeJson(std::ostream& stream) const
+{
+    // Single-line JSON object with one nested object per section (JSON Lines friendly)
+    std::vector<std::string> sections;
+    for (const Field& field : _fields) {
+        bool known = false;
+        for (const std::string& section : sections) {
+            known = known || (section == field.section);
+        }
+        if (!known) {
+            sections.push_back(field.section);
+        }
+    }
+
+    stream << "{";
+    for (std::size_t s = 0; s < sections.size(); ++s) {
+        stream << (s > 0 ? "," : "") << escapeJson(sections[s]) << ":{";
+
+        bool first = true;
+        for (const Field& field : _fields) {
+            if (field.section != sections[s]) {
+                continue;
+            }
+
+            stream << (first ? "" : ",") << escapeJson(field.key) << ":";
+            if (field.isNumber) {
+                std::string number = formatNumber(field.number);
+                stream << (number.empty() ? "null" : number);
+            } else {
+                stream << escapeJson(field.text);
+            }
+            first = false;
+        }
+
+        stream << "}";
+    }
+    stream << "}" << std::endl;
+}
+
+std::vector<std::string> BenchmarkResult::csvColumns() const
+{
+    std::vector<std::string> columns;
+    for (const Field& field : _fields) {
+        columns.push_back(field.section + "." + field.key);
+    }
+    return columns;
+}
+
+void BenchmarkResult::writeCsvHeader(std::ostream& stream) const
+{
+    writeCsvHeader(stream, csvColumns());
+}
+
+void BenchmarkResult::writeCsvRow(std::ostream& stream) const
+{
+    for (std::size_t i = 0; i < _fields.size(); ++i) {
+        stream << (i > 0 ? "," : "") << formatCsv(_fields[i]);
+    }
+    stream << std::endl;
+}
+
+void BenchmarkResult::writeCsvRow(std::ostream& stream, const std::vector<std::string>& columns) const
+{
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+        stream << (i > 0 ? "," : "");
+        for (const Field& field : _fields) {
+            if (columns[i] == field.section + "." + field.key) {
+                stream << formatCsv(field);
+                break;
+            }
+        }
+    }
+    stream << std::endl;
+}
+
+void BenchmarkResult::writeCsvHeader(std::ostream& stream, const std::vector<std::string>& columns)
+{
+    for (std::size_t i = 0; i < columns.size(); ++i) {
+        stream << (i > 0 ? "," : "") << escapeCsv(columns[i]);
+    }
+    stream << std::endl;
+}
+
+BenchmarkResult::Field& BenchmarkResult::field(const std::string& section, const std::string& key)
+{
+    for (Field& field : _fields) {
+        if (field.section == section && field.key == key) {
+            return field;
+        }
+    }
+
+    _fields.push_back(Field{section, key, false, 0.0, std::string{}});
+    return _fields.back();
+}
+
+const BenchmarkResult::Field* BenchmarkResult::findField(const std::string& section, const std::string& key) const
+{
+    for (const Field& field : _fields) {
+        if (field.section == section && field.key == key) {
+            return &field;
+        }
+    }
+
+    return nullptr;
+}
+}
@@ -1,25 +1,101 @@
+#include <base/Clock.h>
+#include <base/MemoryStats.h>
+#include <base/Profiler.h>
+#include <base/ScopedTimer.h>
+#include <base/StartupPhases.h>
 #include <framework/BenchmarkableTest.h>
 
-#include <GLFW/glfw3.h>
-
 #include <algorithm>
+#include <cctype>
 #include <iostream>
-#include <limits>
+#include <stdexcept>
 #include <string>
+#include <thread>
+
+namespace {
+// Frame times are recorded in seconds, between 1us and 100s with <1% relative error
+const double kHistogramLowestFrameTime = 1.0e-6;
+const double kHistogramHighestFrameTime = 100.0;
+const std::size_t kHistogramSubBuckets = 128u;
+
+// GPU pass times are recorded in seconds as well, between 100ns and 10s
+const double kHistogramLowestPassTime = 1.0e-7;
+const double kHistogramHighestPassTime = 10.0;
+
+// Power of two fraction is exact both in float and double, so scene time of frame N is exactly N * step
+// no matter which precision a test accumulates it in
+const double kDeterministicTimeStep = 1.0 / 64.0;
+
+// Warm-up is counted in frames when number of measured frames is fixed, so every run does the same work
+const std::size_t kWarmupFrames = 100u;
+
+const char* const kPerfPhaseNames[] = {"setup", "warm-up", "measured"};
+const char* const kPerfPhaseKeys[] = {"setup", "warmup", "measured"};
+
+const double kBytesInMiB = 1024.0 * 1024.0;
+
+std::string toMiB(std::size_t bytes)
+{
+    return std::to_string(static_cast<double>(bytes) / kBytesInMiB) + "MiB";
+}
+
+std::string capitalized(std::string text)
+{
+    if (!text.empty()) {
+        text[0] = static_cast<char>(std::toupper(static_cast<unsigned char>(text[0])));
+    }
+    return text;
+}
+}
 
 namespace framework {
-BenchmarkableTest::BenchmarkableTest(bool benchmarkMode, float benchmarkTime)
+BenchmarkableTest::BenchmarkableTest(const TestConfiguration& configuration)
     : TestInterface()
-    , _benchmarkEnabled(benchmarkMode)
-    , _firstSecondIgnored(false)
-    , _benchmarkTime(benchmarkTime)
-    , _minFrameTime(std::numeric_limits<double>::max())
-    , _maxFrameTime(0.0)
+    , _benchmarkEnabled(configuration.benchmarkMode)
+    , _deterministic(configuration.deterministic)
+    , _pipelined(configuration.pipelined)
+    , _workerThreads(configuration.threads)
+    , _warmupFinished(false)
+    , _benchmarkTime(configuration.benchmarkTime)
+    , _benchmarkFrames(configuration.benchmarkFrames)
     , _startTime(0.0)
     , _lastMeasureTime(0.0)
     , _measuredTime(0.0)
     , _frameCount(0u)
+    , _frameTimes(kHistogramLowestFrameTime, kHistogramHighestFrameTime, kHistogramSubBuckets)
+    , _frameClassifier()
+    , _threadUtilization()
+    , _threadPool()
+    , _soakMonitor(configuration.soakWindow)
+    , _gpuPasses()
+    , _drawCalls(0u)
+    , _drawnVertices(0u)
+    , _heapAllocationsAtStart(base::MemoryStats::heapAllocations())
+    , _mainThreadCpuStart(0.0)
+    , _mainThreadCpuTime(0.0)
+    , _setupTime(0.0)
+    , _setupPhasesTime(0.0)
+    , _mainThreadCounters()
+    , _allThreadsCounters()
+    , _perfSnapshots()
 {
+    if (_workerThreads == 0u) {
+        _workerThreads = std::max<std::size_t>(std::thread::hardware_concurrency(), 1u);
+    }
+
+    // Tests build their scenes after this, so peaks cover the whole run of each test
+    base::MemoryStats::resetPeaks();
+
+    // Opened before tests start their worker threads, so those are included in all threads counters
+    if (_benchmarkEnabled) {
+        _mainThreadCounters.open(false);
+        _allThreadsCounters.open(true);
+    }
+    // Pipelined tests update the next frame on a worker, `-pipeline` is accepted only by tests doing so
+    if (configuration.multithreaded || _pipelined) {
+        _threadPool.reset(new base::ThreadPool(configuration.multithreaded ? _workerThreads : 1u));
+    }
+    takePerfSnapshot(SetupPhase);
 }
 
 void BenchmarkableTest::printStatistics() const
@@ -37,15 +113,121 @@ void BenchmarkableTest::printStatistics() const
 
     auto toMs = [](double frameTime) -> std::string { return std::to_string(frameTime * 1000.0) + "ms"; };
 
+    auto toPercent = [this](FrameStage stage) -> std::string {
+        auto frames = static_cast<double>(std::max<std::size_t>(_frameClassifier.frames(), 1u));
+        return std::to_string(100.0 * static_cast<double>(_frameClassifier.frames(stage)) / frames) + "%";
+    };
+
     std::cout << "Frame rate statistics" << std::endl;
     std::cout << "=====================" << std::endl;
-    std::cout << "  Minimum frame time: " << toMs(_minFrameTime) << std::endl;
-    std::cout << "  Maximum frame time: " << toMs(_maxFrameTime) << std::endl;
+    std::cout << "  Minimum frame time: " << toMs(_frameTimes.min()) << std::endl;
+    std::cout << "  Maximum frame time: " << toMs(_frameTimes.max()) << std::endl;
     std::cout << "  Average frame time: " << toMs(_measuredTime / static_cast<double>(_frameCount)) << std::endl;
+    std::cout << "  Frame time std. deviation: " << toMs(_frameTimes.stddev()) << std::endl;
+    std::cout << std::endl;
+    std::cout << "  Frame time p50: " << toMs(_frameTimes.percentile(50.0)) << std::endl;
+    std::cout << "  Frame time p95: " << toMs(_frameTimes.percentile(95.0)) << std::endl;
+    std::cout << "  Frame time p99: " << toMs(_frameTimes.percentile(99.0)) << std::endl;
+    std::cout << "  Frame time p99.9: " << toMs(_frameTimes.percentile(99.9)) << std::endl;
     std::cout << std::endl;
-    std::cout << "  Maximum FPS: " << toFps(_minFrameTime) << std::endl;
-    std::cout << "  Minimum FPS: " << toFps(_maxFrameTime) << std::endl;
+    std::cout << "  Maximum FPS: " << toFps(_frameTimes.min()) << std::endl;
+    std::cout << "  Minimum FPS: " << toFps(_frameTimes.max()) << std::endl;
     std::cout << "  Average FPS: " << toFps(_measuredTime / static_cast<double>(_frameCount)) << std::endl;
+
+    std::cout << std::endl;
+    std::cout << "Workload" << std::endl;
+    std::cout << "========" << std::endl;
+    if (_benchmarkFrames > 0u) {
+        std::cout << "  Measured frames: " << _frameCount << " (after " << kWarmupFrames << " warm-up frames)"
+                  << std::endl;
+    } else {
+        std::cout << "  Measured frames: " << _frameCount << " (after 1s warm-up)" << std::endl;
+    }
+    std::cout << "  Total time: " << toMs(_measuredTime) << std::endl;
+    std::cout << "  Throughput: " << toFps(_measuredTime / static_cast<double>(_frameCount)) << " frames/s"
+              << std::endl;
+    if (_drawCalls > 0u) {
+        std::cout << "  Draw calls: " << drawsPerFrame() << " per frame (" << verticesPerFrame() << " vertices)"
+                  << std::endl;
+    }
+
+    std::cout << std::endl;
+    std::cout << "Frame classification (bound by)" << std::endl;
+    std::cout << "===============================" << std::endl;
+    for (std::size_t index = 0; index < FrameClassifier::kStageCount; ++index) {
+        auto stage = static_cast<FrameStage>(index);
+        std::cout << "  " << FrameClassifier::name(stage) << ": " << toPercent(stage) << " of frames, avg "
+                  << toMs(_frameClassifier.averageTime(stage)) << " per frame" << std::endl;
+    }
+
+    if (!_gpuPasses.empty()) {
+        std::cout << std::endl;
+        std::cout << "GPU pass times" << std::endl;
+        std::cout << "==============" << std::endl;
+        for (const GpuPass& pass : _gpuPasses) {
+            std::cout << "  " << pass.name << ": avg " << toMs(pass.times.mean()) << ", p50 "
+                      << toMs(pass.times.percentile(50.0)) << ", p99 " << toMs(pass.times.percentile(99.0)) << ", max "
+                      << toMs(pass.times.max()) << " (" << pass.times.count() << " samples)" << std::endl;
+        }
+    }
+
+    if (_soakMonitor.enabled()) {
+        std::cout << std::endl;
+        _soakMonitor.print(std::cout);
+    }
+
+    printStartupPhases();
+    printThreadUtilization();
+    printMemoryUsage();
+    printPerfCounters();
+}
+
+void BenchmarkableTest::exportStatistics(BenchmarkResult& result) const
+{
+    if (!_benchmarkEnabled)
+        return;
+
+    auto averageFrameTime = (_frameCount > 0u) ? (_measuredTime / static_cast<double>(_frameCount)) : 0.0;
+
+    result.set("stats", "frames", static_cast<double>(_frameCount));
+    result.set("stats", "measuredTime", _measuredTime);
+    result.set("stats", "minFrameTimeMs", _frameTimes.min() * 1000.0);
+    result.set("stats", "maxFrameTimeMs", _frameTimes.max() * 1000.0);
+    result.set("stats", "avgFrameTimeMs", averageFrameTime * 1000.0);
+    result.set("stats", "stddevFrameTimeMs", _frameTimes.stddev() * 1000.0);
+    result.set("stats", "p50FrameTimeMs", _frameTimes.percentile(50.0) * 1000.0);
+    result.set("stats", "p95FrameTimeMs", _frameTimes.percentile(95.0) * 1000.0);
+    result.set("stats", "p99FrameTimeMs", _frameTimes.percentile(99.0) * 1000.0);
+    result.set("stats", "p99_9FrameTimeMs", _frameTimes.percentile(99.9) * 1000.0);
+    result.set("stats", "avgFps", (averageFrameTime > 0.0) ? (1.0 / averageFrameTime) : 0.0);
+    result.set("stats", "totalTimeMs", _measuredTime * 1000.0);
+    result.set("stats", "drawsPerFrame", drawsPerFrame());
+    result.set("stats", "verticesPerFrame", verticesPerFrame());
+
+    auto frames = static_cast<double>(std::max<std::size_t>(_frameClassifier.frames(), 1u));
+    for (std::size_t index = 0; index < FrameClassifier::kStageCount; ++index) {
+        auto stage = static_cast<FrameStage>(index);
+        std::string key{FrameClassifier::key(stage)};
+        result.set("bound", key + "Share", static_cast<double>(_frameClassifier.frames(stage)) / frames);
+        result.set("bound", key + "AvgMs", _frameClassifier.averageTime(stage) * 1000.0);
+    }
+
+    for (const GpuPass& pass : _gpuPasses) {
+        std::string name{pass.name};
+        result.set("gpu", name + "AvgMs", pass.times.mean() * 1000.0);
+        result.set("gpu", name + "P50Ms", pass.times.percentile(50.0) * 1000.0);
+        result.set("gpu", name + "P99Ms", pass.times.percentile(99.0) * 1000.0);
+        result.set("gpu", name + "MaxMs", pass.times.max() * 1000.0);
+    }
+
+    if (_soakMonitor.enabled()) {
+        _soakMonitor.exportResults(result);
+    }
+
+    exportStartupPhases(result);
+    exportThreadUtilization(result);
+    exportMemoryUsage(result);
+    exportPerfCounters(result);
 }
 
 void BenchmarkableTest::startMeasuring()
@@ -60,14 +242,53 @@ void BenchmarkableTest::startMeasuring(double startTime)
 
     _startTime = startTime;
     _frameCount = 0u;
-    _minFrameTime = std::numeric_limits<double>::max();
-    _maxFrameTime = 0.0;
+    _frameTimes.reset();
+    _frameClassifier.reset();
+    _threadUtilization.reset();
+    _soakMonitor.reset(startTime);
+    _drawCalls = 0u;
+    _drawnVertices = 0u;
+    for (GpuPass& pass : _gpuPasses) {
+        pass.times.reset();
+    }
+    _mainThreadCpuStart = base::Clock::threadCpuSeconds();
     _lastMeasureTime = _startTime;
 }
 
+void BenchmarkableTest::finishSetup()
+{
+    takePerfSnapshot(WarmupPhase);
+    TIME_RESET("Frame");
+
+    // Phases recorded later (e.g. first frame of initialization test) aren't part of setup
+    if (_benchmarkEnabled) {
+        _setupTime = getCurrentTime() - _startTime;
+        _setupPhasesTime = 0.0;
+        for (const base::StartupPhases::Phase& phase : base::StartupPhases::phases()) {
+            _setupPhasesTime += phase.time;
+        }
+    }
+}
+
+void BenchmarkableTest::finishRun()
+{
+    // Run ended before warm-up did, all its frames were measured
+    if (!_perfSnapshots[MeasuredPhase].taken) {
+        _perfSnapshots[MeasuredPhase] = _perfSnapshots[WarmupPhase];
+    }
+    takePerfSnapshot(PerfPhaseCount);
+
+    if (_benchmarkEnabled && _soakMonitor.enabled()) {
+        _soakMonitor.finish(getCurrentTime());
+    }
+
+    // Runner calls this from the same (main) thread, which runs the test and measures frames
+    _mainThreadCpuTime = base::Clock::threadCpuSeconds() - _mainThreadCpuStart;
+}
+
 double BenchmarkableTest::getCurrentTime()
 {
-    return glfwGetTime();
+    return base::Clock::seconds();
 }
 
 bool BenchmarkableTest::processFrameTime()
@@ -75,7 +296,7 @@ bool BenchmarkableTest::processFrameTime()
     if (!_benchmarkEnabled)
         return false;
 
-    auto now = glfwGetTime();
+    auto now = getCurrentTime();
     auto frameTime = now - _lastMeasureTime;
     auto result = processFrameTime(frameTime);
     _lastMeasureTime = now;
@@ -84,24 +305,313 @@ bool BenchmarkableTest::processFrameTime()
 }
 
 bool BenchmarkableTest::processFrameTime(double frameTime)
+{
+    bool finished = measureFrameTime(frameTime);
+
+    // The last frame is finished by the end of profiler session
+    if (!finished) {
+        TIME_RESET("Frame");
+    }
+    return finished;
+}
+
+bool BenchmarkableTest::measureFrameTime(double frameTime)
 {
     if (!_benchmarkEnabled)
         return false;
 
+    auto now = getCurrentTime();
     ++_frameCount;
-    _minFrameTime = std::min(_minFrameTime, frameTime);
-    _maxFrameTime = std::max(_maxFrameTime, frameTime);
-    _measuredTime = glfwGetTime() - _startTime;
+    _frameTimes.record(frameTime);
+    _frameClassifier.finishFrame(frameTime);
+    _measuredTime = now - _startTime;
+    if (_soakMonitor.enabled()) {
+        _soakMonitor.addFrame(frameTime, now);
+    }
+
+    if (_benchmarkFrames > 0u) {
+        if (!_warmupFinished && _frameCount >= kWarmupFrames) {
+            startMeasuring();
+            _warmupFinished = true;
+            takePerfSnapshot(MeasuredPhase);
+            return false;
+        }
 
-    std::cerr << "Benchmark ENABLED!!!\n\n\n\n";
-    std::cerr << "Frame time: " << frameTime << "\n\n\n\n";
+        return _warmupFinished && (_frameCount >= _benchmarkFrames);
+    }
 
     // Ignore 1s of measurements to remove longer first frames from statistics, but not on 1st frame
-    if (!_firstSecondIgnored && _measuredTime >= 1.0 && _frameCount != 1) {
+    if (!_warmupFinished && _measuredTime >= 1.0 && _frameCount != 1) {
         startMeasuring();
-        _firstSecondIgnored = true;
+        _warmupFinished = true;
+        takePerfSnapshot(MeasuredPhase);
     }
 
     return (_measuredTime >= _benchmarkTime);
 }
+
+double BenchmarkableTest::simulationTimeStep(double frameTime) const
+{
+    return _deterministic ? kDeterministicTimeStep : frameTime;
+}
+
+std::size_t BenchmarkableTest::workerThreads() const
+{
+    return _workerThreads;
+}
+
+bool BenchmarkableTest::pipelined() const
+{
+    return _pipelined;
+}
+
+base::ThreadPool& BenchmarkableTest::threadPool() const
+{
+    if (!_threadPool)
+        throw std::logic_error("Thread pool is available only in multithreaded and pipelined tests!");
+
+    return *_threadPool;
+}
+
+void BenchmarkableTest::countDraws(std::size_t draws, std::size_t vertices) const
+{
+    _drawCalls.fetch_add(draws, std::memory_order_relaxed);
+    _drawnVertices.fetch_add(vertices, std::memory_order_relaxed);
+}
+
+std::size_t BenchmarkableTest::registerGpuPass(const char* name)
+{
+    _gpuPasses.push_back(
+        GpuPass{name, base::Histogram(kHistogramLowestPassTime, kHistogramHighestPassTime, kHistogramSubBuckets)});
+    return _gpuPasses.size() - 1u;
+}
+
+void BenchmarkableTest::processGpuPassTime(std::size_t pass, uint64_t begin, uint64_t end)
+{
+    base::Profiler::gpuZone(_gpuPasses[pass].name, begin, end);
+
+    if (_benchmarkEnabled && end > begin) {
+        _gpuPasses[pass].times.record(static_cast<double>(end - begin) * 1.0e-9);
+    }
+}
+
+std::vector<BenchmarkableTest::GpuMemoryUsage> BenchmarkableTest::gpuMemoryUsage() const
+{
+    return {};
+}
+
+double BenchmarkableTest::drawsPerFrame() const
+{
+    return static_cast<double>(_drawCalls.load()) / static_cast<double>(std::max<std::size_t>(_frameCount, 1u));
+}
+
+double BenchmarkableTest::verticesPerFrame() const
+{
+    return static_cast<double>(_drawnVertices.load()) / static_cast<double>(std::max<std::size_t>(_frameCount, 1u));
+}
+
+void BenchmarkableTest::takePerfSnapshot(std::size_t index)
+{
+    _perfSnapshots[index] = PerfSnapshot{_mainThreadCounters.read(), _allThreadsCounters.read(), true};
+}
+
+void BenchmarkableTest::perfPhaseValues(std::size_t phase,
+                                        base::PerfCounters::Values& mainThread,
+                                        base::PerfCounters::Values& otherThreads) const
+{
+    const PerfSnapshot& begin = _perfSnapshots[phase];
+    const PerfSnapshot& end = _perfSnapshots[phase + 1u];
+
+    for (std::size_t index = 0; index < base::PerfCounters::CounterCount; ++index) {
+        mainThread[index] = end.mainThread[index] - begin.mainThread[index];
+        otherThreads[index] = std::max((end.allThreads[index] - begin.allThreads[index]) - mainThread[index], 0.0);
+    }
+}
+
+void BenchmarkableTest::printStartupPhases() const
+{
+    auto toMs = [](double time) -> std::string { return std::to_string(time * 1000.0) + "ms"; };
+
+    std::cout << std::endl;
+    std::cout << "Startup phases" << std::endl;
+    std::cout << "==============" << std::endl;
+    for (const base::StartupPhases::Phase& phase : base::StartupPhases::phases()) {
+        std::cout << "  " << phase.name << ": " << toMs(phase.time) << std::endl;
+    }
+    std::cout << "  Setup time: " << toMs(_setupTime) << " (" << toMs(std::max(_setupTime - _setupPhasesTime, 0.0))
+              << " outside of phases above)" << std::endl;
+}
+
+void BenchmarkableTest::exportStartupPhases(BenchmarkResult& result) const
+{
+    for (const base::StartupPhases::Phase& phase : base::StartupPhases::phases()) {
+        result.set("startup", std::string{phase.key} + "Ms", phase.time * 1000.0);
+    }
+    result.set("startup", "setupMs", _setupTime * 1000.0);
+}
+
+void BenchmarkableTest::printThreadUtilization() const
+{
+    auto frames = static_cast<double>(std::max<std::size_t>(_frameCount, 1u));
+    auto perFrame = [frames](double time) -> std::string { return std::to_string(time * 1000.0 / frames) + "ms"; };
+    auto toPercent = [](double share) -> std::string { return std::to_string(share * 100.0) + "%"; };
+
+    std::cout << std::endl;
+    std::cout << "Thread utilization" << std::endl;
+    std::cout << "==================" << std::endl;
+    std::cout << "  Main thread CPU time: " << perFrame(_mainThreadCpuTime) << " per frame ("
+              << toPercent((_measuredTime > 0.0) ? _mainThreadCpuTime / _measuredTime : 0.0) << " of frame time)"
+              << std::endl;
+
+    if (_threadUtilization.regions() == 0u)
+        return;
+
+    const ThreadUtilization& threads = _threadUtilization;
+    std::cout << "  Parallel regions: " << static_cast<double>(threads.regions()) / frames << " per frame, "
+              << threads.averageWorkers() << " workers each" << std::endl;
+    std::cout << "  Region time:      " << perFrame(threads.regionTime()) << " per frame" << std::endl;
+    std::cout << "  Worker busy time: " << perFrame(threads.workerTime()) << " per frame (CPU time "
+              << perFrame(threads.workerCpuTime()) << ")" << std::endl;
+    std::cout << "  Worker idle time: " << perFrame(threads.workerIdleTime()) << " per frame" << std::endl;
+    std::cout << "  Join wait time:   " << perFrame(threads.joinTime()) << " per frame (main thread)" << std::endl;
+    std::cout << "  Parallel efficiency: " << toPercent(threads.efficiency()) << std::endl;
+    std::cout << "  Parallel speedup:    " << threads.speedup() << "x (of " << threads.averageWorkers()
+              << " workers)" << std::endl;
+}
+
+void BenchmarkableTest::exportThreadUtilization(BenchmarkResult& result) const
+{
+    auto frames = static_cast<double>(std::max<std::size_t>(_frameCount, 1u));
+    auto setPerFrameMs = [&result, frames](const std::string& key, double time) {
+        result.set("threads", key, time * 1000.0 / frames);
+    };
+
+    setPerFrameMs("mainCpuMs", _mainThreadCpuTime);
+    if (_threadUtilization.regions() == 0u)
+        return;
+
+    result.set("threads", "workers", _threadUtilization.averageWorkers());
+    setPerFrameMs("regionMs", _threadUtilization.regionTime());
+    setPerFrameMs("workerBusyMs", _threadUtilization.workerTime());
+    setPerFrameMs("workerCpuMs", _threadUtilization.workerCpuTime());
+    setPerFrameMs("workerIdleMs", _threadUtilization.workerIdleTime());
+    setPerFrameMs("joinWaitMs", _threadUtilization.joinTime());
+    result.set("threads", "efficiency", _threadUtilization.efficiency());
+    result.set("threads", "speedup", _threadUtilization.speedup());
+}
+
+void BenchmarkableTest::printMemoryUsage() const
+{
+    std::cout << std::endl;
+    std::cout << "Memory usage" << std::endl;
+    std::cout << "============" << std::endl;
+
+    if (base::MemoryStats::peakResidentBytes() > 0u) {
+        std::cout << "  Resident set: " << toMiB(base::MemoryStats::residentBytes()) << " (peak "
+                  << toMiB(base::MemoryStats::peakResidentBytes()) << ")" << std::endl;
+    }
+    std::cout << "  Heap: " << toMiB(base::MemoryStats::heapBytes()) << " (peak "
+              << toMiB(base::MemoryStats::peakHeapBytes()) << "), "
+              << (base::MemoryStats::heapAllocations() - _heapAllocationsAtStart) << " allocations" << std::endl;
+    for (const GpuMemoryUsage& usage : gpuMemoryUsage()) {
+        std::cout << "  " << usage.name << ": " << toMiB(usage.bytes) << " (peak " << toMiB(usage.peakBytes) << ")"
+                  << std::endl;
+    }
+}
+
+void BenchmarkableTest::exportMemoryUsage(BenchmarkResult& result) const
+{
+    auto setMiB = [&result](const std::string& key, std::size_t bytes) {
+        result.set("memory", key, static_cast<double>(bytes) / kBytesInMiB);
+    };
+
+    if (base::MemoryStats::peakResidentBytes() > 0u) {
+        setMiB("residentMiB", base::MemoryStats::residentBytes());
+        setMiB("peakResidentMiB", base::MemoryStats::peakResidentBytes());
+    }
+    setMiB("heapMiB", base::MemoryStats::heapBytes());
+    setMiB("peakHeapMiB", base::MemoryStats::peakHeapBytes());
+    result.set("memory", "heapAllocations",
+               static_cast<double>(base::MemoryStats::heapAllocations() - _heapAllocationsAtStart));
+    for (const GpuMemoryUsage& usage : gpuMemoryUsage()) {
+        setMiB(usage.key + "MiB", usage.bytes);
+        setMiB("peak" + capitalized(usage.key) + "MiB", usage.peakBytes);
+    }
+}
+
+void BenchmarkableTest::printPerfCounters() const
+{
+    std::cout << std::endl;
+    std::cout << "Performance counters" << std::endl;
+    std::cout << "====================" << std::endl;
+
+    if (!_mainThreadCounters.available()) {
+        std::cout << "  Not available (" << _mainThreadCounters.error() << ")" << std::endl;
+        return;
+    }
+
+    auto printValues = [this](const std::string& label, const base::PerfCounters::Values& values) {
+        std::cout << "  " << label << ":";
+        const char* separator = " ";
+        for (std::size_t index = 0; index < base::PerfCounters::CounterCount; ++index) {
+            auto counter = static_cast<base::PerfCounters::Counter>(index);
+            if (!_mainThreadCounters.available(counter))
+                continue;
+
+            std::cout << separator << static_cast<unsigned long long>(values[index] + 0.5) << " "
+                      << base::PerfCounters::name(counter);
+            separator = ", ";
+        }
+        if (_mainThreadCounters.available(base::PerfCounters::Cycles) &&
+            _mainThreadCounters.available(base::PerfCounters::Instructions) &&
+            values[base::PerfCounters::Cycles] > 0.0) {
+            std::cout << separator << "IPC "
+                      << values[base::PerfCounters::Instructions] / values[base::PerfCounters::Cycles];
+        }
+        std::cout << std::endl;
+    };
+
+    for (std::size_t phase = 0; phase < PerfPhaseCount; ++phase) {
+        base::PerfCounters::Values mainThread;
+        base::PerfCounters::Values otherThreads;
+        perfPhaseValues(phase, mainThread, otherThreads);
+
+        bool hasOtherThreads =
+            std::any_of(otherThreads.begin(), otherThreads.end(), [](double value) { return value >= 1.0; });
+        printValues(std::string{kPerfPhaseNames[phase]} + ", main thread", mainThread);
+        if (hasOtherThreads) {
+            printValues(std::string{kPerfPhaseNames[phase]} + ", other threads", otherThreads);
+        }
+    }
+
+    std::string unavailable;
+    for (std::size_t index = 0; index < base::PerfCounters::CounterCount; ++index) {
+        auto counter = static_cast<base::PerfCounters::Counter>(index);
+        if (!_mainThreadCounters.available(counter)) {
+            unavailable += (unavailable.empty() ? "" : ", ") + std::string{base::PerfCounters::name(counter)};
+        }
+    }
+    if (!unavailable.empty()) {
+        std::cout << "  Not available: " << unavailable << " (" << _mainThreadCounters.error() << ")" << std::endl;
+    }
+}
+
+void BenchmarkableTest::exportPerfCounters(BenchmarkResult& result) const
+{
+    for (std::size_t phase = 0; phase < PerfPhaseCount; ++phase) {
+        base::PerfCounters::Values mainThread;
+        base::PerfCounters::Values otherThreads;
+        perfPhaseValues(phase, mainThread, otherThreads);
+
+        for (std::size_t index = 0; index < base::PerfCounters::CounterCount; ++index) {
+            auto counter = static_cast<base::PerfCounters::Counter>(index);
+            if (!_mainThreadCounters.available(counter))
+                continue;
+
+            std::string key = capitalized(base::PerfCounters::key(counter));
+            result.set("perf", std::string{kPerfPhaseKeys[phase]} + "Main" + key, mainThread[index]);
+            result.set("perf", std::string{kPerfPhaseKeys[phase]} + "Other" + key, otherThreads[index]);
+        }
+    }
+}
 }
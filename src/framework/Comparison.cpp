@@ -0,0 +1,196 @@
+#include <framework/Comparison.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <numeric>
+
+namespace {
+const std::size_t kBootstrapResamples = 10000u;
+const std::size_t kPermutations = 10000u;
+const double kConfidenceLevel = 0.95;
+const double kSignificanceLevel = 0.05;
+const std::mt19937::result_type kSeed = 5489u; // std::mt19937 default seed
+
+double mean(const std::vector<double>& values)
+{
+    return std::accumulate(values.begin(), values.end(), 0.0) / static_cast<double>(values.size());
+}
+
+double median(const std::vector<double>& values)
+{
+    std::vector<double> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+
+    std::size_t middle = sorted.size() / 2u;
+    return (sorted.size() % 2u == 1u) ? sorted[middle] : 0.5 * (sorted[middle - 1u] + sorted[middle]);
+}
+
+double quantile(const std::vector<double>& sorted, double fraction)
+{
+    // Linear interpolation between closest ranks
+    double position = fraction * static_cast<double>(sorted.size() - 1u);
+    auto lower = static_cast<std::size_t>(std::floor(position));
+    auto upper = std::min(lower + 1u, sorted.size() - 1u);
+    return sorted[lower] + (position - static_cast<double>(lower)) * (sorted[upper] - sorted[lower]);
+}
+
+std::string formatMs(double value)
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.3fms", value);
+    return buffer;
+}
+
+std::string formatPercent(double value)
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%+.2f%%", value * 100.0);
+    return buffer;
+}
+}
+
+namespace framework {
+Comparison::Comparison(const std::string& labelA, const std::string& labelB)
+    : _a{labelA, {}, {}}
+    , _b{labelB, {}, {}}
+    , _generator(kSeed)
+{
+}
+
+void Comparison::addRun(bool isB, const BenchmarkResult& result)
+{
+    if (!result.has("stats", "avgFrameTimeMs") || !result.has("stats", "p50FrameTimeMs"))
+        return;
+
+    Side& side = isB ? _b : _a;
+    side.meanFrameTimes.push_back(result.number("stats", "avgFrameTimeMs"));
+    side.medianFrameTimes.push_back(result.number("stats", "p50FrameTimeMs"));
+}
+
+void Comparison::print(std::ostream& stream) const
+{
+    std::string title = "A/B comparison (" + std::to_string(_a.meanFrameTimes.size()) + " vs " +
+                        std::to_string(_b.meanFrameTimes.size()) + " runs)";
+
+    stream << title << std::endl;
+    stream << std::string(title.size(), '=') << std::endl;
+    stream << "  A: " << _a.label << std::endl;
+    stream << "  B: " << _b.label << std::endl;
+
+    if (_a.meanFrameTimes.size() < 2u || _b.meanFrameTimes.size() < 2u) {
+        stream << "  Not enough successful runs, at least 2 of each configuration are needed" << std::endl;
+        stream << std::endl;
+        return;
+    }
+
+    auto printInterval = [&stream](const Interval& interval, std::string (*format)(double)) {
+        stream << format(interval.estimate) << " [" << format(interval.low) << ", " << format(interval.high) << "]";
+    };
+
+    auto printRow = [&](const char* name, const std::vector<double>& a, const std::vector<double>& b,
+                        Statistic statistic) -> Interval {
+        Interval difference = bootstrapRelativeDifference(a, b, statistic);
+
+        stream << "  " << name << " A ";
+        printInterval(bootstrap(a, statistic), &formatMs);
+        stream << ", B ";
+        printInterval(bootstrap(b, statistic), &formatMs);
+        stream << ", B vs A ";
+        printInterval(difference, &formatPercent);
+        stream << std::endl;
+
+        return difference;
+    };
+
+    Interval meanDifference = printRow("Mean frame time:  ", _a.meanFrameTimes, _b.meanFrameTimes, &mean);
+    printRow("Median frame time:", _a.medianFrameTimes, _b.medianFrameTimes, &median);
+
+    double pValue = permutationTest(_a.meanFrameTimes, _b.meanFrameTimes);
+
+    char buffer[128];
+    std::snprintf(buffer, sizeof(buffer), "%.0f%% CI, permutation test p = %.4f", kConfidenceLevel * 100.0, pValue);
+    stream << "  (" << buffer << ")" << std::endl;
+
+    // Verdict is based on mean frame time, significant only if both the test and the interval agree
+    bool significant = (pValue < kSignificanceLevel) && (meanDifference.low > 0.0 || meanDifference.high < 0.0);
+    if (significant) {
+        const std::string& faster = (meanDifference.estimate < 0.0) ? _b.label : _a.label;
+        std::snprintf(buffer, sizeof(buffer), "%.1f%% +/- %.1f%%", std::fabs(meanDifference.estimate) * 100.0,
+                      (meanDifference.high - meanDifference.low) * 50.0);
+        stream << "  Verdict: " << faster << " faster by " << buffer << std::endl;
+    } else {
+        stream << "  Verdict: no significant difference" << std::endl;
+    }
+    stream << std::endl;
+}
+
+Comparison::Interval Comparison::bootstrap(const std::vector<double>& samples, Statistic statistic) const
+{
+    std::uniform_int_distribution<std::size_t> pick{0u, samples.size() - 1u};
+    std::vector<double> resample(samples.size());
+    std::vector<double> statistics(kBootstrapResamples);
+
+    for (double& value : statistics) {
+        for (double& sample : resample) {
+            sample = samples[pick(_generator)];
+        }
+        value = statistic(resample);
+    }
+    std::sort(statistics.begin(), statistics.end());
+
+    double tail = (1.0 - kConfidenceLevel) / 2.0;
+    return Interval{statistic(samples), quantile(statistics, tail), quantile(statistics, 1.0 - tail)};
+}
+
+Comparison::Interval Comparison::bootstrapRelativeDifference(const std::vector<double>& samplesA,
+                                                             const std::vector<double>& samplesB,
+                                                             Statistic statistic) const
+{
+    std::uniform_int_distribution<std::size_t> pickA{0u, samplesA.size() - 1u};
+    std::uniform_int_distribution<std::size_t> pickB{0u, samplesB.size() - 1u};
+    std::vector<double> resampleA(samplesA.size());
+    std::vector<double> resampleB(samplesB.size());
+    std::vector<double> differences(kBootstrapResamples);
+
+    for (double& difference : differences) {
+        for (double& sample : resampleA) {
+            sample = samplesA[pickA(_generator)];
+        }
+        for (double& sample : resampleB) {
+            sample = samplesB[pickB(_generator)];
+        }
+        difference = statistic(resampleB) / statistic(resampleA) - 1.0;
+    }
+    std::sort(differences.begin(), differences.end());
+
+    double tail = (1.0 - kConfidenceLevel) / 2.0;
+    return Interval{statistic(samplesB) / statistic(samplesA) - 1.0, quantile(differences, tail),
+                    quantile(differences, 1.0 - tail)};
+}
+
+double Comparison::permutationTest(const std::vector<double>& samplesA, const std::vector<double>& samplesB) const
+{
+    // Two-sided test of the difference of means, labels are shuffled between runs of both configurations
+    std::vector<double> pooled = samplesA;
+    pooled.insert(pooled.end(), samplesB.begin(), samplesB.end());
+
+    auto difference = [&samplesA](const std::vector<double>& values) {
+        std::vector<double> a(values.begin(), values.begin() + samplesA.size());
+        std::vector<double> b(values.begin() + samplesA.size(), values.end());
+        return std::fabs(mean(b) - mean(a));
+    };
+
+    double observed = difference(pooled);
+    std::size_t extreme = 0u;
+    for (std::size_t permutation = 0; permutation < kPermutations; ++permutation) {
+        std::shuffle(pooled.begin(), pooled.end(), _generator);
+        // Tolerance keeps permutations with the same split from being missed due to rounding
+        if (difference(pooled) >= observed * (1.0 - 1.0e-9)) {
+            ++extreme;
+        }
+    }
+
+    return static_cast<double>(extreme + 1u) / static_cast<double>(kPermutations + 1u);
+}
+}
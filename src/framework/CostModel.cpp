@@ -0,0 +1,111 @@
+#include <base/LeastSquares.h>
+#include <framework/CostModel.h>
+
+#include <cstdio>
+#include <set>
+#include <utility>
+
+namespace {
+std::string formatMs(double value)
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.3fms", value);
+    return buffer;
+}
+
+std::string formatNs(double milliseconds)
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.2fns", milliseconds * 1.0e6);
+    return buffer;
+}
+}
+
+namespace framework {
+double CostModel::Model::frameTime(double draws, double vertices) const
+{
+    return fixedTime + drawTime * draws + vertexTime * vertices;
+}
+
+CostModel::CostModel(const std::string& label)
+    : _label(label)
+    , _samples()
+{
+}
+
+void CostModel::addRun(float sceneScale, float sceneDetail, const BenchmarkResult& result)
+{
+    if (!result.has("stats", "avgFrameTimeMs") || !result.has("stats", "drawsPerFrame"))
+        return;
+
+    double draws = result.number("stats", "drawsPerFrame");
+    if (draws <= 0.0)
+        return;
+
+    _samples.push_back(Sample{sceneScale, sceneDetail, draws, result.number("stats", "verticesPerFrame"),
+                              result.number("stats", "avgFrameTimeMs")});
+}
+
+std::size_t CostModel::sizes() const
+{
+    std::set<std::pair<float, float>> sizes;
+    for (const Sample& sample : _samples) {
+        sizes.insert({sample.sceneScale, sample.sceneDetail});
+    }
+    return sizes.size();
+}
+
+CostModel::Model CostModel::fit() const
+{
+    // Terms are fixed time, time per draw and time per vertex, each run is a separate sample
+    base::LeastSquares::Rows rows;
+    std::vector<double> values;
+    for (const Sample& sample : _samples) {
+        rows.push_back({1.0, sample.draws, sample.vertices});
+        values.push_back(sample.frameTime);
+    }
+
+    std::vector<double> coefficients;
+    if (!base::LeastSquares::solveNonNegative(rows, values, coefficients))
+        return Model{0.0, 0.0, 0.0, false, false};
+
+    std::vector<double> unconstrained;
+    bool separable = base::LeastSquares::solve(rows, values, unconstrained);
+
+    return Model{coefficients[0], coefficients[1], coefficients[2], separable, true};
+}
+
+void CostModel::print(std::ostream& stream) const
+{
+    std::string title = "Cost model (" + _label + ")";
+
+    stream << title << std::endl;
+    stream << std::string(title.size(), '=') << std::endl;
+
+    Model model = fit();
+    if (sizes() < 2u || !model.valid) {
+        stream << "  Not enough successful runs, at least 2 different scene sizes are needed" << std::endl;
+        stream << std::endl;
+        return;
+    }
+
+    char buffer[128];
+    stream << "  Scale  Detail       Draws      Vertices    Frame time         Model" << std::endl;
+    for (const Sample& sample : _samples) {
+        std::snprintf(buffer, sizeof(buffer), "  %5.2f  %6.2f  %10.0f  %12.0f  %12s  %12s", sample.sceneScale,
+                      sample.sceneDetail, sample.draws, sample.vertices, formatMs(sample.frameTime).c_str(),
+                      formatMs(model.frameTime(sample.draws, sample.vertices)).c_str());
+        stream << buffer << std::endl;
+    }
+
+    stream << "  Fixed cost:      " << formatMs(model.fixedTime) << " per frame" << std::endl;
+    stream << "  Cost per draw:   " << formatNs(model.drawTime) << std::endl;
+    stream << "  Cost per vertex: " << formatNs(model.vertexTime) << std::endl;
+    if (!model.separable) {
+        stream << "  (draws and vertices changed in the same proportion, their costs can't be told apart;"
+               << std::endl;
+        stream << "   vary both `-scale` and `-detail` to separate them)" << std::endl;
+    }
+    stream << std::endl;
+}
+}
@@ -0,0 +1,107 @@
+#include <base/Clock.h>
+#include <framework/FrameClassifier.h>
+
+#include <algorithm>
+
+namespace framework {
+const std::size_t FrameClassifier::kStageCount;
+
+FrameClassifier::FrameClassifier()
+    : _currentFrame()
+    , _totalTimes()
+    , _boundFrames()
+    , _frames(0u)
+{
+}
+
+void FrameClassifier::reset()
+{
+    _currentFrame.fill(0.0);
+    _totalTimes.fill(0.0);
+    _boundFrames.fill(0u);
+    _frames = 0u;
+}
+
+void FrameClassifier::addStageTime(FrameStage stage, double time)
+{
+    _currentFrame[static_cast<std::size_t>(stage)] += time;
+}
+
+void FrameClassifier::finishFrame(double frameTime)
+{
+    // Measured stages can't take more than the whole frame, the rest is application time
+    const auto application = static_cast<std::size_t>(FrameStage::Application);
+
+    double measuredTime = 0.0;
+    for (std::size_t stage = 0; stage < kStageCount; ++stage) {
+        measuredTime += (stage != application) ? _currentFrame[stage] : 0.0;
+    }
+    _currentFrame[application] = std::max(frameTime - measuredTime, 0.0);
+
+    auto boundBy = std::max_element(_currentFrame.begin(), _currentFrame.end()) - _currentFrame.begin();
+    ++_boundFrames[static_cast<std::size_t>(boundBy)];
+    ++_frames;
+
+    for (std::size_t stage = 0; stage < kStageCount; ++stage) {
+        _totalTimes[stage] += _currentFrame[stage];
+    }
+    _currentFrame.fill(0.0);
+}
+
+std::size_t FrameClassifier::frames() const
+{
+    return _frames;
+}
+
+std::size_t FrameClassifier::frames(FrameStage boundBy) const
+{
+    return _boundFrames[static_cast<std::size_t>(boundBy)];
+}
+
+double FrameClassifier::averageTime(FrameStage stage) const
+{
+    return (_frames > 0u) ? (_totalTimes[static_cast<std::size_t>(stage)] / static_cast<double>(_frames)) : 0.0;
+}
+
+const char* FrameClassifier::name(FrameStage stage)
+{
+    switch (stage) {
+    case FrameStage::Application:
+        return "Application CPU";
+    case FrameStage::Driver:
+        return "Driver";
+    case FrameStage::GpuWait:
+        return "GPU wait";
+    case FrameStage::Present:
+        return "Present";
+    }
+    return "";
+}
+
+const char* FrameClassifier::key(FrameStage stage)
+{
+    switch (stage) {
+    case FrameStage::Application:
+        return "application";
+    case FrameStage::Driver:
+        return "driver";
+    case FrameStage::GpuWait:
+        return "gpuWait";
+    case FrameStage::Present:
+        return "present";
+    }
+    return "";
+}
+
+FrameStageTimer::FrameStageTimer(FrameClassifier& classifier, FrameStage stage)
+    : _classifier(classifier)
+    , _stage(stage)
+    , _start(base::Clock::seconds())
+{
+}
+
+FrameStageTimer::~FrameStageTimer()
+{
+    _classifier.addStageTime(_stage, base::Clock::seconds() - _start);
+}
+}
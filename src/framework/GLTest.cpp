@@ -1,14 +1,26 @@
+#include <base/gl/Buffer.h>
 #include <framework/GLTest.h>
 
 #include <GL/glew.h>
 
 #include <iostream>
+#include <string>
+
+namespace {
+std::string getGLString(GLenum name)
+{
+    const GLubyte* value = glGetString(name);
+    return (value ? reinterpret_cast<const char*>(value) : "");
+}
+}
 
 namespace framework {
-GLTest::GLTest(const std::string& testName, bool benchmarkMode, float benchmarkTime)
-    : BenchmarkableTest(benchmarkMode, benchmarkTime)
+GLTest::GLTest(const std::string& testName, const TestConfiguration& configuration)
+    : BenchmarkableTest(configuration)
     , window_({WINDOW_WIDTH, WINDOW_HEIGHT}, "[GL] " + testName)
 {
+    window_.setOffscreen(configuration.offscreen);
+    base::gl::Buffer::resetPeakAllocatedBytes();
 }
 
 void GLTest::setup()
@@ -23,12 +35,24 @@ void GLTest::teardown()
     window_.deinitialize();
 }
 
+void GLTest::updateWindow()
+{
+    // Offscreen frames are throttled by GPU fences, while swapping buffers is presentation (and waiting for GPU)
+    FrameStageTimer stage{_frameClassifier, window_.isOffscreen() ? FrameStage::GpuWait : FrameStage::Present};
+    window_.update();
+}
+
+std::vector<BenchmarkableTest::GpuMemoryUsage> GLTest::gpuMemoryUsage() const
+{
+    return {{"GL buffers", "glBuffers", base::gl::Buffer::allocatedBytes(), base::gl::Buffer::peakAllocatedBytes()}};
+}
+
 void GLTest::printStatistics() const
 {
     std::cout << "Hardware/software information" << std::endl;
     std::cout << "=============================" << std::endl;
-    std::cout << "  Vendor:     " << glGetString(GL_VENDOR) << std::endl;
-    std::cout << "  Renderer:   " << glGetString(GL_RENDERER) << std::endl;
+    std::cout << "  Vendor:     " << getGLString(GL_VENDOR) << std::endl;
+    std::cout << "  Renderer:   " << getGLString(GL_RENDERER) << std::endl;
     std::cout << std::endl;
 
     std::cout << "Test information" << std::endl;
@@ -38,4 +62,20 @@ void GLTest::printStatistics() const
 
     BenchmarkableTest::printStatistics();
 }
+
+void GLTest::exportStatistics(BenchmarkResult& result) const
+{
+    GLint majorVersion = 0;
+    GLint minorVersion = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &majorVersion);
+    glGetIntegerv(GL_MINOR_VERSION, &minorVersion);
+
+    result.set("run", "name", window_.getTitle());
+    result.set("device", "vendor", getGLString(GL_VENDOR));
+    result.set("device", "device", getGLString(GL_RENDERER));
+    result.set("device", "apiVersion", std::to_string(majorVersion) + "." + std::to_string(minorVersion));
+    result.set("device", "driverVersion", getGLString(GL_VERSION));
+
+    BenchmarkableTest::exportStatistics(result);
+}
 }
@@ -0,0 +1,137 @@
+#include <base/Clock.h>
+#include <framework/NullTest.h>
+
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+namespace {
+const double kFpsRefreshRate = 1.0; // 1 second
+}
+
+namespace framework {
+NullTest::NullTest(const std::string& testName, const TestConfiguration& configuration)
+    : BenchmarkableTest(configuration)
+    , _title("[NULL] " + testName)
+    , _lastFrameMeasure(0.0)
+    , _lastFpsMeasure(0.0)
+    , _frameTime(0.0)
+    , _framesCount(0u)
+    , _uniformData()
+    , _uniformUpdates(0u)
+    , _drawCalls(0u)
+    , _drawnElements(0u)
+    , _frames(0u)
+{
+}
+
+void NullTest::setup()
+{
+    _lastFrameMeasure = _lastFpsMeasure = base::Clock::seconds();
+    _frameTime = 0.0;
+    _framesCount = 0u;
+
+    _uniformUpdates = 0u;
+    _drawCalls = 0u;
+    _drawnElements = 0u;
+    _frames = 0u;
+}
+
+void NullTest::teardown()
+{
+}
+
+void NullTest::printStatistics() const
+{
+    auto perFrame = [this](std::size_t count) -> std::string {
+        return std::to_string(static_cast<double>(count) / static_cast<double>(std::max<std::size_t>(_frames, 1u)));
+    };
+
+    std::cout << "Hardware/software information" << std::endl;
+    std::cout << "=============================" << std::endl;
+    std::cout << "  API:    null (no rendering)" << std::endl;
+    std::cout << std::endl;
+
+    std::cout << "Test information" << std::endl;
+    std::cout << "================" << std::endl;
+    std::cout << "  Name: " << title() << std::endl;
+    std::cout << "  Draw calls per frame:      " << perFrame(_drawCalls) << std::endl;
+    std::cout << "  Drawn elements per frame:  " << perFrame(_drawnElements) << std::endl;
+    std::cout << "  Uniform updates per frame: " << perFrame(_uniformUpdates) << std::endl;
+    std::cout << std::endl;
+
+    BenchmarkableTest::printStatistics();
+}
+
+void NullTest::exportStatistics(BenchmarkResult& result) const
+{
+    // Same fields as other APIs, so records can be stored in a single CSV file
+    result.set("run", "name", title());
+    result.set("device", "vendor", "");
+    result.set("device", "device", "null");
+    result.set("device", "deviceType", "");
+    result.set("device", "apiVersion", "");
+    result.set("device", "driverVersion", "");
+
+    BenchmarkableTest::exportStatistics(result);
+}
+
+void NullTest::update()
+{
+    double now = base::Clock::seconds();
+    _frameTime = now - _lastFrameMeasure;
+    _lastFrameMeasure = now;
+    ++_frames;
+
+    // There is no window title to display FPS in, so print it when not benchmarking
+    _framesCount += 1;
+    double fpsTime = now - _lastFpsMeasure;
+    if (!_benchmarkEnabled && fpsTime > kFpsRefreshRate) {
+        std::cout << title() << " | " << (fpsTime * 1000.0) / _framesCount
+                  << "ms | FPS: " << static_cast<unsigned int>(_framesCount / fpsTime) << std::endl;
+
+        _framesCount = 0u;
+        _lastFpsMeasure = now;
+    }
+}
+
+bool NullTest::shouldClose() const
+{
+    // No window that could be closed, test ends only when benchmarking is complete
+    return false;
+}
+
+double NullTest::frameTime() const
+{
+    return _frameTime;
+}
+
+const std::string& NullTest::title() const
+{
+    return _title;
+}
+
+void NullTest::setUniform(const glm::vec4& value)
+{
+    setUniformData(&value, sizeof(value));
+}
+
+void NullTest::setUniform(const glm::mat4& value)
+{
+    setUniformData(&value, sizeof(value));
+}
+
+void NullTest::draw(std::size_t count, std::ptrdiff_t /*offset*/)
+{
+    ++_drawCalls;
+    _drawnElements += count;
+}
+
+void NullTest::setUniformData(const void* data, std::size_t size)
+{
+    // Uniform data is copied like a driver would do, so computing it can't be optimized away
+    std::memcpy(_uniformData.data(), data, std::min(size, _uniformData.size()));
+    ++_uniformUpdates;
+}
+}
@@ -0,0 +1,240 @@
+#include <base/MemoryStats.h>
+#include <base/SystemSensors.h>
+#include <framework/SoakMonitor.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <string>
+
+namespace {
+// Same range as frame time histogram of the whole run, fewer sub-buckets are enough for a window
+const double kHistogramLowestFrameTime = 1.0e-6;
+const double kHistogramHighestFrameTime = 100.0;
+const std::size_t kHistogramSubBuckets = 64u;
+
+// Drift needs at least one window in each quarter, which don't overlap
+const std::size_t kMinDriftWindows = 4u;
+const double kFrameTimeCreepThreshold = 0.1;
+const double kMemoryGrowthThreshold = 0.05;
+const double kMemoryGrowthMinBytes = 4.0 * 1024.0 * 1024.0;
+const double kThrottlingThreshold = 0.1;
+
+const std::size_t kMaxPrintedWindows = 24u;
+const double kBytesInMiB = 1024.0 * 1024.0;
+const double kSecondsInHour = 3600.0;
+
+template <typename Value>
+double quarterMedian(const std::vector<framework::SoakMonitor::Window>& windows, bool last, Value value)
+{
+    std::size_t count = std::max<std::size_t>(windows.size() / 4u, 1u);
+    std::size_t first = last ? windows.size() - count : 0u;
+
+    std::vector<double> values;
+    for (std::size_t index = first; index < first + count; ++index) {
+        values.push_back(value(windows[index]));
+    }
+    std::sort(values.begin(), values.end());
+
+    std::size_t middle = values.size() / 2u;
+    return (values.size() % 2u == 1u) ? values[middle] : 0.5 * (values[middle - 1u] + values[middle]);
+}
+
+std::string formatMs(double seconds)
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.3fms", seconds * 1000.0);
+    return buffer;
+}
+}
+
+namespace framework {
+SoakMonitor::SoakMonitor(double windowLength)
+    : _windowLength(windowLength)
+    , _startTime(0.0)
+    , _windowStart(0.0)
+    , _frameTimes(kHistogramLowestFrameTime, kHistogramHighestFrameTime, kHistogramSubBuckets)
+    , _windows()
+{
+}
+
+bool SoakMonitor::enabled() const
+{
+    return _windowLength > 0.0;
+}
+
+void SoakMonitor::reset(double now)
+{
+    _startTime = now;
+    _windowStart = now;
+    _frameTimes.reset();
+    _windows.clear();
+}
+
+void SoakMonitor::addFrame(double frameTime, double now)
+{
+    _frameTimes.record(frameTime);
+    if (now - _windowStart >= _windowLength) {
+        closeWindow(now);
+    }
+}
+
+void SoakMonitor::finish(double now)
+{
+    if (_frameTimes.count() > 0u && now - _windowStart >= 0.5 * _windowLength) {
+        closeWindow(now);
+    }
+}
+
+const std::vector<SoakMonitor::Window>& SoakMonitor::windows() const
+{
+    return _windows;
+}
+
+SoakMonitor::Drift SoakMonitor::drift() const
+{
+    Drift drift{};
+    if (_windows.size() < kMinDriftWindows)
+        return drift;
+
+    drift.valid = true;
+
+    auto medianFrameTime = [](const Window& window) { return window.medianFrameTime; };
+    double firstFrameTime = quarterMedian(_windows, false, medianFrameTime);
+    double lastFrameTime = quarterMedian(_windows, true, medianFrameTime);
+    drift.frameTimeChange = (firstFrameTime > 0.0) ? lastFrameTime / firstFrameTime - 1.0 : 0.0;
+    drift.frameTimeCreep = drift.frameTimeChange > kFrameTimeCreepThreshold;
+
+    // Rate is taken between centers of the quarters
+    auto residentBytes = [](const Window& window) { return static_cast<double>(window.residentBytes); };
+    auto startTime = [](const Window& window) { return window.startTime + 0.5 * window.length; };
+    double firstResident = quarterMedian(_windows, false, residentBytes);
+    double elapsed = quarterMedian(_windows, true, startTime) - quarterMedian(_windows, false, startTime);
+    drift.memoryGrowth = quarterMedian(_windows, true, residentBytes) - firstResident;
+    drift.memoryGrowthRate = (elapsed > 0.0) ? drift.memoryGrowth * kSecondsInHour / elapsed : 0.0;
+    drift.memoryGrowing = firstResident > 0.0 && drift.memoryGrowth > kMemoryGrowthMinBytes &&
+                          drift.memoryGrowth > kMemoryGrowthThreshold * firstResident;
+
+    // Sensors are either available for the whole run or not at all
+    drift.hasCpuFrequency = _windows.front().hasCpuFrequency && _windows.back().hasCpuFrequency;
+    if (drift.hasCpuFrequency) {
+        auto cpuFrequency = [](const Window& window) { return window.cpuFrequency; };
+        drift.firstCpuFrequency = quarterMedian(_windows, false, cpuFrequency);
+        drift.lastCpuFrequency = quarterMedian(_windows, true, cpuFrequency);
+        drift.throttling = drift.lastCpuFrequency < (1.0 - kThrottlingThreshold) * drift.firstCpuFrequency;
+    }
+
+    drift.hasTemperature = _windows.front().hasTemperature && _windows.back().hasTemperature;
+    if (drift.hasTemperature) {
+        auto temperature = [](const Window& window) { return window.temperature; };
+        drift.firstTemperature = quarterMedian(_windows, false, temperature);
+        drift.lastTemperature = quarterMedian(_windows, true, temperature);
+    }
+
+    return drift;
+}
+
+void SoakMonitor::print(std::ostream& stream) const
+{
+    char buffer[160];
+    std::snprintf(buffer, sizeof(buffer), "Soak statistics (%.0fs windows)", _windowLength);
+    std::string title = buffer;
+
+    stream << title << std::endl;
+    stream << std::string(title.size(), '=') << std::endl;
+
+    // Long runs have too many windows to print, every n-th one and the last one are shown
+    std::size_t step = std::max<std::size_t>((_windows.size() + kMaxPrintedWindows - 1u) / kMaxPrintedWindows, 1u);
+    stream << "      Time   Frames     Average         p50         p99         Max   CPU MHz    Temp       RSS"
+           << std::endl;
+    for (std::size_t index = 0; index < _windows.size(); ++index) {
+        if (index % step != 0u && index + 1u != _windows.size())
+            continue;
+
+        const Window& window = _windows[index];
+        char frequency[16] = "---";
+        char temperature[16] = "---";
+        if (window.hasCpuFrequency) {
+            std::snprintf(frequency, sizeof(frequency), "%.0f", window.cpuFrequency);
+        }
+        if (window.hasTemperature) {
+            std::snprintf(temperature, sizeof(temperature), "%.1fC", window.temperature);
+        }
+        std::snprintf(buffer, sizeof(buffer), "  %7.0fs %8zu %11s %11s %11s %11s %9s %7s %6.1fMiB", window.startTime,
+                      window.frames, formatMs(window.averageFrameTime).c_str(),
+                      formatMs(window.medianFrameTime).c_str(), formatMs(window.p99FrameTime).c_str(),
+                      formatMs(window.maxFrameTime).c_str(), frequency, temperature,
+                      static_cast<double>(window.residentBytes) / kBytesInMiB);
+        stream << buffer << std::endl;
+    }
+
+    Drift drift = this->drift();
+    if (!drift.valid) {
+        stream << "  Drift: not enough windows, at least " << kMinDriftWindows << " are needed" << std::endl;
+        return;
+    }
+
+    std::snprintf(buffer, sizeof(buffer), "%+.1f%%", drift.frameTimeChange * 100.0);
+    stream << "  Frame time drift: " << buffer << " of median frame time (first to last quarter of windows)"
+           << (drift.frameTimeCreep ? " - FRAME TIME CREEP" : "") << std::endl;
+
+    std::snprintf(buffer, sizeof(buffer), "%+.1fMiB (%+.1fMiB per hour)", drift.memoryGrowth / kBytesInMiB,
+                  drift.memoryGrowthRate / kBytesInMiB);
+    stream << "  Resident set drift: " << buffer << (drift.memoryGrowing ? " - MEMORY GROWTH" : "") << std::endl;
+
+    if (drift.hasCpuFrequency) {
+        std::snprintf(buffer, sizeof(buffer), "%.0fMHz to %.0fMHz", drift.firstCpuFrequency, drift.lastCpuFrequency);
+        stream << "  CPU frequency: " << buffer;
+        if (drift.hasTemperature) {
+            std::snprintf(buffer, sizeof(buffer), "%.1fC to %.1fC", drift.firstTemperature, drift.lastTemperature);
+            stream << ", temperature " << buffer;
+        }
+        stream << (drift.throttling ? " - THROTTLING" : "") << std::endl;
+    } else {
+        stream << "  CPU frequency: not available, throttling can't be detected" << std::endl;
+    }
+}
+
+void SoakMonitor::exportResults(BenchmarkResult& result) const
+{
+    result.set("soak", "windowLength", _windowLength);
+    result.set("soak", "windows", static_cast<double>(_windows.size()));
+
+    Drift drift = this->drift();
+    if (!drift.valid)
+        return;
+
+    result.set("soak", "frameTimeChangePercent", drift.frameTimeChange * 100.0);
+    result.set("soak", "frameTimeCreep", drift.frameTimeCreep ? 1.0 : 0.0);
+    result.set("soak", "memoryGrowthMiB", drift.memoryGrowth / kBytesInMiB);
+    result.set("soak", "memoryGrowthMiBPerHour", drift.memoryGrowthRate / kBytesInMiB);
+    result.set("soak", "memoryGrowing", drift.memoryGrowing ? 1.0 : 0.0);
+    if (drift.hasCpuFrequency) {
+        result.set("soak", "firstCpuFrequencyMHz", drift.firstCpuFrequency);
+        result.set("soak", "lastCpuFrequencyMHz", drift.lastCpuFrequency);
+    }
+    if (drift.hasTemperature) {
+        result.set("soak", "firstTemperatureC", drift.firstTemperature);
+        result.set("soak", "lastTemperatureC", drift.lastTemperature);
+    }
+    result.set("soak", "throttling", drift.throttling ? 1.0 : 0.0);
+}
+
+void SoakMonitor::closeWindow(double now)
+{
+    Window window{};
+    window.startTime = _windowStart - _startTime;
+    window.length = now - _windowStart;
+    window.frames = _frameTimes.count();
+    window.averageFrameTime = _frameTimes.mean();
+    window.medianFrameTime = _frameTimes.percentile(50.0);
+    window.p99FrameTime = _frameTimes.percentile(99.0);
+    window.maxFrameTime = _frameTimes.max();
+    window.hasCpuFrequency = base::SystemSensors::cpuFrequency(window.cpuFrequency);
+    window.hasTemperature = base::SystemSensors::temperature(window.temperature);
+    window.residentBytes = base::MemoryStats::residentBytes();
+    _windows.push_back(window);
+
+    _frameTimes.reset();
+    _windowStart = now;
+}
+}
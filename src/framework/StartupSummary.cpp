@@ -0,0 +1,106 @@
+#include <framework/StartupSummary.h>
+
+#include <algorithm>
+#include <cstdio>
+
+namespace {
+const std::string kStartupSection = "startup";
+const std::string kTimeSuffix = "Ms";
+const std::string kSetupKey = "setup";
+
+std::string formatMs(double value)
+{
+    if (value < 0.0)
+        return "---";
+
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.3fms", value);
+    return buffer;
+}
+}
+
+namespace framework {
+StartupSummary::StartupSummary(const std::string& label)
+    : _label(label)
+    , _runs(0u)
+    , _phases()
+{
+}
+
+void StartupSummary::addRun(const BenchmarkResult& result)
+{
+    if (!result.has(kStartupSection, kSetupKey + kTimeSuffix))
+        return;
+
+    for (const BenchmarkResult::Field& field : result.fields()) {
+        if (field.section != kStartupSection || !field.isNumber || field.key.size() <= kTimeSuffix.size())
+            continue;
+
+        std::string key = field.key.substr(0, field.key.size() - kTimeSuffix.size());
+        auto phase = std::find_if(_phases.begin(), _phases.end(),
+                                  [&key](const Phase& candidate) { return candidate.key == key; });
+        if (phase == _phases.end()) {
+            _phases.push_back(Phase{key, std::vector<double>(_runs, -1.0)});
+            phase = _phases.end() - 1;
+        }
+        phase->times.push_back(field.number);
+    }
+
+    // Phases missing in this run (e.g. pipeline creation without cache after the cache was saved)
+    ++_runs;
+    for (Phase& phase : _phases) {
+        phase.times.resize(_runs, -1.0);
+    }
+}
+
+std::size_t StartupSummary::runs() const
+{
+    return _runs;
+}
+
+void StartupSummary::print(std::ostream& stream) const
+{
+    std::string title = "Startup phases (" + _label + ")";
+
+    stream << title << std::endl;
+    stream << std::string(title.size(), '=') << std::endl;
+
+    char buffer[160];
+    std::snprintf(buffer, sizeof(buffer), "  %-20s %12s %12s %12s %12s", "Phase", "Cold", "Warm median",
+                  "Warm min", "Warm max");
+    stream << buffer << std::endl;
+
+    auto printPhase = [&stream, &buffer](const Phase& phase) {
+        std::vector<double> warm;
+        for (std::size_t run = 1u; run < phase.times.size(); ++run) {
+            if (phase.times[run] >= 0.0)
+                warm.push_back(phase.times[run]);
+        }
+        std::sort(warm.begin(), warm.end());
+
+        double median = -1.0;
+        if (!warm.empty()) {
+            std::size_t middle = warm.size() / 2u;
+            median = (warm.size() % 2u == 1u) ? warm[middle] : 0.5 * (warm[middle - 1u] + warm[middle]);
+        }
+
+        std::snprintf(buffer, sizeof(buffer), "  %-20s %12s %12s %12s %12s", phase.key.c_str(),
+                      formatMs(phase.times.front()).c_str(), formatMs(median).c_str(),
+                      formatMs(warm.empty() ? -1.0 : warm.front()).c_str(),
+                      formatMs(warm.empty() ? -1.0 : warm.back()).c_str());
+        stream << buffer << std::endl;
+    };
+
+    // Whole setup goes after the phases it consists of, which may differ between runs
+    for (const Phase& phase : _phases) {
+        if (phase.key != kSetupKey)
+            printPhase(phase);
+    }
+    for (const Phase& phase : _phases) {
+        if (phase.key == kSetupKey)
+            printPhase(phase);
+    }
+    stream << "  Warm runs: " << (_runs - 1u) << std::endl;
+    stream << std::endl;
+}
+}
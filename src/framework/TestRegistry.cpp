@@ -0,0 +1,133 @@
+#include <framework/TestRegistry.h>
+#include <tests/test1/BallsSceneTests.h>
+#include <tests/test2/TerrainSceneTests.h>
+#include <tests/test3/ShadowMappingSceneTests.h>
+#include <tests/test4/InitializationTests.h>
+#include <tests/test5/ApiCallTests.h>
+
+#include <algorithm>
+#include <stdexcept>
+
+namespace {
+template <typename T>
+framework::TestRegistry::Factory factoryOf()
+{
+    return [](const framework::TestConfiguration& configuration) {
+        return std::unique_ptr<framework::BenchmarkableTest>(new T(configuration));
+    };
+}
+}
+
+namespace framework {
+TestRegistry TestRegistry::createDefault()
+{
+    // Terrain chunks have a fixed size, so test #2 takes only `-scale` (of its LoD factor)
+    const unsigned int sceneSize = SceneScale | SceneDetail;
+
+    TestRegistry registry;
+
+    // Test #1 - static scene
+    registry.add(1, "gl", false, factoryOf<tests::test_gl::SimpleBallsSceneTest>(), sceneSize);
+    registry.add(1, "gl", true, factoryOf<tests::test_gl::MultithreadedBallsSceneTest>(), sceneSize);
+    registry.add(1, "vk", false, factoryOf<tests::test_vk::SimpleBallsSceneTest>(), sceneSize | Pipelining);
+    registry.add(1, "vk", true, factoryOf<tests::test_vk::MultithreadedBallsSceneTest>(), sceneSize | Pipelining);
+    registry.add(1, "null", false, factoryOf<tests::test_null::SimpleBallsSceneTest>(), sceneSize);
+
+    // Test #2 - terrain with dynamic LoD
+    registry.add(2, "gl", false, factoryOf<tests::test_gl::TerrainSceneTest>(), SceneScale);
+    registry.add(2, "gl", true, factoryOf<tests::test_gl::MultithreadedTerrainSceneTest>(), SceneScale);
+    registry.add(2, "vk", false, factoryOf<tests::test_vk::TerrainSceneTest>(), SceneScale);
+    registry.add(2, "vk", true, factoryOf<tests::test_vk::MultithreadedTerrainSceneTest>(), SceneScale);
+    registry.add(2, "null", false, factoryOf<tests::test_null::TerrainSceneTest>(), SceneScale);
+
+    // Test #3 - shadow mapping
+    registry.add(3, "gl", false, factoryOf<tests::test_gl::ShadowMappingSceneTest>(), sceneSize);
+    registry.add(3, "gl", true, factoryOf<tests::test_gl::MultithreadedShadowMappingSceneTest>(), sceneSize);
+    registry.add(3, "vk", false, factoryOf<tests::test_vk::ShadowMappingSceneTest>(), sceneSize);
+    registry.add(3, "vk", true, factoryOf<tests::test_vk::MultithreadedShadowMappingSceneTest>(), sceneSize);
+    registry.add(3, "null", false, factoryOf<tests::test_null::ShadowMappingSceneTest>(), sceneSize);
+
+    // Test #4 - initialization (always in benchmark mode)
+    registry.add(4, "gl", false, factoryOf<tests::test_gl::InitializationTest>());
+    registry.add(4, "vk", false, factoryOf<tests::test_vk::InitializationTest>());
+
+    // Test #5 - API call overhead (always in benchmark mode)
+    registry.add(5, "gl", false, factoryOf<tests::test_gl::ApiCallTest>());
+    registry.add(5, "vk", false, factoryOf<tests::test_vk::ApiCallTest>());
+
+    return registry;
+}
+
+void TestRegistry::add(int testNumber, const std::string& api, bool multithreaded, Factory factory,
+                       unsigned int features)
+{
+    if (find(testNumber, api, multithreaded)) {
+        throw std::logic_error("TestRegistry - test " + std::to_string(testNumber) + " (" + api + ") registered twice");
+    }
+
+    _entries.push_back(Entry{testNumber, api, multithreaded, std::move(factory), features});
+}
+
+bool TestRegistry::contains(int testNumber, const std::string& api, bool multithreaded) const
+{
+    return (find(testNumber, api, multithreaded) != nullptr);
+}
+
+bool TestRegistry::supports(int testNumber, const std::string& api, bool multithreaded, Feature feature) const
+{
+    const Entry* entry = find(testNumber, api, multithreaded);
+    return entry && (entry->features & feature) != 0u;
+}
+
+bool TestRegistry::containsTest(int testNumber) const
+{
+    return std::any_of(_entries.begin(), _entries.end(),
+                       [testNumber](const Entry& entry) { return entry.testNumber == testNumber; });
+}
+
+bool TestRegistry::containsApi(const std::string& api) const
+{
+    return std::any_of(_entries.begin(), _entries.end(), [&api](const Entry& entry) { return entry.api == api; });
+}
+
+std::vector<std::string> TestRegistry::apis() const
+{
+    std::vector<std::string> result;
+    for (const Entry& entry : _entries) {
+        if (std::find(result.begin(), result.end(), entry.api) == result.end()) {
+            result.push_back(entry.api);
+        }
+    }
+    return result;
+}
+
+int TestRegistry::maxTestNumber() const
+{
+    int result = 0;
+    for (const Entry& entry : _entries) {
+        result = std::max(result, entry.testNumber);
+    }
+    return result;
+}
+
+std::unique_ptr<BenchmarkableTest> TestRegistry::create(const TestConfiguration& configuration) const
+{
+    const Entry* entry = find(configuration.testNumber, configuration.api, configuration.multithreaded);
+    if (!entry) {
+        return nullptr;
+    }
+
+    return entry->factory(configuration);
+}
+
+const TestRegistry::Entry* TestRegistry::find(int testNumber, const std::string& api, bool multithreaded) const
+{
+    for (const Entry& entry : _entries) {
+        if (entry.testNumber == testNumber && entry.api == api && entry.multithreaded == multithreaded) {
+            return &entry;
+        }
+    }
+
+    return nullptr;
+}
+}
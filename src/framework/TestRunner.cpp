@@ -1,186 +1,384 @@
-#include <base/gl/Window.h>
+#include <base/File.h>
+#include <base/Profiler.h>
+#include <base/Random.h>
+#include <base/StartupPhases.h>
+#include <base/String.h>
+#include <framework/Baseline.h>
+#include <framework/Comparison.h>
+#include <framework/CostModel.h>
+#include <framework/StartupSummary.h>
 #include <framework/TestRunner.h>
-#include <tests/test1/BallsSceneTests.h>
-#include <tests/test2/TerrainSceneTests.h>
-#include <tests/test3/ShadowMappingSceneTests.h>
-#include <tests/test4/InitializationTests.h>
+#include <framework/ThreadScaling.h>
 
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <ctime>
+#include <fstream>
 #include <iostream>
+#include <memory>
 #include <stdexcept>
+#include <thread>
 
 namespace {
 const float kDefaultTestBenchmarkTime = 15.0f; // 15 seconds
+const double kDefaultSuiteCooldownTime = 0.0;  // no cooldown between runs
+const std::size_t kDefaultComparisonRepetitions = 5u;
+const double kDefaultBaselineTolerance = 10.0; // percent
+const int kRegressionExitCode = 2;             // distinguishes regressions from failed runs (-1)
+const uint32_t kDefaultDeterministicSeed = 5489u; // default seed of std::mt19937
+const float kDefaultSoakWindow = 10.0f;        // seconds
+
+double medianAverageFrameTime(const std::vector<framework::BenchmarkResult>& results)
+{
+    std::vector<double> values;
+    for (const framework::BenchmarkResult& result : results) {
+        if (result.has("stats", "avgFrameTimeMs")) {
+            values.push_back(result.number("stats", "avgFrameTimeMs"));
+        }
+    }
+
+    if (values.empty())
+        return 0.0;
+
+    std::sort(values.begin(), values.end());
+    std::size_t middle = values.size() / 2u;
+    return (values.size() % 2u == 1u) ? values[middle] : 0.5 * (values[middle - 1u] + values[middle]);
+}
+
+// Comma-separated list of scene size multipliers, default scene if argument isn't given
+std::vector<float> parseSceneSizes(const base::ArgumentParser& args, const std::string& name)
+{
+    if (!args.hasArgument(name))
+        return {1.0f};
+
+    std::vector<float> result;
+    for (const std::string& token : base::String::split(args.getArgument(name), ',')) {
+        float value = 0.0f;
+        try {
+            value = std::stof(token);
+        } catch (...) {
+            // ignore, will fail with proper message later
+        }
+
+        if (!(value > 0.0f))
+            throw std::invalid_argument("Invalid `-" + name + "` value!");
+        result.push_back(value);
+    }
+
+    if (result.empty())
+        throw std::invalid_argument("Invalid `-" + name + "` value!");
+    return result;
+}
+
+std::string formatSceneSize(float value)
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%g", value);
+    return buffer;
+}
 }
 
 namespace framework {
 TestRunner::TestRunner(base::ArgumentParser argumentParser)
     : arguments(std::move(argumentParser))
+    , registry(TestRegistry::createDefault())
+    , compareMode(false)
 {
 }
 
 int TestRunner::run()
 {
-    const int TESTS = 4;
-
     auto errorCallback = [&](const std::string& msg) -> int {
         std::cerr << "Invalid usage! " << msg << std::endl;
-        std::cerr << "Usage: `" << arguments.getPath() << " -t N -api API [-m] [-benchmark] [-time T]`" << std::endl;
-        std::cerr << "  -t N        - test number (in range [1, " << TESTS << "])" << std::endl;
-        std::cerr << "  -api API    - API (`gl` or `vk`)" << std::endl;
+        std::cerr << "Usage: `" << arguments.getPath() << " -t N -api API [-m] [-benchmark] [-time T] [-offscreen]`"
+                  << std::endl;
+        std::cerr << "  -t N        - test number (in range [1, " << registry.maxTestNumber() << "])" << std::endl;
+        std::cerr << "  -api API    - API (`gl`, `vk` or `null`)" << std::endl;
         std::cerr << "  -m          - run multithreaded version (if exists)" << std::endl;
+        std::cerr << "  -threads N  - number of worker threads of multithreaded version" << std::endl;
+        std::cerr << "                default value is number of hardware threads" << std::endl;
         std::cerr << "  -benchmark  - run in benchmark mode" << std::endl;
         std::cerr << "  -time T     - change benchmark duraton to T seconds" << std::endl;
         std::cerr << "                default value is 15 seconds" << std::endl;
+        std::cerr << "  -frames N   - measure exactly N frames (after fixed warm-up) instead of time" << std::endl;
+        std::cerr << "  -soak [W]   - soak mode, statistics of every W seconds and drift detection (needs -benchmark)"
+                  << std::endl;
+        std::cerr << "                default window is " << kDefaultSoakWindow << " seconds, use with long `-time`"
+                  << std::endl;
+        std::cerr << "  -offscreen  - render to offscreen images instead of a window (no presentation)" << std::endl;
+        std::cerr << "  -pipeline   - update scene of the next frame while the current one is recorded" << std::endl;
+        std::cerr << "  -inflight N - number of frames in flight (Vulkan)" << std::endl;
+        std::cerr << "                default value is number of swapchain images" << std::endl;
+        std::cerr << "  -scale S    - multiply number of objects in the scene by S" << std::endl;
+        std::cerr << "  -detail D   - multiply geometric detail of objects (vertices per object) by D" << std::endl;
+        std::cerr << "  -output F   - append machine-readable results of the run to file F" << std::endl;
+        std::cerr << "  -format FMT - results format (`json` or `csv`)" << std::endl;
+        std::cerr << "                default value is taken from file extension, `json` otherwise" << std::endl;
+        std::cerr << "  -trace F    - write Chrome trace of CPU profiler zones to file F" << std::endl;
+        std::cerr << "                (needs build with ENABLE_TIMINGS)" << std::endl;
+        std::cerr << "  -deterministic [S] - fixed simulation time step and scenes generated from seed S" << std::endl;
+        std::cerr << "                default seed is " << kDefaultDeterministicSeed
+                  << ", frame N then renders the same scene in every run and API" << std::endl;
+        std::cerr << std::endl;
+        std::cerr << "Suite mode (runs many configurations in one invocation):" << std::endl;
+        std::cerr << "  -t N,N...   - comma-separated list of test numbers" << std::endl;
+        std::cerr << "  -api A,A... - comma-separated list of APIs" << std::endl;
+        std::cerr << "  -m on,off   - run multithreaded and/or singlethreaded versions" << std::endl;
+        std::cerr << "  -suite F    - read configurations from file F (one set of arguments per line)" << std::endl;
+        std::cerr << "  -repeat N   - run whole suite N times (interleaved)" << std::endl;
+        std::cerr << "  -threadsweep [N] - run multithreaded versions with 1..N worker threads (needs -benchmark)"
+                  << std::endl;
+        std::cerr << "                default N is number of hardware threads, scaling model is fitted at the end"
+                  << std::endl;
+        std::cerr << "  -scale S,S... / -detail D,D... - run every configuration with each scene size" << std::endl;
+        std::cerr << "                (needs -benchmark), cost per draw call and per vertex is fitted at the end"
+                  << std::endl;
+        std::cerr << "  -cooldown S - wait S seconds between consecutive runs" << std::endl;
+        std::cerr << "  -compare    - statistical A/B comparison of exactly two configurations (needs -benchmark)"
+                  << std::endl;
+        std::cerr << "                runs are interleaved, `-repeat` defaults to 5 runs of each" << std::endl;
+        std::cerr << std::endl;
+        std::cerr << "Regression checking (needs -benchmark):" << std::endl;
+        std::cerr << "  -baseline F  - compare results with baseline results file F (JSON written by -output)"
+                  << std::endl;
+        std::cerr << "                 exits with code " << kRegressionExitCode << " if any configuration regressed"
+                  << std::endl;
+        std::cerr << "  -tolerance P - allowed slowdown against baseline in percent (default 10)" << std::endl;
         return -1;
     };
 
-    if (!arguments.hasArgument("t"))
-        return errorCallback("Missing `-t` argument!");
-
-    if (!arguments.hasArgument("api"))
-        return errorCallback("Missing `-api` argument!");
-
-    int testNum = -1;
+    std::vector<TestConfiguration> configurations;
     try {
-        testNum = arguments.getIntArgument("t");
-    } catch (...) {
-        // ignore, will fail with proper message later
+        if (arguments.hasArgument("suite")) {
+            configurations = readSuite(arguments.getArgument("suite"));
+        } else {
+            configurations = expandConfigurations(arguments);
+        }
+    } catch (const std::invalid_argument& exception) {
+        return errorCallback(exception.what());
     }
 
-    if (testNum < 1 || testNum > TESTS)
-        return errorCallback("Invalid test number!");
+    if (configurations.empty())
+        return errorCallback("No available test configuration selected!");
 
-    std::string api = arguments.getArgument("api");
-    if (api != "gl" && api != "vk")
-        return errorCallback("Invalid `-api` value!");
+    compareMode = arguments.hasArgument("compare");
+    if (compareMode) {
+        if (configurations.size() != 2u)
+            return errorCallback("`-compare` needs exactly two configurations!");
 
-    bool multithreaded = arguments.hasArgument("m");
-    bool benchmarkMode = arguments.hasArgument("benchmark");
-    float benchmarkTime = kDefaultTestBenchmarkTime;
+        if (!configurations[0].benchmarkMode || !configurations[1].benchmarkMode)
+            return errorCallback("`-compare` needs `-benchmark`!");
+    }
 
-    if (benchmarkMode && arguments.hasArgument("time")) {
+    std::size_t repetitions = compareMode ? kDefaultComparisonRepetitions : 1u;
+    if (arguments.hasArgument("repeat")) {
+        int value = 0;
         try {
-            benchmarkTime = arguments.getFloatArgument("time");
+            value = arguments.getIntArgument("repeat");
         } catch (...) {
-            std::cerr << "Invalid value for argument '-time'!";
+            // ignore, will fail with proper message later
         }
+
+        if (value < 1)
+            return errorCallback("Invalid `-repeat` value!");
+        repetitions = static_cast<std::size_t>(value);
+
+        if (compareMode && repetitions < 2u)
+            return errorCallback("`-compare` needs at least 2 repetitions!");
     }
 
-    auto testStartTime = BenchmarkableTest::getCurrentTime();
-    if (api == "gl") {
-        return run_gl(testNum, multithreaded, benchmarkMode, benchmarkTime, testStartTime);
-    } else {
-        return run_vk(testNum, multithreaded, benchmarkMode, benchmarkTime, testStartTime);
+    double cooldown = kDefaultSuiteCooldownTime;
+    if (arguments.hasArgument("cooldown")) {
+        try {
+            cooldown = arguments.getFloatArgument("cooldown");
+        } catch (...) {
+            return errorCallback("Invalid `-cooldown` value!");
+        }
     }
-}
 
-int TestRunner::run_gl(int testNumber, bool multithreaded, bool benchmarkMode, float benchmarkTime, double testStartTime)
-{
-    std::unique_ptr<BenchmarkableTest> test;
+    if (arguments.hasArgument("output")) {
+        outputPath = arguments.getArgument("output");
+        if (outputPath.empty())
+            return errorCallback("Missing value for `-output` argument!");
 
-    switch (testNumber) {
-    case 1:
-        if (multithreaded) {
-            test = std::unique_ptr<BenchmarkableTest>(
-                new tests::test_gl::MultithreadedBallsSceneTest(benchmarkMode, benchmarkTime));
+        if (arguments.hasArgument("format")) {
+            outputFormat = arguments.getArgument("format");
         } else {
-            test = std::unique_ptr<BenchmarkableTest>(
-                new tests::test_gl::SimpleBallsSceneTest(benchmarkMode, benchmarkTime));
+            outputFormat = (base::File::getExtension(outputPath) == "csv") ? "csv" : "json";
         }
-        break;
 
-    case 2:
-        if (multithreaded) {
-            // N/A
-        } else {
-            test =
-                std::unique_ptr<BenchmarkableTest>(new tests::test_gl::TerrainSceneTest(benchmarkMode, benchmarkTime));
+        if (outputFormat != "json" && outputFormat != "csv")
+            return errorCallback("Invalid `-format` value!");
+    }
+
+    std::unique_ptr<Baseline> baseline;
+    double tolerance = kDefaultBaselineTolerance;
+    if (arguments.hasArgument("baseline")) {
+        for (const TestConfiguration& configuration : configurations) {
+            if (!configuration.benchmarkMode)
+                return errorCallback("`-baseline` needs `-benchmark`!");
         }
-        break;
 
-    case 3:
-        if (multithreaded) {
-            // N/A
-        } else {
-            test = std::unique_ptr<BenchmarkableTest>(
-                new tests::test_gl::ShadowMappingSceneTest(benchmarkMode, benchmarkTime));
+        try {
+            baseline.reset(new Baseline(Baseline::load(arguments.getArgument("baseline"))));
+        } catch (const std::invalid_argument& exception) {
+            return errorCallback(exception.what());
         }
-        break;
-    case 4:
-        if (multithreaded) {
-            // N/A
-        } else {
-            test = std::unique_ptr<BenchmarkableTest>(new tests::test_gl::InitializationTest());
+
+        if (arguments.hasArgument("tolerance")) {
+            try {
+                tolerance = arguments.getFloatArgument("tolerance");
+            } catch (...) {
+                tolerance = -1.0;
+            }
+
+            if (tolerance < 0.0)
+                return errorCallback("Invalid `-tolerance` value!");
         }
     }
 
-    if (test) {
-        return run_any(std::move(test), testStartTime);
-    } else {
-        std::cerr << "Unknown " << (multithreaded ? "multithreaded" : "") << " OpenGL test: " << testNumber
-                  << std::endl;
-        return -1;
+    if (arguments.hasArgument("trace")) {
+        tracePath = arguments.getArgument("trace");
+        if (tracePath.empty())
+            return errorCallback("Missing value for `-trace` argument!");
+
+#ifndef ENABLE_TIMINGS
+        std::cerr << "Warning: built without ENABLE_TIMINGS, trace will contain no profiler zones" << std::endl;
+#endif
+        base::Profiler::setTracing(true);
     }
-}
 
-int TestRunner::run_vk(int testNumber, bool multithreaded, bool benchmarkMode, float benchmarkTime, double testStartTime)
-{
-    std::unique_ptr<BenchmarkableTest> test;
+    // Successful runs of each configuration
+    std::vector<std::vector<BenchmarkResult>> results(configurations.size());
 
-    switch (testNumber) {
-    case 1:
-        if (multithreaded) {
-            test = std::unique_ptr<BenchmarkableTest>(
-                new tests::test_vk::MultithreadedBallsSceneTest(benchmarkMode, benchmarkTime));
-        } else {
-            test = std::unique_ptr<BenchmarkableTest>(
-                new tests::test_vk::SimpleBallsSceneTest(benchmarkMode, benchmarkTime));
+    int result = 0;
+    if (configurations.size() == 1u && repetitions == 1u) {
+        BenchmarkResult runResult;
+        result = run_configuration(configurations.front(), runResult);
+        if (result == 0) {
+            results.front().push_back(runResult);
         }
-        break;
+    } else {
+        result = run_suite(configurations, repetitions, cooldown, results);
+    }
 
-    case 2:
-        if (multithreaded) {
-            test = std::unique_ptr<BenchmarkableTest>(
-                new tests::test_vk::MultithreadedTerrainSceneTest(benchmarkMode, benchmarkTime));
-        } else {
-            test =
-                std::unique_ptr<BenchmarkableTest>(new tests::test_vk::TerrainSceneTest(benchmarkMode, benchmarkTime));
+    if (compareMode) {
+        Comparison comparison(comparisonLabel(configurations[0], configurations[1]),
+                              comparisonLabel(configurations[1], configurations[0]));
+        for (std::size_t index = 0; index < configurations.size(); ++index) {
+            for (const BenchmarkResult& runResult : results[index]) {
+                comparison.addRun(index == 1u, runResult);
+            }
         }
-        break;
 
-    case 3:
-        if (multithreaded) {
-            test = std::unique_ptr<BenchmarkableTest>(
-                new tests::test_vk::MultithreadedShadowMappingSceneTest(benchmarkMode, benchmarkTime));
-        } else {
-            test = std::unique_ptr<BenchmarkableTest>(
-                new tests::test_vk::ShadowMappingSceneTest(benchmarkMode, benchmarkTime));
+        std::cout << std::endl;
+        comparison.print(std::cout);
+    }
+
+    printMultithreadingSpeedup(configurations, results);
+    printThreadScaling(configurations, results);
+    printCostModels(configurations, results);
+    printStartupSummaries(configurations, results);
+
+    if (baseline) {
+        std::vector<BenchmarkResult> allResults;
+        for (const auto& configurationResults : results) {
+            allResults.insert(allResults.end(), configurationResults.begin(), configurationResults.end());
         }
-        break;
-    case 4:
-        if (multithreaded) {
-            // N/A
-        } else {
-            test = std::unique_ptr<BenchmarkableTest>(new tests::test_vk::InitializationTest());
+
+        std::cout << std::endl;
+        if (!baseline->check(allResults, tolerance / 100.0, std::cout) && result == 0) {
+            result = kRegressionExitCode;
         }
     }
 
+    // All runs are stored in a single trace, each as a separate process
+    if (!tracePath.empty() && !base::Profiler::writeChromeTrace(tracePath)) {
+        std::cerr << "Couldn't write trace file: " << tracePath << std::endl;
+        result = -1;
+    }
+
+    return result;
+}
+
+int TestRunner::run_suite(const std::vector<TestConfiguration>& configurations,
+                          std::size_t repetitions,
+                          double cooldown,
+                          std::vector<std::vector<BenchmarkResult>>& results)
+{
+    std::size_t totalRuns = configurations.size() * repetitions;
+    std::size_t finishedRuns = 0u;
+    std::size_t failedRuns = 0u;
+
+    // Repetitions are interleaved, so slow drifts (e.g. thermal throttling) affect all configurations equally
+    for (std::size_t repetition = 0; repetition < repetitions; ++repetition) {
+        for (std::size_t index = 0; index < configurations.size(); ++index) {
+            TestConfiguration configuration = configurations[index];
+            configuration.repetition = repetition;
+
+            if (finishedRuns > 0u && cooldown > 0.0) {
+                std::this_thread::sleep_for(std::chrono::duration<double>(cooldown));
+            }
+
+            std::cout << "Suite run " << (finishedRuns + 1u) << "/" << totalRuns << ": "
+                      << describeConfiguration(configuration) << std::endl;
+            std::cout << std::endl;
+
+            BenchmarkResult result;
+            if (run_configuration(configuration, result) != 0) {
+                ++failedRuns;
+            } else {
+                results[index].push_back(result);
+            }
+            ++finishedRuns;
+
+            std::cout << std::endl;
+        }
+    }
+
+    std::cout << "Suite finished: " << (finishedRuns - failedRuns) << "/" << finishedRuns << " runs succeeded"
+              << std::endl;
+
+    return (failedRuns == 0u) ? 0 : -1;
+}
+
+int TestRunner::run_configuration(const TestConfiguration& configuration, BenchmarkResult& result)
+{
+    // Scenes are generated during test construction and setup, so every run starts from the same state
+    if (configuration.deterministic) {
+        base::random::getDefaultGenerator().seed(configuration.seed);
+    }
+
+    base::StartupPhases::reset();
+    auto testStartTime = BenchmarkableTest::getCurrentTime();
+    std::unique_ptr<BenchmarkableTest> test = registry.create(configuration);
+
     if (test) {
-        return run_any(std::move(test), testStartTime);
+        base::Profiler::beginSession(describeConfiguration(configuration));
+        result = describeRun(configuration);
+        int status = run_any(std::move(test), testStartTime, result);
+        base::Profiler::endSession();
+        base::Profiler::printStatistics(std::cout);
+
+        return status;
     } else {
-        std::cerr << "Unknown " << (multithreaded ? "multithreaded" : "") << " Vulkan test: " << testNumber
-                  << std::endl;
+        std::cerr << "Unknown " << (configuration.multithreaded ? "multithreaded " : "") << "`" << configuration.api
+                  << "` test: " << configuration.testNumber << std::endl;
         return -1;
     }
 }
 
-int TestRunner::run_any(std::unique_ptr<BenchmarkableTest> test, double testStartTime)
+int TestRunner::run_any(std::unique_ptr<BenchmarkableTest> test, double testStartTime, BenchmarkResult& result)
 {
     try {
         test->startMeasuring(testStartTime);
         test->setup();
+        test->finishSetup();
         test->run();
+        test->finishRun();
         test->printStatistics();
+        test->exportStatistics(result);
         test->teardown();
 
     } catch (const std::runtime_error& exception) {
@@ -198,6 +396,548 @@ int TestRunner::run_any(std::unique_ptr<BenchmarkableTest> test, double testStar
         return -1;
     }
 
+    if (!outputPath.empty() && !writeResult(result)) {
+        return -1;
+    }
+
     return 0;
 }
+
+void TestRunner::printMultithreadingSpeedup(const std::vector<TestConfiguration>& configurations,
+                                            const std::vector<std::vector<BenchmarkResult>>& results) const
+{
+    // Pairs of configurations differing only in threading, e.g. from `-m on,off`
+    std::vector<std::string> lines;
+    for (std::size_t mtIndex = 0; mtIndex < configurations.size(); ++mtIndex) {
+        const TestConfiguration& multithreaded = configurations[mtIndex];
+        if (!multithreaded.multithreaded)
+            continue;
+
+        for (std::size_t stIndex = 0; stIndex < configurations.size(); ++stIndex) {
+            const TestConfiguration& singlethreaded = configurations[stIndex];
+            if (singlethreaded.multithreaded || singlethreaded.testNumber != multithreaded.testNumber ||
+                singlethreaded.api != multithreaded.api || singlethreaded.offscreen != multithreaded.offscreen ||
+                singlethreaded.sceneScale != multithreaded.sceneScale ||
+                singlethreaded.sceneDetail != multithreaded.sceneDetail)
+                continue;
+
+            double mtFrameTime = medianAverageFrameTime(results[mtIndex]);
+            double stFrameTime = medianAverageFrameTime(results[stIndex]);
+            if (mtFrameTime <= 0.0 || stFrameTime <= 0.0)
+                continue;
+
+            char buffer[128];
+            std::snprintf(buffer, sizeof(buffer), ": %.3fms -> %.3fms, speedup %.2fx", stFrameTime, mtFrameTime,
+                          stFrameTime / mtFrameTime);
+            lines.push_back(describeConfiguration(multithreaded) + buffer);
+            break;
+        }
+    }
+
+    if (lines.empty())
+        return;
+
+    std::cout << std::endl;
+    std::cout << "Multithreading speedup" << std::endl;
+    std::cout << "======================" << std::endl;
+    for (const std::string& line : lines) {
+        std::cout << "  " << line << std::endl;
+    }
+}
+
+void TestRunner::printThreadScaling(const std::vector<TestConfiguration>& configurations,
+                                    const std::vector<std::vector<BenchmarkResult>>& results) const
+{
+    // Multithreaded configurations differing only in thread count, e.g. from `-threadsweep`
+    std::vector<bool> used(configurations.size(), false);
+    for (std::size_t index = 0; index < configurations.size(); ++index) {
+        const TestConfiguration& configuration = configurations[index];
+        if (used[index] || !configuration.multithreaded || configuration.threads == 0u)
+            continue;
+
+        TestConfiguration label = configuration;
+        label.threads = 0u;
+        ThreadScaling scaling(describeConfiguration(label) + (configuration.offscreen ? ", offscreen" : ""));
+
+        for (std::size_t other = index; other < configurations.size(); ++other) {
+            const TestConfiguration& candidate = configurations[other];
+            if (!candidate.multithreaded || candidate.threads == 0u ||
+                candidate.testNumber != configuration.testNumber || candidate.api != configuration.api ||
+                candidate.offscreen != configuration.offscreen || candidate.sceneScale != configuration.sceneScale ||
+                candidate.sceneDetail != configuration.sceneDetail)
+                continue;
+
+            used[other] = true;
+            for (const BenchmarkResult& result : results[other]) {
+                scaling.addRun(candidate.threads, result);
+            }
+        }
+
+        if (scaling.threadCounts() > 1u) {
+            std::cout << std::endl;
+            scaling.print(std::cout);
+        }
+    }
+}
+
+void TestRunner::printCostModels(const std::vector<TestConfiguration>& configurations,
+                                 const std::vector<std::vector<BenchmarkResult>>& results) const
+{
+    // Configurations differing only in scene size, e.g. from `-scale 0.5,1,2 -detail 1,2`
+    std::vector<bool> used(configurations.size(), false);
+    for (std::size_t index = 0; index < configurations.size(); ++index) {
+        if (used[index])
+            continue;
+
+        TestConfiguration label = configurations[index];
+        label.sceneScale = 1.0f;
+        label.sceneDetail = 1.0f;
+        CostModel costModel(describeConfiguration(label) + (label.offscreen ? ", offscreen" : ""));
+
+        for (std::size_t other = index; other < configurations.size(); ++other) {
+            const TestConfiguration& candidate = configurations[other];
+            if (candidate.testNumber != label.testNumber || candidate.api != label.api ||
+                candidate.multithreaded != label.multithreaded || candidate.threads != label.threads ||
+                candidate.offscreen != label.offscreen)
+                continue;
+
+            used[other] = true;
+            for (const BenchmarkResult& result : results[other]) {
+                costModel.addRun(candidate.sceneScale, candidate.sceneDetail, result);
+            }
+        }
+
+        if (costModel.sizes() > 1u) {
+            std::cout << std::endl;
+            costModel.print(std::cout);
+        }
+    }
+}
+
+void TestRunner::printStartupSummaries(const std::vector<TestConfiguration>& configurations,
+                                       const std::vector<std::vector<BenchmarkResult>>& results) const
+{
+    // Repeated runs of a configuration, e.g. from `-t 4 -api gl,vk -repeat 10`
+    for (std::size_t index = 0; index < configurations.size(); ++index) {
+        const TestConfiguration& configuration = configurations[index];
+        StartupSummary summary(describeConfiguration(configuration) + (configuration.offscreen ? ", offscreen" : ""));
+        for (const BenchmarkResult& result : results[index]) {
+            summary.addRun(result);
+        }
+
+        if (summary.runs() > 1u) {
+            std::cout << std::endl;
+            summary.print(std::cout);
+        }
+    }
+}
+
+std::vector<TestConfiguration> TestRunner::expandConfigurations(const base::ArgumentParser& args) const
+{
+    if (!args.hasArgument("t"))
+        throw std::invalid_argument("Missing `-t` argument!");
+
+    if (!args.hasArgument("api"))
+        throw std::invalid_argument("Missing `-api` argument!");
+
+    std::vector<int> testNumbers;
+    for (const std::string& token : base::String::split(args.getArgument("t"), ',')) {
+        int testNumber = -1;
+        try {
+            testNumber = std::stoi(token);
+        } catch (...) {
+            // ignore, will fail with proper message later
+        }
+
+        if (!registry.containsTest(testNumber))
+            throw std::invalid_argument("Invalid test number!");
+        testNumbers.push_back(testNumber);
+    }
+
+    std::vector<std::string> apis = base::String::split(args.getArgument("api"), ',');
+    for (const std::string& api : apis) {
+        if (!registry.containsApi(api))
+            throw std::invalid_argument("Invalid `-api` value!");
+    }
+
+    std::vector<bool> threadingModes{false};
+    if (args.hasArgument("m")) {
+        threadingModes = {true};
+
+        if (!args.getArgument("m").empty()) {
+            threadingModes.clear();
+            for (const std::string& token : base::String::split(args.getArgument("m"), ',')) {
+                if (token == "on" || token == "1") {
+                    threadingModes.push_back(true);
+                } else if (token == "off" || token == "0") {
+                    threadingModes.push_back(false);
+                } else {
+                    throw std::invalid_argument("Invalid `-m` value!");
+                }
+            }
+        }
+    }
+
+    if (testNumbers.empty() || apis.empty() || threadingModes.empty())
+        throw std::invalid_argument("Empty test configuration list!");
+
+    bool benchmarkMode = args.hasArgument("benchmark");
+    float benchmarkTime = kDefaultTestBenchmarkTime;
+
+    // Null API has no window to close, its tests end only when benchmarking is complete
+    if (!benchmarkMode && std::find(apis.begin(), apis.end(), "null") != apis.end())
+        throw std::invalid_argument("`-api null` needs `-benchmark`!");
+
+    if (benchmarkMode && args.hasArgument("time")) {
+        try {
+            benchmarkTime = args.getFloatArgument("time");
+        } catch (...) {
+            std::cerr << "Invalid value for argument '-time'!";
+        }
+    }
+
+    std::size_t benchmarkFrames = 0u;
+    if (benchmarkMode && args.hasArgument("frames")) {
+        int value = 0;
+        try {
+            value = args.getIntArgument("frames");
+        } catch (...) {
+            // ignore, will fail with proper message later
+        }
+
+        if (value < 1)
+            throw std::invalid_argument("Invalid `-frames` value!");
+        if (args.hasArgument("time"))
+            throw std::invalid_argument("`-time` and `-frames` can't be used together!");
+        benchmarkFrames = static_cast<std::size_t>(value);
+    }
+
+    float soakWindow = 0.0f;
+    if (args.hasArgument("soak")) {
+        if (!benchmarkMode)
+            throw std::invalid_argument("`-soak` needs `-benchmark`!");
+
+        soakWindow = kDefaultSoakWindow;
+        if (!args.getArgument("soak").empty()) {
+            soakWindow = 0.0f;
+            try {
+                soakWindow = args.getFloatArgument("soak");
+            } catch (...) {
+                // ignore, will fail with proper message later
+            }
+        }
+
+        if (!(soakWindow > 0.0f))
+            throw std::invalid_argument("Invalid `-soak` window!");
+    }
+
+    // Thread count 0 keeps the test's default
+    std::vector<std::size_t> threadCounts{0u};
+    if (args.hasArgument("threads") || args.hasArgument("threadsweep")) {
+        if (args.hasArgument("threads") && args.hasArgument("threadsweep"))
+            throw std::invalid_argument("`-threads` and `-threadsweep` can't be used together!");
+        if (std::find(threadingModes.begin(), threadingModes.end(), true) == threadingModes.end())
+            throw std::invalid_argument("`-threads` and `-threadsweep` need multithreaded version (`-m`)!");
+
+        bool sweep = args.hasArgument("threadsweep");
+        if (sweep && !benchmarkMode)
+            throw std::invalid_argument("`-threadsweep` needs `-benchmark`!");
+
+        int value = 0;
+        if (sweep && args.getArgument("threadsweep").empty()) {
+            value = static_cast<int>(std::max(std::thread::hardware_concurrency(), 1u));
+        } else {
+            try {
+                value = args.getIntArgument(sweep ? "threadsweep" : "threads");
+            } catch (...) {
+                // ignore, will fail with proper message later
+            }
+        }
+
+        if (value < 1)
+            throw std::invalid_argument(sweep ? "Invalid `-threadsweep` value!" : "Invalid `-threads` value!");
+
+        threadCounts.clear();
+        for (int count = sweep ? 1 : value; count <= value; ++count) {
+            threadCounts.push_back(static_cast<std::size_t>(count));
+        }
+    }
+
+    bool offscreen = args.hasArgument("offscreen");
+    bool pipelined = args.hasArgument("pipeline");
+
+    std::size_t framesInFlight = 0u;
+    if (args.hasArgument("inflight")) {
+        int value = 0;
+        try {
+            value = args.getIntArgument("inflight");
+        } catch (...) {
+            // ignore, will fail with proper message later
+        }
+
+        if (value < 1)
+            throw std::invalid_argument("Invalid `-inflight` value!");
+        framesInFlight = static_cast<std::size_t>(value);
+    }
+
+    std::vector<float> sceneScales = parseSceneSizes(args, "scale");
+    std::vector<float> sceneDetails = parseSceneSizes(args, "detail");
+    if ((sceneScales.size() > 1u || sceneDetails.size() > 1u) && !benchmarkMode)
+        throw std::invalid_argument("Lists of `-scale` and `-detail` values need `-benchmark`!");
+    bool scaled = std::any_of(sceneScales.begin(), sceneScales.end(), [](float scale) { return scale != 1.0f; });
+    bool detailed = std::any_of(sceneDetails.begin(), sceneDetails.end(), [](float detail) { return detail != 1.0f; });
+
+    bool deterministic = args.hasArgument("deterministic");
+    uint32_t seed = kDefaultDeterministicSeed;
+    if (deterministic && !args.getArgument("deterministic").empty()) {
+        try {
+            seed = static_cast<uint32_t>(std::stoul(args.getArgument("deterministic")));
+        } catch (...) {
+            throw std::invalid_argument("Invalid `-deterministic` seed!");
+        }
+    }
+
+    bool isMatrix = (testNumbers.size() * apis.size() * threadingModes.size() * threadCounts.size()) > 1u;
+
+    std::vector<TestConfiguration> result;
+    for (int testNumber : testNumbers) {
+        for (const std::string& api : apis) {
+            for (bool multithreaded : threadingModes) {
+                // Singlethreaded version has no worker threads, so it's run only once
+                for (std::size_t threads : multithreaded ? threadCounts : std::vector<std::size_t>{0u}) {
+                    TestConfiguration configuration{testNumber,     api,           multithreaded,   threads,
+                                                    benchmarkMode,  benchmarkTime, benchmarkFrames, soakWindow,
+                                                    offscreen,      pipelined,     framesInFlight,  1.0f,
+                                                    1.0f,           0u,            deterministic,   seed};
+
+                    // Single configuration is always kept, so it fails with a proper message when it's unavailable
+                    if (isMatrix && !registry.contains(testNumber, api, multithreaded)) {
+                        std::cout << "Skipping unavailable configuration: " << describeConfiguration(configuration)
+                                  << std::endl;
+                        break;
+                    }
+
+                    // Tests which don't use an option would measure their default setup under a wrong label
+                    const char* unsupported = nullptr;
+                    if (registry.contains(testNumber, api, multithreaded)) {
+                        auto supports = [&](TestRegistry::Feature feature) {
+                            return registry.supports(testNumber, api, multithreaded, feature);
+                        };
+                        if (scaled && !supports(TestRegistry::SceneScale)) {
+                            unsupported = "-scale";
+                        } else if (detailed && !supports(TestRegistry::SceneDetail)) {
+                            unsupported = "-detail";
+                        } else if (pipelined && !supports(TestRegistry::Pipelining)) {
+                            unsupported = "-pipeline";
+                        } else if (framesInFlight > 0u && !supports(TestRegistry::Pipelining)) {
+                            unsupported = "-inflight";
+                        }
+                    }
+                    if (unsupported) {
+                        if (!isMatrix)
+                            throw std::invalid_argument("`" + std::string{unsupported} + "` isn't supported by " +
+                                                        describeConfiguration(configuration) + "!");
+
+                        std::cout << "Skipping configuration without `" << unsupported
+                                  << "` support: " << describeConfiguration(configuration) << std::endl;
+                        break;
+                    }
+
+                    for (float sceneScale : sceneScales) {
+                        for (float sceneDetail : sceneDetails) {
+                            configuration.sceneScale = sceneScale;
+                            configuration.sceneDetail = sceneDetail;
+                            result.push_back(configuration);
+                        }
+                    }
+                }
+            }
+        }
+    }
+
+    return result;
+}
+
+std::vector<TestConfiguration> TestRunner::readSuite(const std::string& suitePath) const
+{
+    if (!base::File::exists(suitePath))
+        throw std::invalid_argument("Couldn't open suite file: " + suitePath);
+
+    std::vector<TestConfiguration> result;
+    std::size_t lineNumber = 0u;
+
+    for (std::string line : base::String::split(base::File::readText(suitePath), '\n', false)) {
+        ++lineNumber;
+
+        base::String::trim(line);
+        if (line.empty() || line[0] == '#')
+            continue;
+
+        // Each line overrides arguments given in command line
+        std::vector<std::string> lineArguments;
+        for (std::string& token : base::String::split(line, ' ')) {
+            base::String::trim(token);
+            if (!token.empty())
+                lineArguments.push_back(token);
+        }
+
+        try {
+            std::vector<TestConfiguration> lineConfigurations =
+                expandConfigurations(arguments.withOverrides(lineArguments));
+            result.insert(result.end(), lineConfigurations.begin(), lineConfigurations.end());
+        } catch (const std::invalid_argument& exception) {
+            throw std::invalid_argument("Suite line " + std::to_string(lineNumber) + ": " + exception.what());
+        }
+    }
+
+    return result;
+}
+
+std::string TestRunner::describeConfiguration(const TestConfiguration& configuration) const
+{
+    std::string threads =
+        (configuration.threads > 0u) ? " (" + std::to_string(configuration.threads) + " threads)" : std::string{};
+    std::string sceneSize;
+    if (configuration.sceneScale != 1.0f) {
+        sceneSize += ", scale " + formatSceneSize(configuration.sceneScale);
+    }
+    if (configuration.sceneDetail != 1.0f) {
+        sceneSize += ", detail " + formatSceneSize(configuration.sceneDetail);
+    }
+
+    std::string frames;
+    if (configuration.pipelined) {
+        frames += ", pipelined";
+    }
+    if (configuration.framesInFlight > 0u) {
+        frames += ", " + std::to_string(configuration.framesInFlight) + " frames in flight";
+    }
+
+    return "test " + std::to_string(configuration.testNumber) + ", api `" + configuration.api + "`" +
+           (configuration.multithreaded ? ", multithreaded" + threads : "") + frames + sceneSize;
+}
+
+std::string TestRunner::comparisonLabel(const TestConfiguration& configuration, const TestConfiguration& other) const
+{
+    // Only what differs between compared configurations, e.g. just `vk` when comparing APIs
+    std::vector<std::string> parts;
+    if (configuration.testNumber != other.testNumber) {
+        parts.push_back("test " + std::to_string(configuration.testNumber));
+    }
+    if (configuration.api != other.api) {
+        parts.push_back("`" + configuration.api + "`");
+    }
+    if (configuration.multithreaded != other.multithreaded) {
+        parts.push_back(configuration.multithreaded ? "multithreaded" : "singlethreaded");
+    }
+    if (configuration.multithreaded && other.multithreaded && configuration.threads != other.threads) {
+        parts.push_back((configuration.threads > 0u) ? std::to_string(configuration.threads) + " threads"
+                                                     : "default threads");
+    }
+    if (configuration.pipelined != other.pipelined) {
+        parts.push_back(configuration.pipelined ? "pipelined" : "not pipelined");
+    }
+    if (configuration.framesInFlight != other.framesInFlight) {
+        parts.push_back((configuration.framesInFlight > 0u)
+                            ? std::to_string(configuration.framesInFlight) + " frames in flight"
+                            : "default frames in flight");
+    }
+    if (configuration.sceneScale != other.sceneScale) {
+        parts.push_back("scale " + formatSceneSize(configuration.sceneScale));
+    }
+    if (configuration.sceneDetail != other.sceneDetail) {
+        parts.push_back("detail " + formatSceneSize(configuration.sceneDetail));
+    }
+
+    if (parts.empty())
+        return describeConfiguration(configuration);
+
+    std::string result = parts.front();
+    for (std::size_t index = 1; index < parts.size(); ++index) {
+        result += ", " + parts[index];
+    }
+    return result;
+}
+
+BenchmarkResult TestRunner::describeRun(const TestConfiguration& configuration) const
+{
+    char timestamp[32] = {};
+    std::time_t now = std::time(nullptr);
+    std::strftime(timestamp, sizeof(timestamp), "%Y-%m-%dT%H:%M:%SZ", std::gmtime(&now));
+
+    BenchmarkResult result;
+    result.set("run", "timestamp", timestamp);
+    result.set("run", "test", configuration.testNumber);
+    result.set("run", "api", configuration.api);
+    result.set("run", "multithreaded", configuration.multithreaded ? 1.0 : 0.0);
+    result.set("run", "threads", static_cast<double>(configuration.threads));
+    result.set("run", "benchmark", configuration.benchmarkMode ? 1.0 : 0.0);
+    result.set("run", "benchmarkTime", configuration.benchmarkTime);
+    result.set("run", "benchmarkFrames", static_cast<double>(configuration.benchmarkFrames));
+    result.set("run", "soakWindow", configuration.soakWindow);
+    result.set("run", "offscreen", configuration.offscreen ? 1.0 : 0.0);
+    result.set("run", "pipelined", configuration.pipelined ? 1.0 : 0.0);
+    result.set("run", "framesInFlight", static_cast<double>(configuration.framesInFlight));
+    result.set("run", "sceneScale", configuration.sceneScale);
+    result.set("run", "sceneDetail", configuration.sceneDetail);
+    result.set("run", "repetition", static_cast<double>(configuration.repetition));
+    result.set("run", "deterministic", configuration.deterministic ? 1.0 : 0.0);
+    result.set("run", "seed", configuration.deterministic ? static_cast<double>(configuration.seed) : 0.0);
+    return result;
+}
+
+bool TestRunner::writeResult(const BenchmarkResult& result) const
+{
+    if (outputFormat == "csv")
+        return writeCsvResult(result);
+
+    // Results are appended, so many runs can be aggregated from one file
+    std::ofstream file(outputPath, std::ios::out | std::ios::app);
+    if (!file) {
+        std::cerr << "Couldn't open results file: " << outputPath << std::endl;
+        return false;
+    }
+
+    result.writeJson(file);
+    return file.good();
+}
+
+bool TestRunner::writeCsvResult(const BenchmarkResult& result) const
+{
+    std::vector<BenchmarkResult> previous;
+    if (base::File::exists(outputPath)) {
+        try {
+            previous = BenchmarkResult::parseCsv(base::File::readText(outputPath));
+        } catch (const std::invalid_argument& exception) {
+            std::cerr << "Couldn't append to results file " << outputPath << ": " << exception.what() << std::endl;
+            return false;
+        }
+    }
+
+    // Columns depend on the test and options, a row with columns the file lacks rewrites it with all of them
+    std::vector<std::string> columns = previous.empty() ? result.csvColumns() : previous.front().csvColumns();
+    bool rewrite = previous.empty();
+    for (const std::string& column : result.csvColumns()) {
+        if (std::find(columns.begin(), columns.end(), column) == columns.end()) {
+            columns.push_back(column);
+            rewrite = true;
+        }
+    }
+
+    std::ofstream file(outputPath, std::ios::out | (rewrite ? std::ios::trunc : std::ios::app));
+    if (!file) {
+        std::cerr << "Couldn't open results file: " << outputPath << std::endl;
+        return false;
+    }
+
+    if (rewrite) {
+        BenchmarkResult::writeCsvHeader(file, columns);
+        for (const BenchmarkResult& record : previous) {
+            record.writeCsvRow(file, columns);
+        }
+    }
+    result.writeCsvRow(file, columns);
+
+    return file.good();
+}
 }
@@ -0,0 +1,133 @@
+#include <base/LeastSquares.h>
+#include <framework/ThreadScaling.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+double median(const std::vector<double>& values)
+{
+    std::vector<double> sorted = values;
+    std::sort(sorted.begin(), sorted.end());
+
+    std::size_t middle = sorted.size() / 2u;
+    return (sorted.size() % 2u == 1u) ? sorted[middle] : 0.5 * (sorted[middle - 1u] + sorted[middle]);
+}
+
+std::string formatMs(double value)
+{
+    char buffer[32];
+    std::snprintf(buffer, sizeof(buffer), "%.3fms", value);
+    return buffer;
+}
+}
+
+namespace framework {
+double ThreadScaling::Model::frameTime(double threads) const
+{
+    return serialTime + parallelTime / threads + overheadTime * (threads - 1.0);
+}
+
+double ThreadScaling::Model::serialFraction() const
+{
+    double singleThreadTime = serialTime + parallelTime;
+    return (singleThreadTime > 0.0) ? serialTime / singleThreadTime : 0.0;
+}
+
+ThreadScaling::ThreadScaling(const std::string& label)
+    : _label(label)
+    , _frameTimes()
+{
+}
+
+void ThreadScaling::addRun(std::size_t threads, const BenchmarkResult& result)
+{
+    if (threads == 0u || !result.has("stats", "avgFrameTimeMs"))
+        return;
+
+    _frameTimes[threads].push_back(result.number("stats", "avgFrameTimeMs"));
+}
+
+std::size_t ThreadScaling::threadCounts() const
+{
+    return _frameTimes.size();
+}
+
+ThreadScaling::Model ThreadScaling::fit() const
+{
+    // Terms are serial, parallel and overhead time
+    base::LeastSquares::Rows rows;
+    std::vector<double> values;
+    for (const auto& entry : _frameTimes) {
+        double threads = static_cast<double>(entry.first);
+        rows.push_back({1.0, 1.0 / threads, threads - 1.0});
+        values.push_back(median(entry.second));
+    }
+
+    std::vector<double> coefficients;
+    if (!base::LeastSquares::solveNonNegative(rows, values, coefficients))
+        return Model{0.0, 0.0, 0.0, false};
+
+    return Model{coefficients[0], coefficients[1], coefficients[2], true};
+}
+
+void ThreadScaling::print(std::ostream& stream) const
+{
+    std::string title = "Thread scaling (" + _label + ")";
+
+    stream << title << std::endl;
+    stream << std::string(title.size(), '=') << std::endl;
+
+    Model model = fit();
+    if (_frameTimes.size() < 2u || !model.valid) {
+        stream << "  Not enough successful runs, at least 2 different thread counts are needed" << std::endl;
+        stream << std::endl;
+        return;
+    }
+
+    // Speedups are relative to measured single thread time when it was run, otherwise to the model's
+    auto single = _frameTimes.find(1u);
+    double singleThreadTime = (single != _frameTimes.end()) ? median(single->second) : model.frameTime(1.0);
+
+    char buffer[128];
+    stream << "  Threads    Frame time  Speedup  Efficiency  Model" << std::endl;
+    for (const auto& entry : _frameTimes) {
+        double threads = static_cast<double>(entry.first);
+        double frameTime = median(entry.second);
+        double speedup = singleThreadTime / frameTime;
+        std::snprintf(buffer, sizeof(buffer), "  %7zu  %12s  %6.2fx  %9.1f%%  %s", entry.first,
+                      formatMs(frameTime).c_str(), speedup, 100.0 * speedup / threads,
+                      formatMs(model.frameTime(threads)).c_str());
+        stream << buffer << std::endl;
+    }
+
+    stream << "  Serial time:     " << formatMs(model.serialTime) << " per frame" << std::endl;
+    stream << "  Parallel time:   " << formatMs(model.parallelTime) << " per frame (on a single thread)" << std::endl;
+    stream << "  Overhead:        " << formatMs(model.overheadTime) << " per frame and additional thread" << std::endl;
+
+    double serialFraction = model.serialFraction();
+    std::snprintf(buffer, sizeof(buffer), "%.1f%%", 100.0 * serialFraction);
+    stream << "  Serial fraction: " << buffer;
+    if (serialFraction > 0.0) {
+        std::snprintf(buffer, sizeof(buffer), "%.2fx", 1.0 / serialFraction);
+        stream << " (Amdahl's limit of speedup " << buffer << ")";
+    }
+    stream << std::endl;
+
+    if (model.overheadTime > 0.0 && model.parallelTime > 0.0) {
+        // Optimum of the model is between the closest integers to sqrt(parallel / overhead)
+        double optimum = std::sqrt(model.parallelTime / model.overheadTime);
+        double lower = std::max(std::floor(optimum), 1.0);
+        double upper = std::max(std::ceil(optimum), 1.0);
+        double threads = (model.frameTime(lower) <= model.frameTime(upper)) ? lower : upper;
+
+        std::snprintf(buffer, sizeof(buffer), "%.0f", threads);
+        stream << "  Best thread count: " << buffer << " (model frame time " << formatMs(model.frameTime(threads))
+               << ")" << std::endl;
+    } else {
+        stream << "  Best thread count: no overhead measured, more threads keep helping" << std::endl;
+    }
+    stream << std::endl;
+}
+}
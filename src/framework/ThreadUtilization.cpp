@@ -0,0 +1,142 @@
+#include <base/Clock.h>
+#include <framework/ThreadUtilization.h>
+
+#include <algorithm>
+
+namespace {
+uint64_t toNanoseconds(double seconds)
+{
+    return static_cast<uint64_t>(std::max(seconds, 0.0) * 1.0e9);
+}
+
+double toSeconds(uint64_t nanoseconds)
+{
+    return static_cast<double>(nanoseconds) * 1.0e-9;
+}
+}
+
+namespace framework {
+ThreadUtilization::ThreadUtilization()
+    : _workerTime(0u)
+    , _workerCpuTime(0u)
+    , _regions(0u)
+    , _workers(0u)
+    , _regionTime(0.0)
+    , _joinTime(0.0)
+    , _availableWorkerTime(0.0)
+{
+}
+
+void ThreadUtilization::reset()
+{
+    _workerTime = 0u;
+    _workerCpuTime = 0u;
+    _regions = 0u;
+    _workers = 0u;
+    _regionTime = 0.0;
+    _joinTime = 0.0;
+    _availableWorkerTime = 0.0;
+}
+
+void ThreadUtilization::addRegion(std::size_t workers, double regionTime, double joinTime)
+{
+    ++_regions;
+    _workers += workers;
+    _regionTime += regionTime;
+    _joinTime += joinTime;
+    _availableWorkerTime += static_cast<double>(workers) * regionTime;
+}
+
+void ThreadUtilization::addWorkerTask(double wallTime, double cpuTime)
+{
+    _workerTime.fetch_add(toNanoseconds(wallTime), std::memory_order_relaxed);
+    _workerCpuTime.fetch_add(toNanoseconds(cpuTime), std::memory_order_relaxed);
+}
+
+std::size_t ThreadUtilization::regions() const
+{
+    return _regions;
+}
+
+double ThreadUtilization::averageWorkers() const
+{
+    return (_regions > 0u) ? static_cast<double>(_workers) / static_cast<double>(_regions) : 0.0;
+}
+
+double ThreadUtilization::regionTime() const
+{
+    return _regionTime;
+}
+
+double ThreadUtilization::joinTime() const
+{
+    return _joinTime;
+}
+
+double ThreadUtilization::workerTime() const
+{
+    return toSeconds(_workerTime.load(std::memory_order_relaxed));
+}
+
+double ThreadUtilization::workerCpuTime() const
+{
+    return toSeconds(_workerCpuTime.load(std::memory_order_relaxed));
+}
+
+double ThreadUtilization::workerIdleTime() const
+{
+    return std::max(_availableWorkerTime - workerTime(), 0.0);
+}
+
+double ThreadUtilization::efficiency() const
+{
+    return (_availableWorkerTime > 0.0) ? std::min(workerTime() / _availableWorkerTime, 1.0) : 0.0;
+}
+
+double ThreadUtilization::speedup() const
+{
+    return (_regionTime > 0.0) ? workerTime() / _regionTime : 0.0;
+}
+
+ParallelRegionTimer::ParallelRegionTimer(ThreadUtilization& utilization, std::size_t workers)
+    : _utilization(utilization)
+    , _workers(workers)
+    , _start(base::Clock::seconds())
+    , _joinStart(0.0)
+    , _ended(false)
+{
+}
+
+ParallelRegionTimer::~ParallelRegionTimer()
+{
+    end();
+}
+
+void ParallelRegionTimer::beginJoin()
+{
+    _joinStart = base::Clock::seconds();
+}
+
+void ParallelRegionTimer::end()
+{
+    if (_ended)
+        return;
+    _ended = true;
+
+    double now = base::Clock::seconds();
+    double joinTime = (_joinStart > 0.0) ? (now - _joinStart) : 0.0;
+    _utilization.addRegion(_workers, now - _start, joinTime);
+}
+
+WorkerTimer::WorkerTimer(ThreadUtilization& utilization)
+    : _utilization(utilization)
+    , _start(base::Clock::seconds())
+    , _cpuStart(base::Clock::threadCpuSeconds())
+{
+}
+
+WorkerTimer::~WorkerTimer()
+{
+    _utilization.addWorkerTask(base::Clock::seconds() - _start, base::Clock::threadCpuSeconds() - _cpuStart);
+}
+}
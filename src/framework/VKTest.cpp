@@ -1,15 +1,41 @@
 #include <framework/VKTest.h>
 
 #include <iostream>
+#include <string>
 
 namespace {
 const bool kDebugEnabled = false;
+
+// These values are taken from http://pcidatabase.com/
+std::string vendorName(uint32_t vendorId)
+{
+    switch (vendorId) {
+    case 0x10DE:
+        return "Nvidia";
+    case 0x1002:
+    case 0x1022:
+        return "AMD";
+    case 0x163C:
+    case 0x8086:
+    case 0x8087:
+        return "Intel";
+    default:
+        return "UNKNOWN";
+    }
+}
+
+std::string versionString(uint32_t version)
+{
+    return std::to_string(VK_VERSION_MAJOR(version)) + "." + std::to_string(VK_VERSION_MINOR(version)) + "." +
+           std::to_string(VK_VERSION_PATCH(version));
+}
 }
 
 namespace framework {
-VKTest::VKTest(const std::string& testName, bool benchmarkMode, float benchmarkTime)
-    : BenchmarkableTest(benchmarkMode, benchmarkTime)
-    , base::vkx::Application("[VK] " + testName, {WINDOW_WIDTH, WINDOW_HEIGHT}, kDebugEnabled)
+VKTest::VKTest(const std::string& testName, const TestConfiguration& configuration)
+    : BenchmarkableTest(configuration)
+    , base::vkx::Application("[VK] " + testName, {WINDOW_WIDTH, WINDOW_HEIGHT}, kDebugEnabled, configuration.offscreen)
+    , _framesInFlight(configuration.framesInFlight)
 {
 }
 
@@ -21,30 +47,32 @@ void VKTest::teardown()
 {
 }
 
-void VKTest::printStatistics() const
+std::size_t VKTest::framesInFlight() const
 {
-    // These values are taken from http://pcidatabase.com/
-    auto vendorName = [](uint32_t vendorId) -> std::string {
-        switch (vendorId) {
-        case 0x10DE:
-            return "Nvidia";
-        case 0x1002:
-        case 0x1022:
-            return "AMD";
-        case 0x163C:
-        case 0x8086:
-        case 0x8087:
-            return "Intel";
-        default:
-            return "UNKNOWN";
-        }
-    };
-
-    auto version = [](uint32_t version) -> std::string {
-        return std::to_string(VK_VERSION_MAJOR(version)) + "." + std::to_string(VK_VERSION_MINOR(version)) + "." +
-               std::to_string(VK_VERSION_PATCH(version));
-    };
+    return (_framesInFlight > 0u) ? _framesInFlight : window().swapchainImages().size();
+}
+
+std::vector<BenchmarkableTest::GpuMemoryUsage> VKTest::gpuMemoryUsage() const
+{
+    std::vector<GpuMemoryUsage> result;
+
+    std::vector<base::vkx::MemoryManager::HeapUsage> heaps = memory().heapUsage();
+    for (std::size_t index = 0; index < heaps.size(); ++index) {
+        if (heaps[index].peakBytes == 0u)
+            continue;
 
+        bool deviceLocal = static_cast<bool>(deviceInfo().memory.memoryHeaps[index].flags &
+                                             vk::MemoryHeapFlagBits::eDeviceLocal);
+        result.push_back({"Vulkan heap " + std::to_string(index) + (deviceLocal ? " (device local)" : " (host)"),
+                          "vkHeap" + std::to_string(index), static_cast<std::size_t>(heaps[index].bytes),
+                          static_cast<std::size_t>(heaps[index].peakBytes)});
+    }
+
+    return result;
+}
+
+void VKTest::printStatistics() const
+{
     std::cout << "Hardware/software information" << std::endl;
     std::cout << "=============================" << std::endl;
     std::cout << "  Vendor:           " << vendorName(deviceInfo().properties.vendorID)
@@ -52,8 +80,8 @@ void VKTest::printStatistics() const
     std::cout << "  Device:           " << deviceInfo().properties.deviceName
               << " (ID: " << deviceInfo().properties.deviceID << ")" << std::endl;
     std::cout << "  Device type:      " << vk::to_string(deviceInfo().properties.deviceType) << std::endl;
-    std::cout << "  API version:      " << version(deviceInfo().properties.apiVersion) << std::endl;
-    std::cout << "  Driver version:   " << version(deviceInfo().properties.driverVersion) << std::endl;
+    std::cout << "  API version:      " << versionString(deviceInfo().properties.apiVersion) << std::endl;
+    std::cout << "  Driver version:   " << versionString(deviceInfo().properties.driverVersion) << std::endl;
     std::cout << std::endl;
 
     std::cout << "Test information" << std::endl;
@@ -63,4 +91,20 @@ void VKTest::printStatistics() const
 
     BenchmarkableTest::printStatistics();
 }
+
+void VKTest::exportStatistics(BenchmarkResult& result) const
+{
+    const auto& properties = deviceInfo().properties;
+
+    result.set("run", "name", window().title());
+    result.set("device", "vendor",
+               vendorName(properties.vendorID) + " (ID: " + std::to_string(properties.vendorID) + ")");
+    result.set("device", "device",
+               std::string{properties.deviceName} + " (ID: " + std::to_string(properties.deviceID) + ")");
+    result.set("device", "deviceType", vk::to_string(properties.deviceType));
+    result.set("device", "apiVersion", versionString(properties.apiVersion));
+    result.set("device", "driverVersion", versionString(properties.driverVersion));
+
+    BenchmarkableTest::exportStatistics(result);
+}
 }
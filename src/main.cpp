@@ -9,7 +9,7 @@ int main(int argc, char* argv[])
         base::ArgumentParser argParser{argc, argv};
         framework::TestRunner testRunner{std::move(argParser)};
 
-        testRunner.run();
+        return testRunner.run();
 
     } catch (const std::system_error& systemError) {
         std::cerr << "Caught std::system_error!" << std::endl;
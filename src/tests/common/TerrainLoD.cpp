@@ -57,19 +57,33 @@ void TerrainLoD::executeLoD(const glm::vec2& position,
 
 void TerrainLoD::executeLoD(const glm::vec2& position,
                             const std::function<void(std::size_t, std::ptrdiff_t)>& function,
-                            std::size_t nodeIndex) const
+                            const QTNode& node) const
 {
-    switch (nodeIndex) {
-    case 0:
-    case 1:
-    case 2:
-    case 3:
-        if (_root.nodes[nodeIndex]) {
-            executeLoDRecursive(position, function, *_root.nodes[nodeIndex]);
+    executeLoDRecursive(position, function, node);
+}
+
+void TerrainLoD::splitLoD(const glm::vec2& position, std::size_t count, std::vector<const QTNode*>& subtrees) const
+{
+    subtrees.assign(1u, &_root);
+
+    // Each pass splits all nodes of the current level, so subtrees stay similar in size
+    std::vector<const QTNode*> level;
+    bool split = true;
+    while (subtrees.size() < count && split) {
+        level.swap(subtrees);
+        subtrees.clear();
+        split = false;
+
+        for (const QTNode* node : level) {
+            if (isDetailedEnough(position, *node)) {
+                subtrees.push_back(node);
+            } else {
+                for (const auto& subnode : node->nodes) {
+                    subtrees.push_back(subnode.get());
+                }
+                split = true;
+            }
         }
-        break;
-    default:
-        break;
     }
 }
 
@@ -119,24 +133,26 @@ void TerrainLoD::computeNodesRecursive(const Heightmap& heightmap,
     }
 }
 
+bool TerrainLoD::isDetailedEnough(const glm::vec2& position, const QTNode& node) const
+{
+    if (!node.nodes.front())
+        return true;
+
+    float distance = glm::distance(position, node.position + (node.size / 2.0f));
+    float maxSize = glm::compMax(node.size);
+    return (distance / maxSize >= _lodFactor);
+}
+
 void TerrainLoD::executeLoDRecursive(const glm::vec2& position,
                                      const std::function<void(std::size_t, std::ptrdiff_t)>& function,
                                      const QTNode& node) const
 {
-    if (!node.nodes.front()) {
+    if (isDetailedEnough(position, node)) {
         function(node.indexCount, node.indexOffset);
 
     } else {
-        float distance = glm::distance(position, node.position + (node.size / 2.0f));
-        float maxSize = glm::compMax(node.size);
-
-        if (distance / maxSize >= _lodFactor) {
-            function(node.indexCount, node.indexOffset);
-
-        } else {
-            for (const auto& subnode : node.nodes) {
-                executeLoDRecursive(position, function, *subnode);
-            }
+        for (const auto& subnode : node.nodes) {
+            executeLoDRecursive(position, function, *subnode);
         }
     }
 }
@@ -5,14 +5,72 @@
 
 #include <glm/glm.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 namespace {
 const std::size_t kBallCount = 200000;
 const std::size_t kSphereSlices = 3;
 const std::size_t kSphereStacks = 3;
+const std::size_t kMinSphereSlices = 3; // fewer slices don't enclose any volume
+const std::size_t kMinSphereStacks = 2;
 const std::size_t kUpdateRuns = 10;
+
+std::size_t scaled(std::size_t value, float scale, std::size_t minimum)
+{
+    return std::max(static_cast<std::size_t>(std::lround(static_cast<float>(value) * scale)), minimum);
+}
+
+// Target is updated in place, after the range is copied from source (unless it's the same vector)
+void updateBalls(const std::vector<tests::common::Ball>& source,
+                 std::vector<tests::common::Ball>& target,
+                 float frameTime,
+                 std::size_t rangeFrom,
+                 std::size_t rangeTo)
+{
+    auto clampFloat = [](float& v, float min, float max) -> bool {
+        if (v < min) {
+            v = min;
+            return true;
+        } else if (v > max) {
+            v = max;
+            return true;
+        }
+        return false;
+    };
+
+    if (&source != &target) {
+        std::copy(source.begin() + rangeFrom, source.begin() + rangeTo, target.begin() + rangeFrom);
+    }
+
+    for (std::size_t run = 0; run < kUpdateRuns; ++run) {
+        for (std::size_t ballIndex = rangeFrom; ballIndex < rangeTo; ++ballIndex) {
+            tests::common::Ball& ball = target[ballIndex];
+
+            ball.position += (frameTime * ball.speed);
+
+            if (clampFloat(ball.position.x, -1.0, 1.0))
+                ball.speed.x *= (-1.0);
+            if (clampFloat(ball.position.y, -1.0, 1.0))
+                ball.speed.y *= (-1.0);
+            if (clampFloat(ball.position.z, -1.0, 1.0))
+                ball.speed.z *= (-1.0);
+        }
+    }
+}
 }
 
 namespace tests {
+BaseBallsSceneTest::BaseBallsSceneTest(float sceneScale, float sceneDetail)
+    : _ballCount(scaled(kBallCount, sceneScale, 1u))
+    , _sphereSlices(scaled(kSphereSlices, sceneDetail, kMinSphereSlices))
+    , _sphereStacks(scaled(kSphereStacks, sceneDetail, kMinSphereStacks))
+    , _balls()
+    , _nextBalls()
+    , _vertices()
+{
+}
+
 void BaseBallsSceneTest::initTestState()
 {
     // Balls
@@ -20,9 +78,9 @@ void BaseBallsSceneTest::initTestState()
         const float SPEED_SCALE = 0.3f;
 
         _balls = std::vector<common::Ball>{};
-        _balls.reserve(kBallCount);
+        _balls.reserve(_ballCount);
 
-        for (size_t i = 0; i < kBallCount; ++i) {
+        for (size_t i = 0; i < _ballCount; ++i) {
             auto position = base::random::getRandomVec4({-1.0, -1.0, -1.0, 0.0}, {1.0, 1.0, 1.0, 0.0});
             auto color = base::random::getRandomVec4({0.0, 0.0, 0.0, 1.0}, {1.0, 1.0, 1.0, 1.0});
             auto speed = base::random::getRandomVec4({-1.0, -1.0, -1.0, 0.0}, {1.0, 1.0, 1.0, 0.0});
@@ -33,7 +91,7 @@ void BaseBallsSceneTest::initTestState()
 
     // Vertices
     {
-        common::SphereVerticesGenerator verticesGenerator{kSphereSlices, kSphereStacks};
+        common::SphereVerticesGenerator verticesGenerator{_sphereSlices, _sphereStacks};
         _vertices = verticesGenerator.vertices;
     }
 }
@@ -45,36 +103,33 @@ void BaseBallsSceneTest::updateTestState(float frameTime)
 
 void BaseBallsSceneTest::updateTestState(float frameTime, std::size_t rangeFrom, std::size_t rangeTo)
 {
-    auto clampFloat = [](float& v, float min, float max) -> bool {
-        if (v < min) {
-            v = min;
-            return true;
-        } else if (v > max) {
-            v = max;
-            return true;
-        }
-        return false;
-    };
+    updateBalls(_balls, _balls, frameTime, rangeFrom, rangeTo);
+}
 
-    for (std::size_t run = 0; run < kUpdateRuns; ++run) {
-        for (std::size_t ballIndex = rangeFrom; ballIndex < rangeTo; ++ballIndex) {
-            common::Ball& ball = _balls[ballIndex];
+void BaseBallsSceneTest::initNextTestState()
+{
+    _nextBalls = _balls;
+}
 
-            ball.position += (frameTime * ball.speed);
+void BaseBallsSceneTest::updateNextTestState(float frameTime)
+{
+    updateNextTestState(frameTime, 0, _balls.size());
+}
 
-            if (clampFloat(ball.position.x, -1.0, 1.0))
-                ball.speed.x *= (-1.0);
-            if (clampFloat(ball.position.y, -1.0, 1.0))
-                ball.speed.y *= (-1.0);
-            if (clampFloat(ball.position.z, -1.0, 1.0))
-                ball.speed.z *= (-1.0);
-        }
-    }
+void BaseBallsSceneTest::updateNextTestState(float frameTime, std::size_t rangeFrom, std::size_t rangeTo)
+{
+    updateBalls(_balls, _nextBalls, frameTime, rangeFrom, rangeTo);
+}
+
+void BaseBallsSceneTest::swapTestState()
+{
+    _balls.swap(_nextBalls);
 }
 
 void BaseBallsSceneTest::destroyTestState()
 {
     _balls.clear();
+    _nextBalls.clear();
     _vertices.clear();
 }
 
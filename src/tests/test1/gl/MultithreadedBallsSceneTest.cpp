@@ -5,14 +5,13 @@
 #include <GL/glew.h>
 #include <glm/vec4.hpp>
 
-#include <thread>
 #include <vector>
 
 namespace tests {
 namespace test_gl {
-MultithreadedBallsSceneTest::MultithreadedBallsSceneTest(bool benchmarkMode, float benchmarkTime)
-    : BaseBallsSceneTest()
-    , GLTest("MultithreadedBallsSceneTest", benchmarkMode, benchmarkTime)
+MultithreadedBallsSceneTest::MultithreadedBallsSceneTest(const framework::TestConfiguration& configuration)
+    : BaseBallsSceneTest(configuration.sceneScale, configuration.sceneDetail)
+    , GLTest("MultithreadedBallsSceneTest", configuration)
 {
 }
 
@@ -34,20 +33,25 @@ void MultithreadedBallsSceneTest::run()
 
         updateStateMultithreaded();
 
-        program_.use();
-        vao_.bind();
+        {
+            framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::Driver};
 
-        for (const auto& ball : balls()) {
-            program_["objPosition"] = ball.position;
-            program_["objColor"] = ball.color;
+            program_.use();
+            vao_.bind();
 
-            vao_.drawArrays();
-        }
+            countDraws(balls().size(), balls().size() * vertices().size());
+            for (const auto& ball : balls()) {
+                program_["objPosition"] = ball.position;
+                program_["objColor"] = ball.color;
+
+                vao_.drawArrays();
+            }
 
-        vao_.unbind();
-        program_.unbind();
+            vao_.unbind();
+            program_.unbind();
+        }
 
-        window_.update();
+        updateWindow();
 
         if (processFrameTime(window_.getFrameTime())) {
             break; // Benchmarking is complete
@@ -102,28 +106,26 @@ void MultithreadedBallsSceneTest::initVAO()
 
 void MultithreadedBallsSceneTest::updateStateMultithreaded()
 {
-    static const std::size_t threadCount = std::thread::hardware_concurrency();
-
-    std::vector<std::thread> threads(threadCount);
-    for (std::size_t threadIndex = 0; threadIndex < threadCount; ++threadIndex) {
-        std::size_t k = balls().size() / threadCount;
-        std::size_t rangeFrom = threadIndex * k;
-        std::size_t rangeTo = (threadIndex + 1) * k;
-
-        threads[threadIndex] =
-            std::move(std::thread(&MultithreadedBallsSceneTest::updatePartialState, this, rangeFrom, rangeTo));
-    }
-
-    for (auto& thread : threads) {
-        thread.join();
-    }
+    const std::size_t threadCount = workerThreads();
+
+    // Small ranges are balanced between workers by stealing, remainder of balls is spread over them
+    framework::ParallelRegionTimer region{_threadUtilization, threadCount};
+    threadPool().dispatch(threadPool().splitForWorkers(balls().size()),
+                          [this](std::size_t rangeFrom, std::size_t rangeTo, std::size_t) {
+                              updatePartialState(rangeFrom, rangeTo);
+                          });
+
+    region.beginJoin();
+    threadPool().wait();
+    region.end();
 }
 
 void MultithreadedBallsSceneTest::updatePartialState(std::size_t rangeFrom, std::size_t rangeTo)
 {
     TIME_IT("Partial state update");
+    framework::WorkerTimer worker{_threadUtilization};
 
-    updateTestState(static_cast<float>(window_.getFrameTime()), rangeFrom, rangeTo);
+    updateTestState(static_cast<float>(simulationTimeStep(window_.getFrameTime())), rangeFrom, rangeTo);
 }
 }
 }
@@ -5,9 +5,9 @@
 
 namespace tests {
 namespace test_gl {
-SimpleBallsSceneTest::SimpleBallsSceneTest(bool benchmarkMode, float benchmarkTime)
-    : BaseBallsSceneTest()
-    , GLTest("SimpleBallsSceneTest", benchmarkMode, benchmarkTime)
+SimpleBallsSceneTest::SimpleBallsSceneTest(const framework::TestConfiguration& configuration)
+    : BaseBallsSceneTest(configuration.sceneScale, configuration.sceneDetail)
+    , GLTest("SimpleBallsSceneTest", configuration)
 {
 }
 
@@ -27,22 +27,27 @@ void SimpleBallsSceneTest::run()
     while (!window_.shouldClose()) {
         glClear(GL_COLOR_BUFFER_BIT);
 
-        updateTestState(static_cast<float>(window_.getFrameTime()));
+        updateTestState(static_cast<float>(simulationTimeStep(window_.getFrameTime())));
 
-        program_.use();
-        vao_.bind();
+        {
+            framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::Driver};
 
-        for (const auto& ball : balls()) {
-            program_["objPosition"] = ball.position;
-            program_["objColor"] = ball.color;
+            program_.use();
+            vao_.bind();
 
-            vao_.drawArrays();
-        }
+            countDraws(balls().size(), balls().size() * vertices().size());
+            for (const auto& ball : balls()) {
+                program_["objPosition"] = ball.position;
+                program_["objColor"] = ball.color;
+
+                vao_.drawArrays();
+            }
 
-        vao_.unbind();
-        program_.unbind();
+            vao_.unbind();
+            program_.unbind();
+        }
 
-        window_.update();
+        updateWindow();
 
         if (processFrameTime(window_.getFrameTime())) {
             break; // Benchmarking is complete
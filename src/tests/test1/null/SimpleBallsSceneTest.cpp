@@ -0,0 +1,44 @@
+#include <tests/test1/null/SimpleBallsSceneTest.h>
+
+namespace tests {
+namespace test_null {
+SimpleBallsSceneTest::SimpleBallsSceneTest(const framework::TestConfiguration& configuration)
+    : BaseBallsSceneTest(configuration.sceneScale, configuration.sceneDetail)
+    , NullTest("SimpleBallsSceneTest", configuration)
+{
+}
+
+void SimpleBallsSceneTest::setup()
+{
+    NullTest::setup();
+    initTestState();
+}
+
+void SimpleBallsSceneTest::run()
+{
+    while (!shouldClose()) {
+        updateTestState(static_cast<float>(simulationTimeStep(frameTime())));
+
+        countDraws(balls().size(), balls().size() * vertices().size());
+        for (const auto& ball : balls()) {
+            setUniform(ball.position);
+            setUniform(ball.color);
+
+            draw(vertices().size(), 0);
+        }
+
+        update();
+
+        if (processFrameTime(frameTime())) {
+            break; // Benchmarking is complete
+        }
+    }
+}
+
+void SimpleBallsSceneTest::teardown()
+{
+    destroyTestState();
+    NullTest::teardown();
+}
+}
+}
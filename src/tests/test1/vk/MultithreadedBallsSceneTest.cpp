@@ -7,15 +7,17 @@
 
 #include <array>
 #include <stdexcept>
-#include <thread>
 #include <vector>
 
 namespace tests {
 namespace test_vk {
-MultithreadedBallsSceneTest::MultithreadedBallsSceneTest(bool benchmarkMode, float benchmarkTime)
-    : BaseBallsSceneTest()
-    , VKTest("MultithreadedBallsSceneTest", benchmarkMode, benchmarkTime)
-    , _semaphoreIndex(0u)
+MultithreadedBallsSceneTest::MultithreadedBallsSceneTest(const framework::TestConfiguration& configuration)
+    : BaseBallsSceneTest(configuration.sceneScale, configuration.sceneDetail)
+    , VKTest("MultithreadedBallsSceneTest", configuration)
+    , _workerCmdBuffers()
+    , _frameIndex(0u)
+    , _frameGraph()
+    , _recordedImageIndex(0u)
 {
 }
 
@@ -23,6 +25,9 @@ void MultithreadedBallsSceneTest::setup()
 {
     VKTest::setup();
     initTestState();
+    if (pipelined()) {
+        initNextTestState();
+    }
 
     createCommandBuffers();
     createSecondaryCommandBuffers();
@@ -34,18 +39,22 @@ void MultithreadedBallsSceneTest::setup()
     createShaders();
     createPipelineLayout();
     createPipeline();
+    createFrameGraph();
 }
 
 void MultithreadedBallsSceneTest::run()
 {
-    while (!window().shouldClose()) {
-        TIME_RESET("Frame times:");
+    if (pipelined()) {
+        // Pipelined updates run a frame ahead, so frame N renders the same state as without them
+        updateTestState(static_cast<float>(simulationTimeStep(window().frameTime())));
+    }
 
-        auto frameIndex = getNextFrameIndex();
+    while (!window().shouldClose()) {
+        auto imageIndex = getNextImageIndex();
 
-        prepareCommandBuffer(frameIndex);
-        submitCommandBuffer(frameIndex);
-        presentFrame(frameIndex);
+        prepareCommandBuffer(imageIndex);
+        submitCommandBuffer();
+        presentFrame(imageIndex);
 
         window().update();
 
@@ -79,21 +88,12 @@ void MultithreadedBallsSceneTest::createCommandBuffers()
     vk::CommandPoolCreateFlags cmdPoolFlags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
     _cmdPool = device().createCommandPool({cmdPoolFlags, queues().familyIndex()});
     _cmdBuffers = device().allocateCommandBuffers(
-        {_cmdPool, vk::CommandBufferLevel::ePrimary, static_cast<uint32_t>(window().swapchainImages().size())});
+        {_cmdPool, vk::CommandBufferLevel::ePrimary, static_cast<uint32_t>(framesInFlight())});
 }
 
 void MultithreadedBallsSceneTest::createSecondaryCommandBuffers()
 {
-    static const std::size_t threads = std::thread::hardware_concurrency();
-
-    _threadCmdPools.resize(threads);
-    for (auto& sndCmdPool : _threadCmdPools) {
-        vk::CommandPoolCreateFlags cmdPoolFlags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
-        sndCmdPool.cmdPool = device().createCommandPool({cmdPoolFlags, queues().familyIndex()});
-        sndCmdPool.cmdBuffers =
-            device().allocateCommandBuffers({sndCmdPool.cmdPool, vk::CommandBufferLevel::eSecondary,
-                                             static_cast<uint32_t>(window().swapchainImages().size())});
-    }
+    _workerCmdBuffers = base::vkx::WorkerCommandBuffers(device(), queues(), workerThreads(), framesInFlight());
 }
 
 void MultithreadedBallsSceneTest::createVbo()
@@ -114,7 +114,7 @@ void MultithreadedBallsSceneTest::createVbo()
 
 void MultithreadedBallsSceneTest::createSemaphores()
 {
-    for (std::size_t i = 0; i < window().swapchainImages().size(); ++i) {
+    for (std::size_t i = 0; i < framesInFlight(); ++i) {
         _acquireSemaphores.push_back(device().createSemaphore({}));
         _renderSemaphores.push_back(device().createSemaphore({}));
     }
@@ -138,7 +138,7 @@ void MultithreadedBallsSceneTest::createRenderPass()
                                          vk::AttachmentLoadOp::eDontCare,
                                          vk::AttachmentStoreOp::eDontCare,
                                          vk::ImageLayout::eUndefined,
-                                         vk::ImageLayout::ePresentSrcKHR};
+                                         window().presentImageLayout()};
     vk::AttachmentReference colorAttachment{0, vk::ImageLayout::eColorAttachmentOptimal};
     vk::SubpassDescription subpassDesc{
         {}, vk::PipelineBindPoint::eGraphics, 0, nullptr, 1, &colorAttachment, nullptr, nullptr, 0, nullptr};
@@ -248,6 +248,25 @@ void MultithreadedBallsSceneTest::createPipeline()
     _pipeline = device().createGraphicsPipeline({}, pipelineInfo);
 }
 
+void MultithreadedBallsSceneTest::createFrameGraph()
+{
+    // Remainder of balls is spread over the ranges, so all of them are updated and drawn
+    auto ranges = threadPool().splitForWorkers(balls().size());
+
+    base::TaskGraph::Node update = _frameGraph.add([this](std::size_t rangeFrom, std::size_t rangeTo, std::size_t) {
+        updateBalls(rangeFrom, rangeTo);
+    });
+    base::TaskGraph::Node record =
+        _frameGraph.add([this](std::size_t rangeFrom, std::size_t rangeTo, std::size_t worker) {
+            recordBalls(rangeFrom, rangeTo, worker);
+        });
+    if (!pipelined()) {
+        _frameGraph.precede(update, record);
+    }
+    _frameGraph.setRanges(update, ranges);
+    _frameGraph.setRanges(record, ranges);
+}
+
 void MultithreadedBallsSceneTest::destroyPipeline()
 {
     device().destroyPipeline(_pipeline);
@@ -304,11 +323,7 @@ void MultithreadedBallsSceneTest::destroyVbo()
 
 void MultithreadedBallsSceneTest::destroySecondaryCommandBuffers()
 {
-    for (auto& threadCmdPool : _threadCmdPools) {
-        device().destroyCommandPool(threadCmdPool.cmdPool);
-        threadCmdPool.cmdBuffers.clear();
-    }
-    _threadCmdPools.clear();
+    _workerCmdBuffers = base::vkx::WorkerCommandBuffers{};
 }
 
 void MultithreadedBallsSceneTest::destroyCommandBuffers()
@@ -331,115 +346,115 @@ std::vector<vk::PipelineShaderStageCreateInfo> MultithreadedBallsSceneTest::getS
     return stages;
 }
 
-uint32_t MultithreadedBallsSceneTest::getNextFrameIndex() const
+uint32_t MultithreadedBallsSceneTest::getNextImageIndex() const
 {
-    _semaphoreIndex = (_semaphoreIndex + 1) % window().swapchainImages().size();
+    // Frames in flight are used in turn, resources of a frame can be reused once its fence is signaled
+    _frameIndex = (_frameIndex + 1) % _cmdBuffers.size();
+    {
+        TIME_IT("Fence waiting");
+        framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::GpuWait};
+        device().waitForFences(1, &_fences[_frameIndex], VK_FALSE, UINT64_MAX);
+        device().resetFences(1, &_fences[_frameIndex]);
+    }
 
-    auto nextFrameAcquireStatus =
-        device().acquireNextImageKHR(window().swapchain(), UINT64_MAX, _acquireSemaphores[_semaphoreIndex], {});
+    TIME_IT("Frame image acquisition");
+    framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::Present};
+    return window().acquireNextImage(_acquireSemaphores[_frameIndex]);
+}
 
-    if (nextFrameAcquireStatus.result != vk::Result::eSuccess) {
-        throw std::system_error(nextFrameAcquireStatus.result, "Error during acquiring next frame index");
+void MultithreadedBallsSceneTest::updateBalls(std::size_t rangeFrom, std::size_t rangeTo)
+{
+    TIME_IT("Partial state update");
+    framework::WorkerTimer worker{_threadUtilization};
+
+    float frameTime = static_cast<float>(simulationTimeStep(window().frameTime()));
+    if (pipelined()) {
+        updateNextTestState(frameTime, rangeFrom, rangeTo);
+    } else {
+        updateTestState(frameTime, rangeFrom, rangeTo);
     }
-
-    return nextFrameAcquireStatus.value;
 }
 
-void MultithreadedBallsSceneTest::prepareSecondaryCommandBuffer(std::size_t threadIndex,
-                                                                std::size_t frameIndex,
-                                                                std::size_t rangeFrom,
-                                                                std::size_t rangeTo)
+void MultithreadedBallsSceneTest::recordBalls(std::size_t rangeFrom, std::size_t rangeTo, std::size_t worker)
 {
     TIME_IT("CmdBuffer (secondary) building");
+    framework::WorkerTimer workerTimer{_threadUtilization};
 
-    // Update test state from own range
-    updateTestState(static_cast<float>(window().frameTime()), rangeFrom, rangeTo);
+    const vk::CommandBuffer& cmdBuffer = workerCommandBuffer(worker);
 
-    // Update secondary command buffer
-    const vk::CommandBuffer& cmdBuffer = _threadCmdPools[threadIndex].cmdBuffers[frameIndex];
+    countDraws(rangeTo - rangeFrom, (rangeTo - rangeFrom) * vertices().size());
+    for (std::size_t ballIndex = rangeFrom; ballIndex < rangeTo; ++ballIndex) {
+        cmdBuffer.pushConstants(_pipelineLayout, vk::ShaderStageFlagBits::eVertex, 0, sizeof(glm::vec4),
+                                &balls()[ballIndex].position);
+        cmdBuffer.pushConstants(_pipelineLayout, vk::ShaderStageFlagBits::eFragment, sizeof(glm::vec4),
+                                sizeof(glm::vec4), &balls()[ballIndex].color);
+        cmdBuffer.draw(static_cast<uint32_t>(vertices().size()), 1, 0, 0);
+    }
+}
 
-    cmdBuffer.reset({});
-    vk::CommandBufferInheritanceInfo inheritanceInfo{_renderPass, 0, _framebuffers[frameIndex], VK_FALSE, {}, {}};
-    cmdBuffer.begin(vk::CommandBufferBeginInfo{vk::CommandBufferUsageFlagBits::eRenderPassContinue |
-                                                   vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
-                                               &inheritanceInfo});
-    {
+const vk::CommandBuffer& MultithreadedBallsSceneTest::workerCommandBuffer(std::size_t worker)
+{
+    vk::CommandBufferInheritanceInfo inheritanceInfo{
+        _renderPass, 0, _framebuffers[_recordedImageIndex], VK_FALSE, {}, {}};
+    bool begun = false;
+    const vk::CommandBuffer& cmdBuffer = _workerCmdBuffers.begin(worker, 0u, inheritanceInfo, begun);
+    if (begun) {
         cmdBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, _pipeline);
         cmdBuffer.bindVertexBuffers(0, {{_vbo.buffer}}, {{0}});
-
-        for (std::size_t ballIndex = rangeFrom; ballIndex < rangeTo; ++ballIndex) {
-            cmdBuffer.pushConstants(_pipelineLayout, vk::ShaderStageFlagBits::eVertex, 0, sizeof(glm::vec4),
-                                    &balls()[ballIndex].position);
-            cmdBuffer.pushConstants(_pipelineLayout, vk::ShaderStageFlagBits::eFragment, sizeof(glm::vec4),
-                                    sizeof(glm::vec4), &balls()[ballIndex].color);
-            cmdBuffer.draw(static_cast<uint32_t>(vertices().size()), 1, 0, 0);
-        }
     }
-    cmdBuffer.end();
+    return cmdBuffer;
 }
 
-void MultithreadedBallsSceneTest::prepareCommandBuffer(std::size_t frameIndex)
+void MultithreadedBallsSceneTest::prepareCommandBuffer(std::size_t imageIndex)
 {
     static const vk::ClearValue clearValue = vk::ClearColorValue{std::array<float, 4>{{0.0f, 0.0f, 0.0f, 1.0f}}};
     vk::RenderPassBeginInfo renderPassInfo{
-        _renderPass, _framebuffers[frameIndex], {{}, {window().size().x, window().size().y}}, 1, &clearValue};
-
-    {
-        TIME_IT("Fence waiting");
-        device().waitForFences(1, &_fences[frameIndex], VK_FALSE, UINT64_MAX);
-        device().resetFences(1, &_fences[frameIndex]);
-    }
+        _renderPass, _framebuffers[imageIndex], {{}, {window().size().x, window().size().y}}, 1, &clearValue};
 
     {
         TIME_IT("CmdBuffer building");
-        const vk::CommandBuffer& cmdBuffer = _cmdBuffers[frameIndex];
+        framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::Driver};
+        const vk::CommandBuffer& cmdBuffer = _cmdBuffers[_frameIndex];
         cmdBuffer.reset({});
         cmdBuffer.begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit, nullptr});
         {
             cmdBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eSecondaryCommandBuffers);
 
-            std::vector<std::thread> threads(_threadCmdPools.size());
-            std::vector<vk::CommandBuffer> threadedCommandBuffers;
-            for (std::size_t threadIndex = 0; threadIndex < _threadCmdPools.size(); ++threadIndex) {
-                std::size_t k = balls().size() / _threadCmdPools.size();
-                std::size_t rangeFrom = threadIndex * k;
-                std::size_t rangeTo = (threadIndex + 1) * k;
-
-                threadedCommandBuffers.push_back(_threadCmdPools[threadIndex].cmdBuffers[frameIndex]);
-
-                threads[threadIndex] =
-                    std::move(std::thread(&MultithreadedBallsSceneTest::prepareSecondaryCommandBuffer, this,
-                                          threadIndex, frameIndex, rangeFrom, rangeTo));
-            }
-            for (auto& thread : threads) {
-                thread.join();
+            framework::ParallelRegionTimer region{_threadUtilization, _workerCmdBuffers.workerCount()};
+            _recordedImageIndex = imageIndex;
+            _workerCmdBuffers.reset(_frameIndex);
+            threadPool().dispatch(_frameGraph);
+            region.beginJoin();
+            threadPool().wait();
+            region.end();
+            if (pipelined()) {
+                swapTestState();
             }
 
-            cmdBuffer.executeCommands(threadedCommandBuffers);
+            cmdBuffer.executeCommands(_workerCmdBuffers.end(0u));
             cmdBuffer.endRenderPass();
         }
         cmdBuffer.end();
     }
 }
 
-void MultithreadedBallsSceneTest::submitCommandBuffer(std::size_t frameIndex)
+void MultithreadedBallsSceneTest::submitCommandBuffer()
 {
     TIME_IT("CmdBuffer submition");
+    framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::Driver};
 
     vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eColorAttachmentOutput;
-    vk::SubmitInfo submits{1, &_acquireSemaphores[_semaphoreIndex], &waitStage, 1, &_cmdBuffers[frameIndex],
-                           1, &_renderSemaphores[_semaphoreIndex]};
-    queues().queue().submit(submits, _fences[frameIndex]);
+    vk::SubmitInfo submits{1, &_acquireSemaphores[_frameIndex], &waitStage, 1, &_cmdBuffers[_frameIndex],
+                           1, &_renderSemaphores[_frameIndex]};
+    queues().queue().submit(submits, _fences[_frameIndex]);
 }
 
-void MultithreadedBallsSceneTest::presentFrame(std::size_t frameIndex)
+void MultithreadedBallsSceneTest::presentFrame(std::size_t imageIndex)
 {
     TIME_IT("Frame presentation");
+    framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::Present};
 
-    uint32_t imageIndex = static_cast<uint32_t>(frameIndex);
-    vk::PresentInfoKHR presentInfo{1,      &_renderSemaphores[_semaphoreIndex], 1, &window().swapchain(), &imageIndex,
-                                   nullptr};
-    queues().queue().presentKHR(presentInfo);
+    window().present(_renderSemaphores[_frameIndex], static_cast<uint32_t>(imageIndex));
 }
 }
 }
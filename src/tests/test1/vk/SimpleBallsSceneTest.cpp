@@ -11,10 +11,10 @@
 
 namespace tests {
 namespace test_vk {
-SimpleBallsSceneTest::SimpleBallsSceneTest(bool benchmarkMode, float benchmarkTime)
-    : BaseBallsSceneTest()
-    , VKTest("SimpleBallsSceneTest", benchmarkMode, benchmarkTime)
-    , _semaphoreIndex(0u)
+SimpleBallsSceneTest::SimpleBallsSceneTest(const framework::TestConfiguration& configuration)
+    : BaseBallsSceneTest(configuration.sceneScale, configuration.sceneDetail)
+    , VKTest("SimpleBallsSceneTest", configuration)
+    , _frameIndex(0u)
 {
 }
 
@@ -22,6 +22,9 @@ void SimpleBallsSceneTest::setup()
 {
     VKTest::setup();
     initTestState();
+    if (pipelined()) {
+        initNextTestState();
+    }
 
     createCommandBuffers();
     createVbo();
@@ -36,17 +39,18 @@ void SimpleBallsSceneTest::setup()
 
 void SimpleBallsSceneTest::run()
 {
-    while (!window().shouldClose()) {
-        TIME_RESET("Frame times:");
+    if (pipelined()) {
+        // Pipelined updates run a frame ahead, so frame N renders the same state as without them
+        updateTestState(static_cast<float>(simulationTimeStep(window().frameTime())));
+    }
 
-        auto frameIndex = getNextFrameIndex();
-        {
-            TIME_IT("State update");
-            updateTestState(static_cast<float>(window().frameTime()));
-        }
-        prepareCommandBuffer(frameIndex);
-        submitCommandBuffer(frameIndex);
-        presentFrame(frameIndex);
+    while (!window().shouldClose()) {
+        beginStateUpdate();
+        auto imageIndex = getNextImageIndex();
+        prepareCommandBuffer(imageIndex);
+        submitCommandBuffer();
+        presentFrame(imageIndex);
+        finishStateUpdate();
 
         window().update();
 
@@ -79,7 +83,7 @@ void SimpleBallsSceneTest::createCommandBuffers()
     vk::CommandPoolCreateFlags cmdPoolFlags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
     _cmdPool = device().createCommandPool({cmdPoolFlags, queues().familyIndex()});
     _cmdBuffers = device().allocateCommandBuffers(
-        {_cmdPool, vk::CommandBufferLevel::ePrimary, static_cast<uint32_t>(window().swapchainImages().size())});
+        {_cmdPool, vk::CommandBufferLevel::ePrimary, static_cast<uint32_t>(framesInFlight())});
 }
 
 void SimpleBallsSceneTest::createVbo()
@@ -100,7 +104,7 @@ void SimpleBallsSceneTest::createVbo()
 
 void SimpleBallsSceneTest::createSemaphores()
 {
-    for (std::size_t i = 0; i < window().swapchainImages().size(); ++i) {
+    for (std::size_t i = 0; i < framesInFlight(); ++i) {
         _acquireSemaphores.push_back(device().createSemaphore({}));
         _renderSemaphores.push_back(device().createSemaphore({}));
     }
@@ -124,7 +128,7 @@ void SimpleBallsSceneTest::createRenderPass()
                                          vk::AttachmentLoadOp::eDontCare,
                                          vk::AttachmentStoreOp::eDontCare,
                                          vk::ImageLayout::eUndefined,
-                                         vk::ImageLayout::ePresentSrcKHR};
+                                         window().presentImageLayout()};
     vk::AttachmentReference colorAttachment{0, vk::ImageLayout::eColorAttachmentOptimal};
     vk::SubpassDescription subpassDesc{
         {}, vk::PipelineBindPoint::eGraphics, 0, nullptr, 1, &colorAttachment, nullptr, nullptr, 0, nullptr};
@@ -308,37 +312,59 @@ std::vector<vk::PipelineShaderStageCreateInfo> SimpleBallsSceneTest::getShaderSt
     return stages;
 }
 
-uint32_t SimpleBallsSceneTest::getNextFrameIndex() const
+void SimpleBallsSceneTest::beginStateUpdate()
 {
-    TIME_IT("Frame image acquisition");
-
-    _semaphoreIndex = (_semaphoreIndex + 1) % _acquireSemaphores.size();
-    auto nextFrameAcquireStatus =
-        device().acquireNextImageKHR(window().swapchain(), UINT64_MAX, _acquireSemaphores[_semaphoreIndex], {});
-
-    if (nextFrameAcquireStatus.result != vk::Result::eSuccess) {
-        throw std::system_error(nextFrameAcquireStatus.result, "Error during acquiring next frame index");
+    float frameTime = static_cast<float>(simulationTimeStep(window().frameTime()));
+    if (!pipelined()) {
+        TIME_IT("State update");
+        updateTestState(frameTime);
+        return;
     }
 
-    return nextFrameAcquireStatus.value;
+    // State of the next frame is computed on a worker, while this one is recorded and submitted
+    threadPool().dispatch(1u, [this, frameTime](std::size_t) {
+        TIME_IT("State update (pipelined)");
+        updateNextTestState(frameTime);
+    });
 }
 
-void SimpleBallsSceneTest::prepareCommandBuffer(std::size_t frameIndex) const
+void SimpleBallsSceneTest::finishStateUpdate()
 {
-    static const vk::ClearValue clearValue = vk::ClearColorValue{std::array<float, 4>{{0.0f, 0.0f, 0.0f, 1.0f}}};
-    const vk::CommandBuffer& cmdBuffer = _cmdBuffers[frameIndex];
+    if (!pipelined())
+        return;
 
-    vk::RenderPassBeginInfo renderPassInfo{
-        _renderPass, _framebuffers[frameIndex], {{}, {window().size().x, window().size().y}}, 1, &clearValue};
+    TIME_IT("State update waiting");
+    threadPool().wait();
+    swapTestState();
+}
 
+uint32_t SimpleBallsSceneTest::getNextImageIndex() const
+{
+    // Frames in flight are used in turn, resources of a frame can be reused once its fence is signaled
+    _frameIndex = (_frameIndex + 1) % _cmdBuffers.size();
     {
         TIME_IT("Fence waiting");
-        device().waitForFences(1, &_fences[frameIndex], VK_FALSE, UINT64_MAX);
-        device().resetFences(1, &_fences[frameIndex]);
+        framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::GpuWait};
+        device().waitForFences(1, &_fences[_frameIndex], VK_FALSE, UINT64_MAX);
+        device().resetFences(1, &_fences[_frameIndex]);
     }
 
+    TIME_IT("Frame image acquisition");
+    framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::Present};
+    return window().acquireNextImage(_acquireSemaphores[_frameIndex]);
+}
+
+void SimpleBallsSceneTest::prepareCommandBuffer(std::size_t imageIndex) const
+{
+    static const vk::ClearValue clearValue = vk::ClearColorValue{std::array<float, 4>{{0.0f, 0.0f, 0.0f, 1.0f}}};
+    const vk::CommandBuffer& cmdBuffer = _cmdBuffers[_frameIndex];
+
+    vk::RenderPassBeginInfo renderPassInfo{
+        _renderPass, _framebuffers[imageIndex], {{}, {window().size().x, window().size().y}}, 1, &clearValue};
+
     {
         TIME_IT("CmdBuffer building");
+        framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::Driver};
         cmdBuffer.reset({});
         cmdBuffer.begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit, nullptr});
         {
@@ -346,6 +372,7 @@ void SimpleBallsSceneTest::prepareCommandBuffer(std::size_t frameIndex) const
             cmdBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
             cmdBuffer.bindVertexBuffers(0, {{_vbo.buffer}}, {{0}});
 
+            countDraws(balls().size(), balls().size() * vertices().size());
             for (const auto& ball : balls()) {
                 cmdBuffer.pushConstants(_pipelineLayout, vk::ShaderStageFlagBits::eVertex, 0, sizeof(glm::vec4),
                                         &ball.position);
@@ -360,24 +387,23 @@ void SimpleBallsSceneTest::prepareCommandBuffer(std::size_t frameIndex) const
     }
 }
 
-void SimpleBallsSceneTest::submitCommandBuffer(std::size_t frameIndex) const
+void SimpleBallsSceneTest::submitCommandBuffer() const
 {
     TIME_IT("CmdBuffer submition");
+    framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::Driver};
 
     vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eColorAttachmentOutput;
-    vk::SubmitInfo submits{1, &_acquireSemaphores[_semaphoreIndex], &waitStage, 1, &_cmdBuffers[frameIndex],
-                           1, &_renderSemaphores[_semaphoreIndex]};
-    queues().queue().submit(submits, _fences[frameIndex]);
+    vk::SubmitInfo submits{1, &_acquireSemaphores[_frameIndex], &waitStage, 1, &_cmdBuffers[_frameIndex],
+                           1, &_renderSemaphores[_frameIndex]};
+    queues().queue().submit(submits, _fences[_frameIndex]);
 }
 
-void SimpleBallsSceneTest::presentFrame(std::size_t frameIndex) const
+void SimpleBallsSceneTest::presentFrame(std::size_t imageIndex) const
 {
     TIME_IT("Frame presentation");
+    framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::Present};
 
-    uint32_t imageIndex = static_cast<uint32_t>(frameIndex);
-    vk::PresentInfoKHR presentInfo{1,      &_renderSemaphores[_semaphoreIndex], 1, &window().swapchain(), &imageIndex,
-                                   nullptr};
-    queues().queue().presentKHR(presentInfo);
+    window().present(_renderSemaphores[_frameIndex], static_cast<uint32_t>(imageIndex));
 }
 }
 }
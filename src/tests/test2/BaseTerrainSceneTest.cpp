@@ -1,7 +1,5 @@
 #include <tests/test2/BaseTerrainSceneTest.h>
 
-#include <GLFW/glfw3.h>
-
 #include <glm/gtc/matrix_transform.hpp>
 
 namespace {
@@ -21,14 +19,20 @@ const glm::mat4 kModelMatrix{1.0f};
 }
 
 namespace tests {
-BaseTerrainSceneTest::BaseTerrainSceneTest()
-    : _terrain({kHeightmapPath, kHeightmapWidth, kHeightmapHeight}, kLoDFactor)
+// Higher LoD factor splits nodes farther from camera, so the terrain is drawn with more (smaller) chunks
+BaseTerrainSceneTest::BaseTerrainSceneTest(float sceneScale)
+    : _terrain({kHeightmapPath, kHeightmapWidth, kHeightmapHeight}, kLoDFactor * sceneScale)
+    , _time(0.0)
 {
+    updateTestState(0.0);
 }
 
-void BaseTerrainSceneTest::updateTestState(double /*dt*/)
+void BaseTerrainSceneTest::updateTestState(double dt)
 {
-    float time = kUpdateTimeFactor * static_cast<float>(glfwGetTime());
+    // Scene time is accumulated from frame times, so it doesn't depend on the windowing library timer
+    _time += dt;
+
+    float time = kUpdateTimeFactor * static_cast<float>(_time);
     _position = kUpdateCenter + glm::vec2{std::cos(time), std::sin(time)} * kUpdateRadius;
 }
 
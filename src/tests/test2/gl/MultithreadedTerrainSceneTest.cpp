@@ -0,0 +1,269 @@
+#include <tests/test2/gl/MultithreadedTerrainSceneTest.h>
+
+#include <base/ScopedTimer.h>
+
+#include <GL/glew.h>
+#include <glm/vec4.hpp>
+
+#include <algorithm>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+// Commands per frame in flight, the buffer grows when a frame selects more chunks
+const std::size_t kInitialCommandCapacity = 1024u;
+}
+
+namespace tests {
+namespace test_gl {
+MultithreadedTerrainSceneTest::MultithreadedTerrainSceneTest(const framework::TestConfiguration& configuration)
+    : BaseTerrainSceneTest(configuration.sceneScale)
+    , GLTest("MultithreadedTerrainSceneTest", configuration)
+    , _ibo(base::gl::Buffer::Target::ElementArray, base::gl::Buffer::Usage::StaticDraw)
+    , _commands(base::gl::Buffer::Target::DrawIndirect)
+    , _frameGraph()
+    , _traverseNode(0u)
+    , _writeNode(0u)
+    , _subtrees()
+    , _subtreeCommands()
+    , _subtreeOffsets()
+    , _commandCount(0u)
+{
+}
+
+void MultithreadedTerrainSceneTest::setup()
+{
+    GLTest::setup();
+    checkExtensions();
+
+    glPolygonMode(GL_FRONT_AND_BACK, GL_LINE);
+
+    initApplication();
+    initProgram();
+    initVBO();
+    initIBO();
+    initVAO();
+    initCommandBuffer();
+    initFrameGraph();
+}
+
+void MultithreadedTerrainSceneTest::run()
+{
+    while (!window_.shouldClose()) {
+        updateTestState(simulationTimeStep(window_.getFrameTime()));
+
+        {
+            TIME_IT("Fence waiting");
+            framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::GpuWait};
+            _commands.beginRegion();
+        }
+
+        prepareCommands();
+
+        {
+            framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::Driver};
+
+            glClear(GL_COLOR_BUFFER_BIT);
+            _program.use();
+            _vao.bind();
+            _ibo.bind(base::gl::Buffer::Target::ElementArray);
+            _commands.bind();
+
+            _program["MVP"] = currentMVP();
+            glMultiDrawElementsIndirect(GL_TRIANGLES, GL_UNSIGNED_INT, (const GLvoid*)_commands.regionOffset(),
+                                        static_cast<GLsizei>(_commandCount), 0);
+            _commands.endRegion();
+
+            _commands.unbind();
+            _ibo.unbind();
+            _vao.unbind();
+            _program.unbind();
+        }
+
+        updateWindow();
+
+        if (processFrameTime(window_.getFrameTime())) {
+            break; // Benchmarking is complete
+        }
+    }
+}
+
+void MultithreadedTerrainSceneTest::teardown()
+{
+    _commands.destroy();
+
+    GLTest::teardown();
+}
+
+void MultithreadedTerrainSceneTest::checkExtensions() const
+{
+    if (!base::gl::MappedRingBuffer::isSupported() || !(GLEW_VERSION_4_3 || GLEW_ARB_multi_draw_indirect)) {
+        throw std::runtime_error{"Multithreaded OpenGL terrain test needs buffer storage and multi draw indirect "
+                                 "(OpenGL 4.4 or ARB_buffer_storage and ARB_multi_draw_indirect)!"};
+    }
+}
+
+void MultithreadedTerrainSceneTest::initApplication()
+{
+    window_.setDisplayingFPS(true);
+    window_.setFPSRefreshRate(1.0);
+
+    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+}
+
+void MultithreadedTerrainSceneTest::initProgram()
+{
+    _program.load({"resources/test2/shaders/gl_shader.vert", base::gl::Shader::Type::VertexShader},
+                  {"resources/test2/shaders/gl_shader.frag", base::gl::Shader::Type::FragmentShader});
+}
+
+void MultithreadedTerrainSceneTest::initVBO()
+{
+    // VertexData
+    base::gl::VertexBuffer::Data vertexData;
+    vertexData.data = (GLvoid*)(terrain().vertices().data());
+    vertexData.size = sizeof(glm::vec4) * terrain().vertices().size();
+    vertexData.pointers.push_back(base::gl::VertexAttrib(0, 4, GL_FLOAT, 0, nullptr));
+
+    // VBO settings
+    _vbo.bind();
+    _vbo.setData(vertexData);
+    _vbo.unbind();
+}
+
+void MultithreadedTerrainSceneTest::initIBO()
+{
+    _ibo.bind(base::gl::Buffer::Target::ElementArray);
+    _ibo.setData(terrain().indices());
+    _ibo.unbind();
+}
+
+void MultithreadedTerrainSceneTest::initVAO()
+{
+    _vao.setDrawTarget(base::gl::VertexArray::DrawTarget::Triangles);
+
+    _vao.bind();
+    _vao.attachVBO(&_vbo);
+    _vao.setAttribPointers();
+    _vao.unbind();
+}
+
+void MultithreadedTerrainSceneTest::initCommandBuffer()
+{
+    _commands.allocate(static_cast<GLsizeiptr>(kInitialCommandCapacity * sizeof(DrawElementsIndirectCommand)));
+}
+
+void MultithreadedTerrainSceneTest::initFrameGraph()
+{
+    // Ranges of traversal and writing are set each frame, as the number of subtrees depends on position
+    _traverseNode = _frameGraph.add([this](std::size_t rangeFrom, std::size_t rangeTo, std::size_t) {
+        traverseSubtrees(rangeFrom, rangeTo);
+    });
+    base::TaskGraph::Node gather =
+        _frameGraph.add([this](std::size_t, std::size_t, std::size_t) { gatherCommands(); });
+    _writeNode = _frameGraph.add([this](std::size_t rangeFrom, std::size_t rangeTo, std::size_t) {
+        writeCommands(rangeFrom, rangeTo);
+    });
+    _frameGraph.precede(_traverseNode, gather);
+    _frameGraph.precede(gather, _writeNode);
+    _frameGraph.setRanges(gather, {0u, 1u});
+}
+
+void MultithreadedTerrainSceneTest::traverseSubtrees(std::size_t rangeFrom, std::size_t rangeTo)
+{
+    TIME_IT("LoD traversal");
+    framework::WorkerTimer worker{_threadUtilization};
+
+    auto indexSize = sizeof(terrain().indices().front());
+    std::size_t draws = 0u;
+    std::size_t drawnVertices = 0u;
+    for (std::size_t subtreeIndex = rangeFrom; subtreeIndex < rangeTo; ++subtreeIndex) {
+        std::vector<DrawElementsIndirectCommand>& commands = _subtreeCommands[subtreeIndex];
+        commands.clear();
+        terrain().executeLoD(currentPosition(),
+                             [&commands, &drawnVertices, indexSize](std::size_t count, std::ptrdiff_t offset) {
+                                 drawnVertices += count;
+                                 commands.push_back(DrawElementsIndirectCommand{
+                                     static_cast<GLuint>(count), 1u, static_cast<GLuint>(offset / indexSize), 0, 0u});
+                             },
+                             *_subtrees[subtreeIndex]);
+        draws += commands.size();
+    }
+    countDraws(draws, drawnVertices);
+}
+
+void MultithreadedTerrainSceneTest::gatherCommands()
+{
+    framework::WorkerTimer worker{_threadUtilization};
+
+    // Commands keep the order of subtrees, so each frame draws them in the same order
+    _commandCount = 0u;
+    for (std::size_t subtreeIndex = 0; subtreeIndex < _subtrees.size(); ++subtreeIndex) {
+        _subtreeOffsets[subtreeIndex] = _commandCount;
+        _commandCount += _subtreeCommands[subtreeIndex].size();
+    }
+}
+
+void MultithreadedTerrainSceneTest::writeCommands(std::size_t rangeFrom, std::size_t rangeTo)
+{
+    TIME_IT("Indirect commands writing");
+    framework::WorkerTimer worker{_threadUtilization};
+
+    // Commands which don't fit are written again once the buffer grows
+    if (_commandCount > commandCapacity())
+        return;
+
+    auto target = static_cast<DrawElementsIndirectCommand*>(_commands.regionData());
+    for (std::size_t subtreeIndex = rangeFrom; subtreeIndex < rangeTo; ++subtreeIndex) {
+        const std::vector<DrawElementsIndirectCommand>& commands = _subtreeCommands[subtreeIndex];
+        if (!commands.empty()) {
+            std::memcpy(target + _subtreeOffsets[subtreeIndex], commands.data(),
+                        commands.size() * sizeof(DrawElementsIndirectCommand));
+        }
+    }
+}
+
+std::size_t MultithreadedTerrainSceneTest::commandCapacity() const
+{
+    return static_cast<std::size_t>(_commands.regionSize()) / sizeof(DrawElementsIndirectCommand);
+}
+
+void MultithreadedTerrainSceneTest::prepareCommands()
+{
+    TIME_IT("Indirect commands building");
+
+    // Quad-tree is split deep enough to give every worker several subtrees to traverse
+    terrain().splitLoD(currentPosition(), threadPool().workerRanges(), _subtrees);
+    if (_subtreeCommands.size() < _subtrees.size()) {
+        _subtreeCommands.resize(_subtrees.size());
+        _subtreeOffsets.resize(_subtrees.size());
+    }
+    std::vector<std::size_t> boundaries = base::ThreadPool::splitEvenly(_subtrees.size(), _subtrees.size());
+    _frameGraph.setRanges(_traverseNode, boundaries);
+    _frameGraph.setRanges(_writeNode, boundaries);
+
+    {
+        framework::ParallelRegionTimer region{_threadUtilization, workerThreads()};
+        threadPool().dispatch(_frameGraph);
+        region.beginJoin();
+        threadPool().wait();
+        region.end();
+    }
+
+    // Rare, the new buffer is big enough for this frame and most of the following ones
+    if (_commandCount > commandCapacity()) {
+        std::size_t capacity = std::max(2u * commandCapacity(), _commandCount);
+        _commands.allocate(static_cast<GLsizeiptr>(capacity * sizeof(DrawElementsIndirectCommand)));
+        _commands.beginRegion();
+
+        framework::ParallelRegionTimer region{_threadUtilization, workerThreads()};
+        threadPool().dispatch(boundaries, [this](std::size_t rangeFrom, std::size_t rangeTo, std::size_t) {
+            writeCommands(rangeFrom, rangeTo);
+        });
+        region.beginJoin();
+        threadPool().wait();
+        region.end();
+    }
+}
+}
+}
@@ -5,9 +5,9 @@
 
 namespace tests {
 namespace test_gl {
-TerrainSceneTest::TerrainSceneTest(bool benchmarkMode, float benchmarkTime)
-    : BaseTerrainSceneTest()
-    , GLTest("TerrainSceneTest", benchmarkMode, benchmarkTime)
+TerrainSceneTest::TerrainSceneTest(const framework::TestConfiguration& configuration)
+    : BaseTerrainSceneTest(configuration.sceneScale)
+    , GLTest("TerrainSceneTest", configuration)
     , _ibo(base::gl::Buffer::Target::ElementArray, base::gl::Buffer::Usage::StaticDraw)
 {
 }
@@ -28,25 +28,32 @@ void TerrainSceneTest::setup()
 void TerrainSceneTest::run()
 {
     while (!window_.shouldClose()) {
-        glClear(GL_COLOR_BUFFER_BIT);
-        _program.use();
-        _vao.bind();
-        _ibo.bind(base::gl::Buffer::Target::ElementArray);
+        updateTestState(simulationTimeStep(window_.getFrameTime()));
 
-        _program["MVP"] = currentMVP();
         {
-            auto renderChunk = [](std::size_t count, std::ptrdiff_t offset) {
-                glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, (const GLvoid*)offset);
-            };
-            terrain().executeLoD(currentPosition(), renderChunk);
+            // LoD selection is interleaved with draw calls, so it's measured as driver time too
+            framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::Driver};
+
+            glClear(GL_COLOR_BUFFER_BIT);
+            _program.use();
+            _vao.bind();
+            _ibo.bind(base::gl::Buffer::Target::ElementArray);
+
+            _program["MVP"] = currentMVP();
+            {
+                auto renderChunk = [this](std::size_t count, std::ptrdiff_t offset) {
+                    countDraws(1u, count);
+                    glDrawElements(GL_TRIANGLES, count, GL_UNSIGNED_INT, (const GLvoid*)offset);
+                };
+                terrain().executeLoD(currentPosition(), renderChunk);
+            }
+
+            _ibo.unbind();
+            _vao.unbind();
+            _program.unbind();
         }
 
-        _ibo.unbind();
-        _vao.unbind();
-        _program.unbind();
-
-        window_.update();
-        updateTestState(window_.getFrameTime());
+        updateWindow();
 
         if (processFrameTime(window_.getFrameTime())) {
             break; // Benchmarking is complete
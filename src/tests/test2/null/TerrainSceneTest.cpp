@@ -0,0 +1,43 @@
+#include <tests/test2/null/TerrainSceneTest.h>
+
+namespace tests {
+namespace test_null {
+TerrainSceneTest::TerrainSceneTest(const framework::TestConfiguration& configuration)
+    : BaseTerrainSceneTest(configuration.sceneScale)
+    , NullTest("TerrainSceneTest", configuration)
+{
+}
+
+void TerrainSceneTest::setup()
+{
+    NullTest::setup();
+}
+
+void TerrainSceneTest::run()
+{
+    while (!shouldClose()) {
+        updateTestState(simulationTimeStep(frameTime()));
+
+        setUniform(currentMVP());
+        {
+            auto renderChunk = [this](std::size_t count, std::ptrdiff_t offset) {
+                countDraws(1u, count);
+                draw(count, offset);
+            };
+            terrain().executeLoD(currentPosition(), renderChunk);
+        }
+
+        update();
+
+        if (processFrameTime(frameTime())) {
+            break; // Benchmarking is complete
+        }
+    }
+}
+
+void TerrainSceneTest::teardown()
+{
+    NullTest::teardown();
+}
+}
+}
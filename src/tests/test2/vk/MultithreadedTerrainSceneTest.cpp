@@ -6,15 +6,21 @@
 #include <glm/vec4.hpp>
 #include <vulkan/vulkan.hpp>
 
-#include <thread>
 #include <vector>
 
 namespace tests {
 namespace test_vk {
-MultithreadedTerrainSceneTest::MultithreadedTerrainSceneTest(bool benchmarkMode, float benchmarkTime)
-    : BaseTerrainSceneTest()
-    , VKTest("MultithreadedTerrainSceneTest", benchmarkMode, benchmarkTime)
+MultithreadedTerrainSceneTest::MultithreadedTerrainSceneTest(const framework::TestConfiguration& configuration)
+    : BaseTerrainSceneTest(configuration.sceneScale)
+    , VKTest("MultithreadedTerrainSceneTest", configuration)
+    , _workerCmdBuffers()
     , _semaphoreIndex(0u)
+    , _frameGraph()
+    , _traverseNode(0u)
+    , _subtrees()
+    , _subtreeChunks()
+    , _chunks()
+    , _recordedFrameIndex(0u)
 {
 }
 
@@ -33,16 +39,15 @@ void MultithreadedTerrainSceneTest::setup()
     createShaders();
     createPipelineLayout();
     createPipeline();
+    createFrameGraph();
 }
 
 void MultithreadedTerrainSceneTest::run()
 {
     while (!window().shouldClose()) {
-        TIME_RESET("Frame times:");
-
         auto frameIndex = getNextFrameIndex();
 
-        updateTestState(static_cast<float>(window().frameTime()));
+        updateTestState(static_cast<float>(simulationTimeStep(window().frameTime())));
         prepareCommandBuffer(frameIndex);
         submitCommandBuffer(frameIndex);
         presentFrame(frameIndex);
@@ -84,17 +89,8 @@ void MultithreadedTerrainSceneTest::createCommandBuffers()
 
 void MultithreadedTerrainSceneTest::createSecondaryCommandBuffers()
 {
-    // TODO: think on how to extend this for arbitrary std::thread::hardware_concurrency() value
-    static const std::size_t threads = 4;
-
-    _threadCmdPools.resize(threads);
-    for (auto& sndCmdPool : _threadCmdPools) {
-        vk::CommandPoolCreateFlags cmdPoolFlags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
-        sndCmdPool.cmdPool = device().createCommandPool({cmdPoolFlags, queues().familyIndex()});
-        sndCmdPool.cmdBuffers =
-            device().allocateCommandBuffers({sndCmdPool.cmdPool, vk::CommandBufferLevel::eSecondary,
-                                             static_cast<uint32_t>(window().swapchainImages().size())});
-    }
+    _workerCmdBuffers =
+        base::vkx::WorkerCommandBuffers(device(), queues(), workerThreads(), window().swapchainImages().size());
 }
 
 void MultithreadedTerrainSceneTest::createVbo()
@@ -155,7 +151,7 @@ void MultithreadedTerrainSceneTest::createRenderPass()
                                          vk::AttachmentLoadOp::eDontCare,
                                          vk::AttachmentStoreOp::eDontCare,
                                          vk::ImageLayout::eUndefined,
-                                         vk::ImageLayout::ePresentSrcKHR};
+                                         window().presentImageLayout()};
 
     vk::AttachmentReference colorAttachment{0, vk::ImageLayout::eColorAttachmentOptimal};
     vk::SubpassDescription subpassDesc{
@@ -265,6 +261,25 @@ void MultithreadedTerrainSceneTest::createPipeline()
     _pipeline = device().createGraphicsPipeline({}, pipelineInfo);
 }
 
+void MultithreadedTerrainSceneTest::createFrameGraph()
+{
+    // Ranges of traversal are set each frame, as the number of subtrees depends on position
+    _traverseNode = _frameGraph.add([this](std::size_t rangeFrom, std::size_t rangeTo, std::size_t) {
+        traverseSubtrees(rangeFrom, rangeTo);
+    });
+    base::TaskGraph::Node gather =
+        _frameGraph.add([this](std::size_t, std::size_t, std::size_t) { gatherChunks(); });
+    base::TaskGraph::Node record =
+        _frameGraph.add([this](std::size_t sliceFrom, std::size_t sliceTo, std::size_t worker) {
+            recordChunks(sliceFrom, sliceTo, worker);
+        });
+    _frameGraph.precede(_traverseNode, gather);
+    _frameGraph.precede(gather, record);
+    _frameGraph.setRanges(gather, {0u, 1u});
+    _frameGraph.setRanges(record, base::ThreadPool::splitEvenly(threadPool().workerRanges(),
+                                                                threadPool().workerRanges()));
+}
+
 void MultithreadedTerrainSceneTest::destroyPipeline()
 {
     device().destroyPipeline(_pipeline);
@@ -326,11 +341,7 @@ void MultithreadedTerrainSceneTest::destroyVbo()
 
 void MultithreadedTerrainSceneTest::destroySecondaryCommandBuffers()
 {
-    for (auto& threadCmdPool : _threadCmdPools) {
-        device().destroyCommandPool(threadCmdPool.cmdPool);
-        threadCmdPool.cmdBuffers.clear();
-    }
-    _threadCmdPools.clear();
+    _workerCmdBuffers = base::vkx::WorkerCommandBuffers{};
 }
 
 void MultithreadedTerrainSceneTest::destroyCommandBuffers()
@@ -356,53 +367,80 @@ std::vector<vk::PipelineShaderStageCreateInfo> MultithreadedTerrainSceneTest::ge
 uint32_t MultithreadedTerrainSceneTest::getNextFrameIndex() const
 {
     TIME_IT("Frame image acquisition");
+    framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::Present};
 
     _semaphoreIndex = (_semaphoreIndex + 1) % _acquireSemaphores.size();
-    auto nextFrameAcquireStatus =
-        device().acquireNextImageKHR(window().swapchain(), UINT64_MAX, _acquireSemaphores[_semaphoreIndex], {});
+    return window().acquireNextImage(_acquireSemaphores[_semaphoreIndex]);
+}
+
+void MultithreadedTerrainSceneTest::traverseSubtrees(std::size_t rangeFrom, std::size_t rangeTo)
+{
+    TIME_IT("LoD traversal");
+    framework::WorkerTimer worker{_threadUtilization};
 
-    if (nextFrameAcquireStatus.result != vk::Result::eSuccess) {
-        throw std::system_error(nextFrameAcquireStatus.result, "Error during acquiring next frame index");
+    for (std::size_t subtreeIndex = rangeFrom; subtreeIndex < rangeTo; ++subtreeIndex) {
+        std::vector<Chunk>& chunks = _subtreeChunks[subtreeIndex];
+        chunks.clear();
+        terrain().executeLoD(currentPosition(),
+                             [&chunks](std::size_t count, std::ptrdiff_t offset) {
+                                 chunks.push_back(Chunk{count, offset});
+                             },
+                             *_subtrees[subtreeIndex]);
     }
+}
 
-    return nextFrameAcquireStatus.value;
+void MultithreadedTerrainSceneTest::gatherChunks()
+{
+    framework::WorkerTimer worker{_threadUtilization};
+
+    // Chunks keep the order of subtrees, so each frame draws them in the same order
+    _chunks.clear();
+    for (std::size_t subtreeIndex = 0; subtreeIndex < _subtrees.size(); ++subtreeIndex) {
+        _chunks.insert(_chunks.end(), _subtreeChunks[subtreeIndex].begin(), _subtreeChunks[subtreeIndex].end());
+    }
 }
 
-void MultithreadedTerrainSceneTest::prepareSecondaryCommandBuffer(std::size_t threadIndex, std::size_t frameIndex) const
+void MultithreadedTerrainSceneTest::recordChunks(std::size_t sliceFrom, std::size_t sliceTo, std::size_t worker)
 {
     TIME_IT("CmdBuffer (secondary) building");
+    framework::WorkerTimer workerTimer{_threadUtilization};
+
+    // Slices split the chunk list evenly, whichever subtrees the chunks came from
+    std::size_t slices = threadPool().workerRanges();
+    std::size_t chunkFrom = _chunks.size() * sliceFrom / slices;
+    std::size_t chunkTo = _chunks.size() * sliceTo / slices;
+    if (chunkFrom == chunkTo)
+        return;
+
+    const vk::CommandBuffer& cmdBuffer = workerCommandBuffer(worker);
+    auto indexSize = sizeof(terrain().indices().front());
+    std::size_t drawnVertices = 0u;
+    for (std::size_t chunkIndex = chunkFrom; chunkIndex < chunkTo; ++chunkIndex) {
+        const Chunk& chunk = _chunks[chunkIndex];
+        drawnVertices += chunk.indexCount;
+        cmdBuffer.drawIndexed(chunk.indexCount, 1, chunk.indexOffset / indexSize, 0, 0);
+    }
+    countDraws(chunkTo - chunkFrom, drawnVertices);
+}
 
-    // Update secondary command buffer
-    const vk::CommandBuffer& cmdBuffer = _threadCmdPools[threadIndex].cmdBuffers[frameIndex];
-
-    cmdBuffer.reset({});
-    vk::CommandBufferInheritanceInfo inheritanceInfo{_renderPass, 0, _framebuffers[frameIndex], VK_FALSE, {}, {}};
-    cmdBuffer.begin(vk::CommandBufferBeginInfo{vk::CommandBufferUsageFlagBits::eRenderPassContinue |
-                                                   vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
-                                               &inheritanceInfo});
-    {
+const vk::CommandBuffer& MultithreadedTerrainSceneTest::workerCommandBuffer(std::size_t worker)
+{
+    vk::CommandBufferInheritanceInfo inheritanceInfo{
+        _renderPass, 0, _framebuffers[_recordedFrameIndex], VK_FALSE, {}, {}};
+    bool begun = false;
+    const vk::CommandBuffer& cmdBuffer = _workerCmdBuffers.begin(worker, 0u, inheritanceInfo, begun);
+    if (begun) {
         cmdBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, _pipeline);
         cmdBuffer.bindVertexBuffers(0, {{_vbo.buffer}}, {{0}});
         cmdBuffer.bindIndexBuffer(_ibo.buffer, 0, vk::IndexType::eUint32);
 
-        {
-            glm::mat4 MVP = base::vkx::fixGLMatrix(currentMVP()); // flip Y and fix Z axes
-            cmdBuffer.pushConstants(_pipelineLayout, vk::ShaderStageFlagBits::eVertex, 0, sizeof(MVP), &MVP);
-        }
-
-        {
-            auto indexSize = sizeof(terrain().indices().front());
-            auto renderChunk = [&cmdBuffer, indexSize](std::size_t count, std::ptrdiff_t offset) {
-                cmdBuffer.drawIndexed(count, 1, offset / indexSize, 0, 0);
-            };
-            // TODO: think on how to extend this beyond 4-threads
-            terrain().executeLoD(currentPosition(), renderChunk, threadIndex);
-        }
+        glm::mat4 MVP = base::vkx::fixGLMatrix(currentMVP()); // flip Y and fix Z axes
+        cmdBuffer.pushConstants(_pipelineLayout, vk::ShaderStageFlagBits::eVertex, 0, sizeof(MVP), &MVP);
     }
-    cmdBuffer.end();
+    return cmdBuffer;
 }
 
-void MultithreadedTerrainSceneTest::prepareCommandBuffer(std::size_t frameIndex) const
+void MultithreadedTerrainSceneTest::prepareCommandBuffer(std::size_t frameIndex)
 {
     static const vk::ClearValue clearValue = vk::ClearColorValue{std::array<float, 4>{{0.0f, 0.0f, 0.0f, 1.0f}}};
     vk::RenderPassBeginInfo renderPassInfo{
@@ -410,6 +448,7 @@ void MultithreadedTerrainSceneTest::prepareCommandBuffer(std::size_t frameIndex)
 
     {
         TIME_IT("Fence waiting");
+        framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::GpuWait};
         device().waitForFences(1, &_fences[frameIndex], VK_FALSE, UINT64_MAX);
         device().resetFences(1, &_fences[frameIndex]);
     }
@@ -417,26 +456,29 @@ void MultithreadedTerrainSceneTest::prepareCommandBuffer(std::size_t frameIndex)
     {
         // Multithreaded version
         TIME_IT("CmdBuffer building");
+        framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::Driver};
         const vk::CommandBuffer& cmdBuffer = _cmdBuffers[frameIndex];
         cmdBuffer.reset({});
         cmdBuffer.begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit, nullptr});
         {
             cmdBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eSecondaryCommandBuffers);
 
-            std::vector<std::thread> threads(_threadCmdPools.size());
-            std::vector<vk::CommandBuffer> threadedCommandBuffers;
-            for (std::size_t threadIndex = 0; threadIndex < _threadCmdPools.size(); ++threadIndex) {
-                threadedCommandBuffers.push_back(_threadCmdPools[threadIndex].cmdBuffers[frameIndex]);
-
-                threads[threadIndex] =
-                    std::move(std::thread(&MultithreadedTerrainSceneTest::prepareSecondaryCommandBuffer, this,
-                                          threadIndex, frameIndex));
-            }
-            for (auto& thread : threads) {
-                thread.join();
+            framework::ParallelRegionTimer region{_threadUtilization, _workerCmdBuffers.workerCount()};
+            // Quad-tree is split deep enough to give every worker several subtrees to traverse
+            terrain().splitLoD(currentPosition(), threadPool().workerRanges(), _subtrees);
+            if (_subtreeChunks.size() < _subtrees.size()) {
+                _subtreeChunks.resize(_subtrees.size());
             }
+            _frameGraph.setRanges(_traverseNode, base::ThreadPool::splitEvenly(_subtrees.size(), _subtrees.size()));
+
+            _recordedFrameIndex = frameIndex;
+            _workerCmdBuffers.reset(frameIndex);
+            threadPool().dispatch(_frameGraph);
+            region.beginJoin();
+            threadPool().wait();
+            region.end();
 
-            cmdBuffer.executeCommands(threadedCommandBuffers);
+            cmdBuffer.executeCommands(_workerCmdBuffers.end(0u));
             cmdBuffer.endRenderPass();
         }
         cmdBuffer.end();
@@ -446,6 +488,7 @@ void MultithreadedTerrainSceneTest::prepareCommandBuffer(std::size_t frameIndex)
 void MultithreadedTerrainSceneTest::submitCommandBuffer(std::size_t frameIndex) const
 {
     TIME_IT("CmdBuffer submition");
+    framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::Driver};
 
     vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eColorAttachmentOutput;
     vk::SubmitInfo submits{1, &_acquireSemaphores[_semaphoreIndex], &waitStage, 1, &_cmdBuffers[frameIndex],
@@ -456,11 +499,9 @@ void MultithreadedTerrainSceneTest::submitCommandBuffer(std::size_t frameIndex)
 void MultithreadedTerrainSceneTest::presentFrame(std::size_t frameIndex) const
 {
     TIME_IT("Frame presentation");
+    framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::Present};
 
-    uint32_t imageIndex = static_cast<uint32_t>(frameIndex);
-    vk::PresentInfoKHR presentInfo{1,      &_renderSemaphores[_semaphoreIndex], 1, &window().swapchain(), &imageIndex,
-                                   nullptr};
-    queues().queue().presentKHR(presentInfo);
+    window().present(_renderSemaphores[_semaphoreIndex], static_cast<uint32_t>(frameIndex));
 }
 }
 }
@@ -8,9 +8,9 @@
 
 namespace tests {
 namespace test_vk {
-TerrainSceneTest::TerrainSceneTest(bool benchmarkMode, float benchmarkTime)
-    : BaseTerrainSceneTest()
-    , VKTest("TerrainSceneTest", benchmarkMode, benchmarkTime)
+TerrainSceneTest::TerrainSceneTest(const framework::TestConfiguration& configuration)
+    : BaseTerrainSceneTest(configuration.sceneScale)
+    , VKTest("TerrainSceneTest", configuration)
     , _semaphoreIndex(0u)
 {
 }
@@ -34,11 +34,9 @@ void TerrainSceneTest::setup()
 void TerrainSceneTest::run()
 {
     while (!window().shouldClose()) {
-        TIME_RESET("Frame times:");
-
         auto frameIndex = getNextFrameIndex();
 
-        updateTestState(static_cast<float>(window().frameTime()));
+        updateTestState(static_cast<float>(simulationTimeStep(window().frameTime())));
         prepareCommandBuffer(frameIndex);
         submitCommandBuffer(frameIndex);
         presentFrame(frameIndex);
@@ -135,7 +133,7 @@ void TerrainSceneTest::createRenderPass()
                                          vk::AttachmentLoadOp::eDontCare,
                                          vk::AttachmentStoreOp::eDontCare,
                                          vk::ImageLayout::eUndefined,
-                                         vk::ImageLayout::ePresentSrcKHR};
+                                         window().presentImageLayout()};
 
     vk::AttachmentReference colorAttachment{0, vk::ImageLayout::eColorAttachmentOptimal};
     vk::SubpassDescription subpassDesc{
@@ -327,16 +325,10 @@ std::vector<vk::PipelineShaderStageCreateInfo> TerrainSceneTest::getShaderStages
 uint32_t TerrainSceneTest::getNextFrameIndex() const
 {
     TIME_IT("Frame image acquisition");
+    framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::Present};
 
     _semaphoreIndex = (_semaphoreIndex + 1) % _acquireSemaphores.size();
-    auto nextFrameAcquireStatus =
-        device().acquireNextImageKHR(window().swapchain(), UINT64_MAX, _acquireSemaphores[_semaphoreIndex], {});
-
-    if (nextFrameAcquireStatus.result != vk::Result::eSuccess) {
-        throw std::system_error(nextFrameAcquireStatus.result, "Error during acquiring next frame index");
-    }
-
-    return nextFrameAcquireStatus.value;
+    return window().acquireNextImage(_acquireSemaphores[_semaphoreIndex]);
 }
 
 void TerrainSceneTest::prepareCommandBuffer(std::size_t frameIndex) const
@@ -349,12 +341,14 @@ void TerrainSceneTest::prepareCommandBuffer(std::size_t frameIndex) const
 
     {
         TIME_IT("Fence waiting");
+        framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::GpuWait};
         device().waitForFences(1, &_fences[frameIndex], VK_FALSE, UINT64_MAX);
         device().resetFences(1, &_fences[frameIndex]);
     }
 
     {
         TIME_IT("CmdBuffer building");
+        framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::Driver};
         cmdBuffer.reset({});
         cmdBuffer.begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit, nullptr});
         {
@@ -370,7 +364,8 @@ void TerrainSceneTest::prepareCommandBuffer(std::size_t frameIndex) const
 
             {
                 auto indexSize = sizeof(terrain().indices().front());
-                auto renderChunk = [&cmdBuffer, indexSize](std::size_t count, std::ptrdiff_t offset) {
+                auto renderChunk = [this, &cmdBuffer, indexSize](std::size_t count, std::ptrdiff_t offset) {
+                    countDraws(1u, count);
                     cmdBuffer.drawIndexed(count, 1, offset / indexSize, 0, 0);
                 };
                 terrain().executeLoD(currentPosition(), renderChunk);
@@ -385,6 +380,7 @@ void TerrainSceneTest::prepareCommandBuffer(std::size_t frameIndex) const
 void TerrainSceneTest::submitCommandBuffer(std::size_t frameIndex) const
 {
     TIME_IT("CmdBuffer submition");
+    framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::Driver};
 
     vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eColorAttachmentOutput;
     vk::SubmitInfo submits{1, &_acquireSemaphores[_semaphoreIndex], &waitStage, 1, &_cmdBuffers[frameIndex],
@@ -395,11 +391,9 @@ void TerrainSceneTest::submitCommandBuffer(std::size_t frameIndex) const
 void TerrainSceneTest::presentFrame(std::size_t frameIndex) const
 {
     TIME_IT("Frame presentation");
+    framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::Present};
 
-    uint32_t imageIndex = static_cast<uint32_t>(frameIndex);
-    vk::PresentInfoKHR presentInfo{1,      &_renderSemaphores[_semaphoreIndex], 1, &window().swapchain(), &imageIndex,
-                                   nullptr};
-    queues().queue().presentKHR(presentInfo);
+    window().present(_renderSemaphores[_semaphoreIndex], static_cast<uint32_t>(frameIndex));
 }
 }
 }
@@ -3,9 +3,11 @@
 #include <tests/common/CubeVerticesGenerator.h>
 #include <tests/common/SphereVerticesGenerator.h>
 
-#include <GLFW/glfw3.h>
 #include <glm/gtc/matrix_transform.hpp>
 
+#include <algorithm>
+#include <cmath>
+
 namespace {
 const float kFoV = 45.0f;
 const float kAspectRatio = 800.0f / 600.0f;
@@ -16,6 +18,19 @@ const glm::vec2 kClipDistances = {1.0f, 2000.0f};
 const glm::vec3 kLightDirection = {1.0f, -0.5f, 0.5f};
 const glm::vec3 kLightPosition = glm::normalize(-kLightDirection) * 5.0f;
 const glm::uvec2 kShadowmapSize = { 4096, 4096 };
+const unsigned int kMinShadowmapSize = 512;
+const unsigned int kMaxShadowmapSize = 8192;
+const int kGridHalfSize = 10;         // floor tiles and boxes in each direction from the center
+const std::size_t kSphereDetail = 30; // slices and stacks
+
+glm::uvec2 scaledShadowmapSize(float sceneDetail)
+{
+    auto scaled = [sceneDetail](unsigned int size) -> unsigned int {
+        auto result = static_cast<unsigned int>(static_cast<float>(size) * sceneDetail);
+        return std::min(std::max(result, kMinShadowmapSize), kMaxShadowmapSize);
+    };
+    return {scaled(kShadowmapSize.x), scaled(kShadowmapSize.y)};
+}
 
 std::vector<glm::vec4> generateColorBuffer(std::size_t count, const glm::vec4& color)
 {
@@ -24,19 +39,24 @@ std::vector<glm::vec4> generateColorBuffer(std::size_t count, const glm::vec4& c
 }
 
 namespace tests {
-BaseShadowMappingSceneTest::BaseShadowMappingSceneTest()
+BaseShadowMappingSceneTest::BaseShadowMappingSceneTest(float sceneScale, float sceneDetail)
     : _renderMatrix(1.0f)
     , _shadowMatrix(1.0f)
+    , _shadowmapSize(scaledShadowmapSize(sceneDetail))
     , _projectionMatrix(1.0f)
     , _viewMatrix(1.0f)
+    , _time(0.0)
 {
     initMatrices();
-    createRenderObjects();
+    createRenderObjects(sceneScale, sceneDetail);
 }
 
-void BaseShadowMappingSceneTest::updateTestState(double /*dt*/)
+void BaseShadowMappingSceneTest::updateTestState(double dt)
 {
-    double time = glfwGetTime() * kUpdateTimeFactor;
+    // Scene time is accumulated from frame times, so it doesn't depend on the windowing library timer
+    _time += dt;
+
+    double time = _time * kUpdateTimeFactor;
     _viewMatrix = glm::lookAt(glm::vec3{std::cos(time) * 10.0, 5.0, std::sin(time) * 10.0}, //
                               kCameraTarget, //
                               glm::vec3{0.0f, 1.0f, 0.0f});
@@ -60,7 +80,7 @@ const glm::mat4& BaseShadowMappingSceneTest::shadowMatrix() const
 
 const glm::uvec2& BaseShadowMappingSceneTest::shadowmapSize() const
 {
-    return kShadowmapSize;
+    return _shadowmapSize;
 }
 
 void BaseShadowMappingSceneTest::initMatrices()
@@ -74,11 +94,16 @@ void BaseShadowMappingSceneTest::initMatrices()
     _shadowMatrix = shadowProjectionMatrix * shadowViewMatrix;
 }
 
-void BaseShadowMappingSceneTest::createRenderObjects()
+void BaseShadowMappingSceneTest::createRenderObjects(float sceneScale, float sceneDetail)
 {
+    // Both grids have (2 * gridHalfSize)^2 objects, so their number grows linearly with scale
+    int gridHalfSize = std::max(static_cast<int>(std::lround(kGridHalfSize * std::sqrt(sceneScale))), 1);
+    auto sphereDetail = static_cast<std::size_t>(std::lround(static_cast<float>(kSphereDetail) * sceneDetail));
+    sphereDetail = std::max<std::size_t>(sphereDetail, 3u);
+
     // Bottom
-    for (int x = -10; x < 10; ++x) {
-        for (int y = -10; y < 10; ++y) {
+    for (int x = -gridHalfSize; x < gridHalfSize; ++x) {
+        for (int y = -gridHalfSize; y < gridHalfSize; ++y) {
             common::CubeVerticesGenerator cubeGenerator;
             glm::mat4 cubeModelMatrix(1.0f);
             glm::vec4 cubeColor = {0.4f, 0.4f, 0.4f, 1.0f};
@@ -95,7 +120,7 @@ void BaseShadowMappingSceneTest::createRenderObjects()
 
     // Sphere #1
     {
-        common::SphereVerticesGenerator sphereGenerator{30, 30, 1.0f};
+        common::SphereVerticesGenerator sphereGenerator{sphereDetail, sphereDetail, 1.0f};
         glm::mat4 sphereModelMatrix(1.0f);
         glm::vec4 sphereColor = {0.2f, 0.2f, 0.2f, 1.0f};
         sphereModelMatrix = glm::translate(sphereModelMatrix, glm::vec3{0.0f, 5.0f, 0.0f});
@@ -106,8 +131,8 @@ void BaseShadowMappingSceneTest::createRenderObjects()
     }
 
     // Boxes
-    for (int x = -10; x < 10; ++x) {
-        for (int y = -10; y < 10; ++y) {
+    for (int x = -gridHalfSize; x < gridHalfSize; ++x) {
+        for (int y = -gridHalfSize; y < gridHalfSize; ++y) {
             common::CubeVerticesGenerator cubeGenerator;
             glm::mat4 cubeModelMatrix(1.0f);
             glm::vec4 cubeColor = {0.25f, 0.25f, 0.25f, 1.0f};
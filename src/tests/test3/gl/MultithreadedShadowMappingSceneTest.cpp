@@ -0,0 +1,301 @@
+#include <tests/test3/gl/MultithreadedShadowMappingSceneTest.h>
+
+#include <base/ScopedTimer.h>
+
+#include <GL/glew.h>
+#include <glm/vec4.hpp>
+
+#include <stdexcept>
+
+namespace {
+// Per-instance matrices of the vertex shaders, each one takes four attribute locations
+const GLuint kMatrixLocation = 3u;
+const GLuint kDepthMatrixLocation = 7u;
+}
+
+namespace tests {
+namespace test_gl {
+MultithreadedShadowMappingSceneTest::MultithreadedShadowMappingSceneTest(
+    const framework::TestConfiguration& configuration)
+    : BaseShadowMappingSceneTest(configuration.sceneScale, configuration.sceneDetail)
+    , GLTest("MultithreadedShadowMappingSceneTest", configuration)
+    , _objectData(base::gl::Buffer::Target::Array)
+    , _commands(base::gl::Buffer::Target::DrawIndirect)
+    , _gpuTimer(2u)
+    , _shadowGpuPass(registerGpuPass("shadowPass"))
+    , _renderGpuPass(registerGpuPass("renderPass"))
+{
+}
+
+void MultithreadedShadowMappingSceneTest::setup()
+{
+    GLTest::setup();
+    checkExtensions();
+
+    glEnable(GL_DEPTH_TEST);
+
+    initApplication();
+    initShadowmapObjects();
+    initPrograms();
+    initRenderObjects();
+    initObjectBuffers();
+
+    // Shadow pass reads object's shadowmap MVP, render pass its MVP and shadowmap image matrix
+    initVAO(_shadowVao, {0u});
+    initVAO(_renderVao, {sizeof(glm::mat4), 2u * sizeof(glm::mat4)});
+
+    _gpuTimer.create();
+}
+
+void MultithreadedShadowMappingSceneTest::run()
+{
+    while (!window_.shouldClose()) {
+        updateTestState(simulationTimeStep(window_.getFrameTime()));
+
+        _gpuTimer.beginFrame([this](std::size_t pass, uint64_t begin, uint64_t end) {
+            processGpuPassTime(pass, begin, end);
+        });
+
+        {
+            TIME_IT("Fence waiting");
+            framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::GpuWait};
+            _objectData.beginRegion();
+            _commands.beginRegion();
+        }
+
+        prepareObjects();
+
+        {
+            framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::Driver};
+
+            _commands.bind();
+
+            _gpuTimer.begin(_shadowGpuPass);
+            setupShadowStage();
+            render(_shadowVao);
+            _gpuTimer.end(_shadowGpuPass);
+
+            _gpuTimer.begin(_renderGpuPass);
+            setupRenderStage();
+            render(_renderVao);
+            _gpuTimer.end(_renderGpuPass);
+
+            _objectData.endRegion();
+            _commands.endRegion();
+            _commands.unbind();
+        }
+
+        updateWindow();
+
+        if (processFrameTime(window_.getFrameTime())) {
+            break; // Benchmarking is complete
+        }
+    }
+}
+
+void MultithreadedShadowMappingSceneTest::teardown()
+{
+    _gpuTimer.destroy();
+    _commands.destroy();
+    _objectData.destroy();
+
+    GLTest::teardown();
+}
+
+void MultithreadedShadowMappingSceneTest::checkExtensions() const
+{
+    // Base instance selects matrices of the current frame in flight
+    if (!base::gl::MappedRingBuffer::isSupported() || !(GLEW_VERSION_4_3 || GLEW_ARB_multi_draw_indirect) ||
+        !(GLEW_VERSION_4_2 || GLEW_ARB_base_instance)) {
+        throw std::runtime_error{"Multithreaded OpenGL shadow mapping test needs buffer storage, multi draw "
+                                 "indirect and base instance (OpenGL 4.4 or ARB_buffer_storage, "
+                                 "ARB_multi_draw_indirect and ARB_base_instance)!"};
+    }
+}
+
+void MultithreadedShadowMappingSceneTest::initApplication()
+{
+    window_.setDisplayingFPS(true);
+    window_.setFPSRefreshRate(1.0);
+
+    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+}
+
+void MultithreadedShadowMappingSceneTest::initShadowmapObjects()
+{
+    glGenFramebuffers(1, &_shadowmapFramebuffer);
+
+    glGenTextures(1, &_shadowmapTexture);
+    glBindTexture(GL_TEXTURE_2D, _shadowmapTexture);
+    glTexImage2D(GL_TEXTURE_2D, 0, GL_DEPTH_COMPONENT32, shadowmapSize().x, shadowmapSize().y, 0, GL_DEPTH_COMPONENT,
+                 GL_FLOAT, 0);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+
+    glBindFramebuffer(GL_FRAMEBUFFER, _shadowmapFramebuffer);
+    glFramebufferTexture(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, _shadowmapTexture, 0);
+    glDrawBuffer(GL_NONE);
+    if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
+        throw std::runtime_error{"Shadowmap framebuffer initialization failed!"};
+    }
+    glBindFramebuffer(GL_FRAMEBUFFER, window_.getFramebuffer());
+}
+
+void MultithreadedShadowMappingSceneTest::initPrograms()
+{
+    _shadowProgram.load(
+        {"resources/test3/shaders/gl/shadow_multidraw.vert", base::gl::Shader::Type::VertexShader},
+        {"resources/test3/shaders/gl/shadow.frag", base::gl::Shader::Type::FragmentShader});
+
+    _renderProgram.load(
+        {"resources/test3/shaders/gl/render_multidraw.vert", base::gl::Shader::Type::VertexShader},
+        {"resources/test3/shaders/gl/render.frag", base::gl::Shader::Type::FragmentShader});
+}
+
+void MultithreadedShadowMappingSceneTest::initRenderObjects()
+{
+    std::vector<glm::vec4> vboBuffer;
+    _glRenderObjects.reserve(renderObjects().size());
+
+    for (const common::RenderObject& renderObject : renderObjects()) {
+        GLRenderObject glRenderObject;
+        glRenderObject.modelMatrix = renderObject.modelMatrix;
+        glRenderObject.firstVertex = static_cast<GLuint>(vboBuffer.size() / 3u);
+        glRenderObject.vertexCount = static_cast<GLuint>(renderObject.vertices.size());
+        _glRenderObjects.push_back(glRenderObject);
+
+        std::vector<glm::vec4> combinedData = renderObject.generateCombinedData();
+        vboBuffer.insert(vboBuffer.end(), combinedData.begin(), combinedData.end());
+    }
+
+    // VertexData
+    base::gl::VertexBuffer::Data vertexData;
+    vertexData.data = (GLvoid*)(vboBuffer.data());
+    vertexData.size = sizeof(glm::vec4) * vboBuffer.size();
+    vertexData.pointers.push_back(base::gl::VertexAttrib{0, 4, GL_FLOAT, 3 * sizeof(glm::vec4), nullptr});
+    vertexData.pointers.push_back(base::gl::VertexAttrib{1, 4, GL_FLOAT, 3 * sizeof(glm::vec4), sizeof(glm::vec4)});
+    vertexData.pointers.push_back(base::gl::VertexAttrib{2, 4, GL_FLOAT, 3 * sizeof(glm::vec4), 2 * sizeof(glm::vec4)});
+
+    // VBO settings
+    _vbo.bind();
+    _vbo.setData(vertexData);
+    _vbo.unbind();
+}
+
+void MultithreadedShadowMappingSceneTest::initObjectBuffers()
+{
+    _objectData.allocate(static_cast<GLsizeiptr>(_glRenderObjects.size() * sizeof(ObjectData)));
+    _commands.allocate(static_cast<GLsizeiptr>(_glRenderObjects.size() * sizeof(DrawArraysIndirectCommand)));
+}
+
+void MultithreadedShadowMappingSceneTest::initVAO(base::gl::VertexArray& vao,
+                                                  const std::vector<std::size_t>& matrixOffsets)
+{
+    vao.setDrawTarget(base::gl::VertexArray::DrawTarget::Triangles);
+
+    vao.bind();
+    vao.attachVBO(&_vbo);
+    vao.setAttribPointers();
+
+    // Matrices advance per instance, base instance of each draw is the index of its object in the buffer
+    std::vector<base::gl::VertexAttrib> attributes;
+    GLuint locations[] = {kMatrixLocation, kDepthMatrixLocation};
+    for (std::size_t matrix = 0; matrix < matrixOffsets.size(); ++matrix) {
+        for (GLuint column = 0; column < 4u; ++column) {
+            attributes.push_back(base::gl::VertexAttrib{locations[matrix] + column, 4, GL_FLOAT, sizeof(ObjectData),
+                                                        matrixOffsets[matrix] + column * sizeof(glm::vec4)});
+        }
+    }
+
+    _objectData.bind();
+    vao.setAttribPointers(attributes);
+    for (const base::gl::VertexAttrib& attribute : attributes) {
+        vao.setAttribDivisor(attribute.index, 1u);
+    }
+    _objectData.unbind();
+
+    vao.unbind();
+}
+
+void MultithreadedShadowMappingSceneTest::setupShadowStage()
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, _shadowmapFramebuffer);
+    glViewport(0, 0, shadowmapSize().x, shadowmapSize().y);
+    glClear(GL_DEPTH_BUFFER_BIT);
+
+    _shadowProgram.use();
+}
+
+void MultithreadedShadowMappingSceneTest::setupRenderStage()
+{
+    glBindFramebuffer(GL_FRAMEBUFFER, window_.getFramebuffer());
+    glViewport(0, 0, window_.getWidth(), window_.getHeight());
+    glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+    glBindTexture(GL_TEXTURE_2D, _shadowmapTexture);
+
+    _renderProgram.use();
+}
+
+void MultithreadedShadowMappingSceneTest::writeObjects(std::size_t rangeFrom, std::size_t rangeTo)
+{
+    TIME_IT("Objects writing");
+    framework::WorkerTimer worker{_threadUtilization};
+
+    // Both buffers are at the same region, its objects follow objects of the previous regions
+    auto objects = static_cast<ObjectData*>(_objectData.regionData());
+    auto commands = static_cast<DrawArraysIndirectCommand*>(_commands.regionData());
+    auto baseInstance = static_cast<GLuint>(_objectData.regionIndex() * _glRenderObjects.size());
+
+    std::size_t drawnVertices = 0u;
+    for (std::size_t index = rangeFrom; index < rangeTo; ++index) {
+        const GLRenderObject& renderObject = _glRenderObjects[index];
+        glm::mat4 shadowMVP = shadowMatrix() * renderObject.modelMatrix;
+
+        objects[index] = ObjectData{shadowMVP, renderMatrix() * renderObject.modelMatrix,
+                                    convertProjectionToImage(shadowMVP)};
+        commands[index] = DrawArraysIndirectCommand{renderObject.vertexCount, 1u, renderObject.firstVertex,
+                                                    baseInstance + static_cast<GLuint>(index)};
+        drawnVertices += renderObject.vertexCount;
+    }
+
+    // Each object is drawn in both passes
+    countDraws(2u * (rangeTo - rangeFrom), 2u * drawnVertices);
+}
+
+void MultithreadedShadowMappingSceneTest::prepareObjects()
+{
+    TIME_IT("Objects preparation");
+    framework::ParallelRegionTimer region{_threadUtilization, workerThreads()};
+
+    threadPool().dispatch(threadPool().splitForWorkers(_glRenderObjects.size()),
+                          [this](std::size_t rangeFrom, std::size_t rangeTo, std::size_t) {
+                              writeObjects(rangeFrom, rangeTo);
+                          });
+
+    region.beginJoin();
+    threadPool().wait();
+    region.end();
+}
+
+void MultithreadedShadowMappingSceneTest::render(const base::gl::VertexArray& vao)
+{
+    // WARNING: program of the pass must be already used/bound!
+    vao.bind();
+    glMultiDrawArraysIndirect(static_cast<GLenum>(vao.getDrawTarget()), (const GLvoid*)_commands.regionOffset(),
+                              static_cast<GLsizei>(_glRenderObjects.size()), 0);
+    vao.unbind();
+}
+
+glm::mat4 MultithreadedShadowMappingSceneTest::convertProjectionToImage(const glm::mat4& matrix) const
+{
+    static const glm::mat4 bias = {0.5, 0.0, 0.0, 0.0, //
+                                   0.0, 0.5, 0.0, 0.0, //
+                                   0.0, 0.0, 0.5, 0.0, //
+                                   0.5, 0.5, 0.5, 1.0};
+
+    return bias * matrix;
+}
+}
+}
@@ -7,9 +7,12 @@
 
 namespace tests {
 namespace test_gl {
-ShadowMappingSceneTest::ShadowMappingSceneTest(bool benchmarkMode, float benchmarkTime)
-    : BaseShadowMappingSceneTest()
-    , GLTest("ShadowMappingSceneTest", benchmarkMode, benchmarkTime)
+ShadowMappingSceneTest::ShadowMappingSceneTest(const framework::TestConfiguration& configuration)
+    : BaseShadowMappingSceneTest(configuration.sceneScale, configuration.sceneDetail)
+    , GLTest("ShadowMappingSceneTest", configuration)
+    , _gpuTimer(2u)
+    , _shadowGpuPass(registerGpuPass("shadowPass"))
+    , _renderGpuPass(registerGpuPass("renderPass"))
 {
 }
 
@@ -23,22 +26,34 @@ void ShadowMappingSceneTest::setup()
     initShadowmapObjects();
     initPrograms();
     initRenderObjects();
+
+    _gpuTimer.create();
 }
 
 void ShadowMappingSceneTest::run()
 {
     while (!window_.shouldClose()) {
-        updateTestState(window_.getFrameTime());
+        updateTestState(simulationTimeStep(window_.getFrameTime()));
+
+        _gpuTimer.beginFrame([this](std::size_t pass, uint64_t begin, uint64_t end) {
+            processGpuPassTime(pass, begin, end);
+        });
 
         {
+            framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::Driver};
+
+            _gpuTimer.begin(_shadowGpuPass);
             setupShadowStage();
             render(_shadowProgram, shadowMatrix());
+            _gpuTimer.end(_shadowGpuPass);
 
+            _gpuTimer.begin(_renderGpuPass);
             setupRenderStage();
             render(_renderProgram, renderMatrix());
+            _gpuTimer.end(_renderGpuPass);
         }
 
-        window_.update();
+        updateWindow();
 
         if (processFrameTime(window_.getFrameTime())) {
             break; // Benchmarking is complete
@@ -48,6 +63,8 @@ void ShadowMappingSceneTest::run()
 
 void ShadowMappingSceneTest::teardown()
 {
+    _gpuTimer.destroy();
+
     GLTest::teardown();
 }
 
@@ -78,7 +95,7 @@ void ShadowMappingSceneTest::initShadowmapObjects()
     if (glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE) {
         throw std::runtime_error{"Shadowmap framebuffer initialization failed!"};
     }
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    glBindFramebuffer(GL_FRAMEBUFFER, window_.getFramebuffer());
 }
 
 void ShadowMappingSceneTest::initPrograms()
@@ -144,8 +161,8 @@ void ShadowMappingSceneTest::setupShadowStage()
 
 void ShadowMappingSceneTest::setupRenderStage()
 {
-    glBindFramebuffer(GL_FRAMEBUFFER, 0);
-    glViewport(0, 0, 800, 600);
+    glBindFramebuffer(GL_FRAMEBUFFER, window_.getFramebuffer());
+    glViewport(0, 0, window_.getWidth(), window_.getHeight());
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
     glBindTexture(GL_TEXTURE_2D, _shadowmapTexture);
 
@@ -167,6 +184,7 @@ void ShadowMappingSceneTest::render(const base::gl::Program& currentProgram, con
         }
 
         renderObject.vao.bind();
+        countDraws(1u, static_cast<std::size_t>(renderObject.vao.getDrawCount()));
         renderObject.vao.drawArrays();
     }
 }
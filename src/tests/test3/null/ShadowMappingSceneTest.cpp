@@ -0,0 +1,63 @@
+#include <tests/test3/null/ShadowMappingSceneTest.h>
+
+namespace tests {
+namespace test_null {
+ShadowMappingSceneTest::ShadowMappingSceneTest(const framework::TestConfiguration& configuration)
+    : BaseShadowMappingSceneTest(configuration.sceneScale, configuration.sceneDetail)
+    , NullTest("ShadowMappingSceneTest", configuration)
+{
+}
+
+void ShadowMappingSceneTest::setup()
+{
+    NullTest::setup();
+}
+
+void ShadowMappingSceneTest::run()
+{
+    while (!shouldClose()) {
+        updateTestState(simulationTimeStep(frameTime()));
+
+        {
+            render(shadowMatrix(), false);
+            render(renderMatrix(), true);
+        }
+
+        update();
+
+        if (processFrameTime(frameTime())) {
+            break; // Benchmarking is complete
+        }
+    }
+}
+
+void ShadowMappingSceneTest::teardown()
+{
+    NullTest::teardown();
+}
+
+void ShadowMappingSceneTest::render(const glm::mat4& viewProjectionMatrix, bool withShadowMatrix)
+{
+    for (const auto& renderObject : renderObjects()) {
+        setUniform(viewProjectionMatrix * renderObject.modelMatrix);
+
+        if (withShadowMatrix) {
+            setUniform(convertProjectionToImage(shadowMatrix() * renderObject.modelMatrix));
+        }
+
+        countDraws(1u, renderObject.vertices.size());
+        draw(renderObject.vertices.size(), 0);
+    }
+}
+
+glm::mat4 ShadowMappingSceneTest::convertProjectionToImage(const glm::mat4& matrix) const
+{
+    static const glm::mat4 bias = {0.5, 0.0, 0.0, 0.0, //
+                                   0.0, 0.5, 0.0, 0.0, //
+                                   0.0, 0.0, 0.5, 0.0, //
+                                   0.5, 0.5, 0.5, 1.0};
+
+    return bias * matrix;
+}
+}
+}
@@ -6,11 +6,16 @@
 #include <glm/vec4.hpp>
 #include <vulkan/vulkan.hpp>
 
+#include <algorithm>
 #include <iostream>
 #include <stdexcept>
-#include <thread>
 
 namespace {
+// Passes of worker command buffers
+const std::size_t kShadowmapWorkerCmdPass = 0u;
+const std::size_t kRenderWorkerCmdPass = 1u;
+const std::size_t kWorkerCmdPasses = 2u;
+
 const std::vector<vk::Format> kDepthFormatCandidates{vk::Format::eD24UnormS8Uint, vk::Format::eD32Sfloat,
                                                      vk::Format::eD16Unorm, vk::Format::eD16UnormS8Uint};
 const std::vector<vk::Format> kDepthFormatsWithStencilAspect{vk::Format::eD24UnormS8Uint, vk::Format::eD16UnormS8Uint};
@@ -45,10 +50,17 @@ vk::ImageAspectFlags getImageDepthFormatAspect(const vk::Format& format)
 
 namespace tests {
 namespace test_vk {
-MultithreadedShadowMappingSceneTest::MultithreadedShadowMappingSceneTest(bool benchmarkMode, float benchmarkTime)
-    : BaseShadowMappingSceneTest()
-    , VKTest("MultithreadedShadowMappingSceneTest", benchmarkMode, benchmarkTime)
+MultithreadedShadowMappingSceneTest::MultithreadedShadowMappingSceneTest(
+    const framework::TestConfiguration& configuration)
+    : BaseShadowMappingSceneTest(configuration.sceneScale, configuration.sceneDetail)
+    , VKTest("MultithreadedShadowMappingSceneTest", configuration)
+    , _workerCmdBuffers()
     , _semaphoreIndex(0u)
+    , _gpuTimer()
+    , _shadowGpuPass(registerGpuPass("shadowPass"))
+    , _renderGpuPass(registerGpuPass("renderPass"))
+    , _frameGraph()
+    , _recordedFrameIndex(0u)
 {
 }
 
@@ -64,16 +76,17 @@ void MultithreadedShadowMappingSceneTest::setup()
 
     prepareShadowmapPass();
     prepareRenderPass();
+    createFrameGraph();
+
+    _gpuTimer = base::vkx::GpuTimer(device(), deviceInfo(), queues(), _cmdBuffers.size(), 2u);
 }
 
 void MultithreadedShadowMappingSceneTest::run()
 {
     while (!window().shouldClose()) {
-        TIME_RESET("Frame times:");
-
         auto frameIndex = getNextFrameIndex();
 
-        updateTestState(static_cast<float>(window().frameTime()));
+        updateTestState(static_cast<float>(simulationTimeStep(window().frameTime())));
         prepareCommandBuffer(frameIndex);
         submitCommandBuffer(frameIndex);
         presentFrame(frameIndex);
@@ -90,6 +103,8 @@ void MultithreadedShadowMappingSceneTest::teardown()
 {
     device().waitIdle();
 
+    _gpuTimer = base::vkx::GpuTimer{};
+
     destroyPass(_shadowmapPass);
     destroyPass(_renderPass);
 
@@ -158,17 +173,8 @@ void MultithreadedShadowMappingSceneTest::createCommandBuffers()
 
 void MultithreadedShadowMappingSceneTest::createSecondaryCommandBuffers()
 {
-    _threadCmdPools.resize(std::thread::hardware_concurrency());
-    for (auto& sndCmdPool : _threadCmdPools) {
-        vk::CommandPoolCreateFlags cmdPoolFlags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
-        sndCmdPool.cmdPool = device().createCommandPool({cmdPoolFlags, queues().familyIndex()});
-        sndCmdPool.shadowmapCmdBuffers =
-            device().allocateCommandBuffers({sndCmdPool.cmdPool, vk::CommandBufferLevel::eSecondary,
-                                             static_cast<uint32_t>(window().swapchainImages().size())});
-        sndCmdPool.renderCmdBuffers =
-            device().allocateCommandBuffers({sndCmdPool.cmdPool, vk::CommandBufferLevel::eSecondary,
-                                             static_cast<uint32_t>(window().swapchainImages().size())});
-    }
+    _workerCmdBuffers = base::vkx::WorkerCommandBuffers(device(), queues(), workerThreads(),
+                                                        window().swapchainImages().size(), kWorkerCmdPasses);
 }
 
 void MultithreadedShadowMappingSceneTest::createVbos()
@@ -216,6 +222,42 @@ void MultithreadedShadowMappingSceneTest::createFences()
     }
 }
 
+void MultithreadedShadowMappingSceneTest::createFrameGraph()
+{
+    _objectMatrices.resize(_vkRenderObjects.size());
+    std::size_t ranges = threadPool().workerRanges();
+
+    // Objects are weighted by their vertices in units of the smallest object, so the detailed sphere gets
+    // a range of its own instead of making the range with it (and its worker) the slowest one
+    std::size_t smallestDrawCount = _vkRenderObjects.empty() ? 1u : _vkRenderObjects.front().drawCount;
+    for (const VkRenderObject& renderObject : _vkRenderObjects) {
+        smallestDrawCount = std::max<std::size_t>(std::min(smallestDrawCount, renderObject.drawCount), 1u);
+    }
+    std::vector<double> costs;
+    for (const VkRenderObject& renderObject : _vkRenderObjects) {
+        costs.push_back(static_cast<double>(renderObject.drawCount) / static_cast<double>(smallestDrawCount));
+    }
+    std::vector<std::size_t> recordRanges = base::ThreadPool::splitByCost(costs, ranges);
+
+    base::TaskGraph::Node transform =
+        _frameGraph.add([this](std::size_t rangeFrom, std::size_t rangeTo, std::size_t) {
+            transformObjects(rangeFrom, rangeTo);
+        });
+    base::TaskGraph::Node shadowmap =
+        _frameGraph.add([this](std::size_t rangeFrom, std::size_t rangeTo, std::size_t worker) {
+            recordShadowmapObjects(rangeFrom, rangeTo, worker);
+        });
+    base::TaskGraph::Node render =
+        _frameGraph.add([this](std::size_t rangeFrom, std::size_t rangeTo, std::size_t worker) {
+            recordRenderObjects(rangeFrom, rangeTo, worker);
+        });
+    _frameGraph.precede(transform, shadowmap);
+    _frameGraph.precede(transform, render);
+    _frameGraph.setRanges(transform, base::ThreadPool::splitEvenly(_vkRenderObjects.size(), ranges));
+    _frameGraph.setRanges(shadowmap, recordRanges);
+    _frameGraph.setRanges(render, recordRanges);
+}
+
 MultithreadedShadowMappingSceneTest::VkDepthBuffer MultithreadedShadowMappingSceneTest::createDepthBuffer(
     const glm::uvec2& size, vk::ImageUsageFlags usage)
 {
@@ -311,7 +353,7 @@ vk::RenderPass MultithreadedShadowMappingSceneTest::createRenderRenderPass()
                                   vk::AttachmentLoadOp::eDontCare,
                                   vk::AttachmentStoreOp::eDontCare,
                                   vk::ImageLayout::eUndefined,
-                                  vk::ImageLayout::ePresentSrcKHR},
+                                  window().presentImageLayout()},
         vk::AttachmentDescription{{},
                                   _renderPass.depthBuffer.format,
                                   vk::SampleCountFlagBits::e1,
@@ -614,7 +656,7 @@ void MultithreadedShadowMappingSceneTest::destroyDepthBuffer(VkDepthBuffer& dept
 {
     device().destroyImageView(depthBuffer.view);
     device().destroyImage(depthBuffer.image);
-    device().freeMemory(depthBuffer.memory);
+    memory().freeMemory(depthBuffer.memory);
     depthBuffer = VkDepthBuffer{};
 }
 
@@ -644,6 +686,7 @@ void MultithreadedShadowMappingSceneTest::destroyVbos()
         memory().destroyBuffer(vkRenderObject.vbo);
     }
     _vkRenderObjects.clear();
+    _objectMatrices.clear();
 }
 
 void MultithreadedShadowMappingSceneTest::setRenderDescriptorSet(const vk::DescriptorSet& descriptorSet)
@@ -670,12 +713,7 @@ glm::mat4 MultithreadedShadowMappingSceneTest::convertProjectionToImage(const gl
 
 void MultithreadedShadowMappingSceneTest::destroySecondaryCommandBuffers()
 {
-    for (auto& threadCmdPool : _threadCmdPools) {
-        device().destroyCommandPool(threadCmdPool.cmdPool);
-        threadCmdPool.shadowmapCmdBuffers.clear();
-        threadCmdPool.renderCmdBuffers.clear();
-    }
-    _threadCmdPools.clear();
+    _workerCmdBuffers = base::vkx::WorkerCommandBuffers{};
 }
 
 void MultithreadedShadowMappingSceneTest::destroyCommandBuffers()
@@ -697,121 +735,132 @@ std::vector<vk::PipelineShaderStageCreateInfo> MultithreadedShadowMappingSceneTe
 uint32_t MultithreadedShadowMappingSceneTest::getNextFrameIndex() const
 {
     TIME_IT("Frame image acquisition");
+    framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::Present};
 
     _semaphoreIndex = (_semaphoreIndex + 1) % _acquireSemaphores.size();
-    auto nextFrameAcquireStatus =
-        device().acquireNextImageKHR(window().swapchain(), UINT64_MAX, _acquireSemaphores[_semaphoreIndex], {});
-
-    if (nextFrameAcquireStatus.result != vk::Result::eSuccess) {
-        throw std::system_error(nextFrameAcquireStatus.result, "Error during acquiring next frame index");
-    }
-
-    return nextFrameAcquireStatus.value;
+    return window().acquireNextImage(_acquireSemaphores[_semaphoreIndex]);
 }
 
-void MultithreadedShadowMappingSceneTest::prepareSecondaryCommandBuffer(std::size_t threadIndex,
-                                                                        std::size_t frameIndex,
-                                                                        std::size_t rangeFrom,
-                                                                        std::size_t rangeTo) const
+void MultithreadedShadowMappingSceneTest::transformObjects(std::size_t rangeFrom, std::size_t rangeTo)
 {
-    TIME_IT("CmdBuffer (secondary) building");
+    TIME_IT("Object transformation");
+    framework::WorkerTimer worker{_threadUtilization};
 
-    // Shadowmap pass
-    {
-        const VkPass& pass = _shadowmapPass;
-        const vk::CommandBuffer& cmdBuffer = _threadCmdPools[threadIndex].shadowmapCmdBuffers[frameIndex];
+    for (std::size_t index = rangeFrom; index < rangeTo; ++index) {
+        const glm::mat4& modelMatrix = _vkRenderObjects[index].modelMatrix;
+        VkObjectMatrices& matrices = _objectMatrices[index];
 
-        cmdBuffer.reset({});
-        vk::CommandBufferInheritanceInfo inheritanceInfo{pass.renderPass, 0,  pass.framebuffers[frameIndex],
-                                                         VK_FALSE,        {}, {}};
-        cmdBuffer.begin(vk::CommandBufferBeginInfo{vk::CommandBufferUsageFlagBits::eRenderPassContinue |
-                                                       vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
-                                                   &inheritanceInfo});
+        matrices.shadowmapMVP = base::vkx::fixGLMatrix(shadowMatrix() * modelMatrix);
+        matrices.renderMatrices[0] = base::vkx::fixGLMatrix(renderMatrix() * modelMatrix);
+        matrices.renderMatrices[1] = convertProjectionToImage(matrices.shadowmapMVP);
+    }
+}
 
-        cmdBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pass.pipeline);
+void MultithreadedShadowMappingSceneTest::recordShadowmapObjects(std::size_t rangeFrom,
+                                                                 std::size_t rangeTo,
+                                                                 std::size_t worker)
+{
+    TIME_IT("CmdBuffer (secondary) building");
+    framework::WorkerTimer workerTimer{_threadUtilization};
 
-        for (std::size_t index = rangeFrom; index < rangeTo; ++index) {
-            const VkRenderObject& renderObject = _vkRenderObjects[index];
+    const VkPass& pass = _shadowmapPass;
+    const vk::CommandBuffer& cmdBuffer = beginWorkerCommandBuffer(pass, worker);
 
-            glm::mat4 MVP = base::vkx::fixGLMatrix(shadowMatrix() * renderObject.modelMatrix);
-            cmdBuffer.pushConstants(pass.pipelineLayout, vk::ShaderStageFlagBits::eVertex, 0, sizeof(MVP), &MVP);
+    std::size_t drawnVertices = 0u;
+    for (std::size_t index = rangeFrom; index < rangeTo; ++index) {
+        const VkRenderObject& renderObject = _vkRenderObjects[index];
 
-            cmdBuffer.bindVertexBuffers(0, {{renderObject.vbo.buffer}}, {{0}});
-            cmdBuffer.draw(renderObject.drawCount, 1, 0, 0);
-        }
+        cmdBuffer.pushConstants(pass.pipelineLayout, vk::ShaderStageFlagBits::eVertex, 0, sizeof(glm::mat4),
+                                &_objectMatrices[index].shadowmapMVP);
 
-        cmdBuffer.end();
+        cmdBuffer.bindVertexBuffers(0, {{renderObject.vbo.buffer}}, {{0}});
+        drawnVertices += renderObject.drawCount;
+        cmdBuffer.draw(renderObject.drawCount, 1, 0, 0);
     }
+    countDraws(rangeTo - rangeFrom, drawnVertices);
+}
 
-    // Render pass
-    {
-        const VkPass& pass = _renderPass;
-        const vk::CommandBuffer& cmdBuffer = _threadCmdPools[threadIndex].renderCmdBuffers[frameIndex];
+void MultithreadedShadowMappingSceneTest::recordRenderObjects(std::size_t rangeFrom,
+                                                              std::size_t rangeTo,
+                                                              std::size_t worker)
+{
+    TIME_IT("CmdBuffer (secondary) building");
+    framework::WorkerTimer workerTimer{_threadUtilization};
 
-        cmdBuffer.reset({});
-        vk::CommandBufferInheritanceInfo inheritanceInfo{pass.renderPass, 0,  pass.framebuffers[frameIndex],
-                                                         VK_FALSE,        {}, {}};
-        cmdBuffer.begin(vk::CommandBufferBeginInfo{vk::CommandBufferUsageFlagBits::eRenderPassContinue |
-                                                       vk::CommandBufferUsageFlagBits::eOneTimeSubmit,
-                                                   &inheritanceInfo});
+    const VkPass& pass = _renderPass;
+    const vk::CommandBuffer& cmdBuffer = beginWorkerCommandBuffer(pass, worker);
 
-        cmdBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pass.pipeline);
-        cmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pass.pipelineLayout, 0, 1, &pass.descriptorSet,
-                                     0, nullptr);
+    std::size_t drawnVertices = 0u;
+    for (std::size_t index = rangeFrom; index < rangeTo; ++index) {
+        const VkRenderObject& renderObject = _vkRenderObjects[index];
 
-        for (std::size_t index = rangeFrom; index < rangeTo; ++index) {
-            const VkRenderObject& renderObject = _vkRenderObjects[index];
+        cmdBuffer.pushConstants(pass.pipelineLayout, vk::ShaderStageFlagBits::eVertex, 0, 2 * sizeof(glm::mat4),
+                                &_objectMatrices[index].renderMatrices);
 
-            glm::mat4 matrices[2] = {
-                base::vkx::fixGLMatrix(renderMatrix() * renderObject.modelMatrix),
-                convertProjectionToImage(base::vkx::fixGLMatrix(shadowMatrix() * renderObject.modelMatrix)),
-            };
-            cmdBuffer.pushConstants(pass.pipelineLayout, vk::ShaderStageFlagBits::eVertex, 0, 2 * sizeof(glm::mat4),
-                                    &matrices);
+        cmdBuffer.bindVertexBuffers(0, {{renderObject.vbo.buffer}}, {{0}});
+        drawnVertices += renderObject.drawCount;
+        cmdBuffer.draw(renderObject.drawCount, 1, 0, 0);
+    }
+    countDraws(rangeTo - rangeFrom, drawnVertices);
+}
 
-            cmdBuffer.bindVertexBuffers(0, {{renderObject.vbo.buffer}}, {{0}});
-            cmdBuffer.draw(renderObject.drawCount, 1, 0, 0);
-        }
+const vk::CommandBuffer& MultithreadedShadowMappingSceneTest::beginWorkerCommandBuffer(const VkPass& pass,
+                                                                                       std::size_t worker)
+{
+    bool renderPass = (&pass == &_renderPass);
+    vk::CommandBufferInheritanceInfo inheritanceInfo{pass.renderPass, 0,  pass.framebuffers[_recordedFrameIndex],
+                                                     VK_FALSE,        {}, {}};
+    bool begun = false;
+    const vk::CommandBuffer& cmdBuffer = _workerCmdBuffers.begin(
+        worker, renderPass ? kRenderWorkerCmdPass : kShadowmapWorkerCmdPass, inheritanceInfo, begun);
+    if (!begun)
+        return cmdBuffer;
 
-        cmdBuffer.end();
+    cmdBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, pass.pipeline);
+    // Only render pass samples the shadowmap
+    if (renderPass) {
+        cmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, pass.pipelineLayout, 0, 1, &pass.descriptorSet,
+                                     0, nullptr);
     }
+
+    return cmdBuffer;
 }
 
-void MultithreadedShadowMappingSceneTest::prepareCommandBuffer(std::size_t frameIndex) const
+void MultithreadedShadowMappingSceneTest::prepareCommandBuffer(std::size_t frameIndex)
 {
     {
         TIME_IT("Fence waiting");
+        framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::GpuWait};
         device().waitForFences(1, &_fences[frameIndex], VK_FALSE, UINT64_MAX);
         device().resetFences(1, &_fences[frameIndex]);
     }
 
+    _gpuTimer.collect(frameIndex, [this](std::size_t pass, uint64_t begin, uint64_t end) {
+        processGpuPassTime(pass, begin, end);
+    });
+
     {
         TIME_IT("CmdBuffer building");
+        framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::Driver};
         const vk::CommandBuffer& cmdBuffer = _cmdBuffers[frameIndex];
         cmdBuffer.reset({});
         cmdBuffer.begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit, nullptr});
+        _gpuTimer.reset(cmdBuffer, frameIndex);
 
         std::vector<vk::CommandBuffer> shadowmapSecondaryCommandBuffer;
         std::vector<vk::CommandBuffer> renderSecondaryCommandBuffer;
         {
             // Multithreaded secondary CommandBuffer generation
-            std::vector<std::thread> threads(_threadCmdPools.size());
-            float batchSize = static_cast<float>(_vkRenderObjects.size()) / static_cast<float>(_threadCmdPools.size());
-            std::size_t batchSizeRounded = static_cast<std::size_t>(std::ceil(batchSize));
-            for (std::size_t threadIndex = 0; threadIndex < _threadCmdPools.size(); ++threadIndex) {
-                shadowmapSecondaryCommandBuffer.push_back(_threadCmdPools[threadIndex].shadowmapCmdBuffers[frameIndex]);
-                renderSecondaryCommandBuffer.push_back(_threadCmdPools[threadIndex].renderCmdBuffers[frameIndex]);
-
-                std::size_t rangeFrom = threadIndex * batchSizeRounded;
-                std::size_t rangeTo = std::min((threadIndex + 1) * batchSizeRounded, _vkRenderObjects.size());
-
-                threads[threadIndex] =
-                    std::move(std::thread(&MultithreadedShadowMappingSceneTest::prepareSecondaryCommandBuffer, this,
-                                          threadIndex, frameIndex, rangeFrom, rangeTo));
-            }
-            for (auto& thread : threads) {
-                thread.join();
-            }
+            framework::ParallelRegionTimer region{_threadUtilization, _workerCmdBuffers.workerCount()};
+            _recordedFrameIndex = frameIndex;
+            _workerCmdBuffers.reset(frameIndex);
+            threadPool().dispatch(_frameGraph);
+            region.beginJoin();
+            threadPool().wait();
+            region.end();
+
+            shadowmapSecondaryCommandBuffer = _workerCmdBuffers.end(kShadowmapWorkerCmdPass);
+            renderSecondaryCommandBuffer = _workerCmdBuffers.end(kRenderWorkerCmdPass);
         }
 
         {
@@ -823,9 +872,11 @@ void MultithreadedShadowMappingSceneTest::prepareCommandBuffer(std::size_t frame
                                                    1,
                                                    &clearValue};
 
+            _gpuTimer.begin(cmdBuffer, frameIndex, _shadowGpuPass);
             cmdBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eSecondaryCommandBuffers);
             cmdBuffer.executeCommands(shadowmapSecondaryCommandBuffer);
             cmdBuffer.endRenderPass();
+            _gpuTimer.end(cmdBuffer, frameIndex, _shadowGpuPass);
         }
 
         // Image barrier between draw calls for shadowmap image
@@ -851,9 +902,11 @@ void MultithreadedShadowMappingSceneTest::prepareCommandBuffer(std::size_t frame
                                                    static_cast<uint32_t>(clearValues.size()),
                                                    clearValues.data()};
 
+            _gpuTimer.begin(cmdBuffer, frameIndex, _renderGpuPass);
             cmdBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eSecondaryCommandBuffers);
             cmdBuffer.executeCommands(renderSecondaryCommandBuffer);
             cmdBuffer.endRenderPass();
+            _gpuTimer.end(cmdBuffer, frameIndex, _renderGpuPass);
         }
 
         cmdBuffer.end();
@@ -863,6 +916,7 @@ void MultithreadedShadowMappingSceneTest::prepareCommandBuffer(std::size_t frame
 void MultithreadedShadowMappingSceneTest::submitCommandBuffer(std::size_t frameIndex) const
 {
     TIME_IT("CmdBuffer submition");
+    framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::Driver};
 
     vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eColorAttachmentOutput;
     vk::SubmitInfo submits{1, &_acquireSemaphores[_semaphoreIndex], &waitStage, 1, &_cmdBuffers[frameIndex],
@@ -873,11 +927,9 @@ void MultithreadedShadowMappingSceneTest::submitCommandBuffer(std::size_t frameI
 void MultithreadedShadowMappingSceneTest::presentFrame(std::size_t frameIndex) const
 {
     TIME_IT("Frame presentation");
+    framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::Present};
 
-    uint32_t imageIndex = static_cast<uint32_t>(frameIndex);
-    vk::PresentInfoKHR presentInfo{1,      &_renderSemaphores[_semaphoreIndex], 1, &window().swapchain(), &imageIndex,
-                                   nullptr};
-    queues().queue().presentKHR(presentInfo);
+    window().present(_renderSemaphores[_semaphoreIndex], static_cast<uint32_t>(frameIndex));
 }
 }
 }
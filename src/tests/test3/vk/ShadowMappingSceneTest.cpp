@@ -44,10 +44,13 @@ vk::ImageAspectFlags getImageDepthFormatAspect(const vk::Format& format)
 
 namespace tests {
 namespace test_vk {
-ShadowMappingSceneTest::ShadowMappingSceneTest(bool benchmarkMode, float benchmarkTime)
-    : BaseShadowMappingSceneTest()
-    , VKTest("ShadowMappingSceneTest", benchmarkMode, benchmarkTime)
+ShadowMappingSceneTest::ShadowMappingSceneTest(const framework::TestConfiguration& configuration)
+    : BaseShadowMappingSceneTest(configuration.sceneScale, configuration.sceneDetail)
+    , VKTest("ShadowMappingSceneTest", configuration)
     , _semaphoreIndex(0u)
+    , _gpuTimer()
+    , _shadowGpuPass(registerGpuPass("shadowPass"))
+    , _renderGpuPass(registerGpuPass("renderPass"))
 {
 }
 
@@ -62,16 +65,16 @@ void ShadowMappingSceneTest::setup()
 
     prepareShadowmapPass();
     prepareRenderPass();
+
+    _gpuTimer = base::vkx::GpuTimer(device(), deviceInfo(), queues(), _cmdBuffers.size(), 2u);
 }
 
 void ShadowMappingSceneTest::run()
 {
     while (!window().shouldClose()) {
-        TIME_RESET("Frame times:");
-
         auto frameIndex = getNextFrameIndex();
 
-        updateTestState(static_cast<float>(window().frameTime()));
+        updateTestState(static_cast<float>(simulationTimeStep(window().frameTime())));
         prepareCommandBuffer(frameIndex);
         submitCommandBuffer(frameIndex);
         presentFrame(frameIndex);
@@ -88,6 +91,8 @@ void ShadowMappingSceneTest::teardown()
 {
     device().waitIdle();
 
+    _gpuTimer = base::vkx::GpuTimer{};
+
     destroyPass(_shadowmapPass);
     destroyPass(_renderPass);
 
@@ -295,7 +300,7 @@ vk::RenderPass ShadowMappingSceneTest::createRenderRenderPass()
                                   vk::AttachmentLoadOp::eDontCare,
                                   vk::AttachmentStoreOp::eDontCare,
                                   vk::ImageLayout::eUndefined,
-                                  vk::ImageLayout::ePresentSrcKHR},
+                                  window().presentImageLayout()},
         vk::AttachmentDescription{{},
                                   _renderPass.depthBuffer.format,
                                   vk::SampleCountFlagBits::e1,
@@ -596,7 +601,7 @@ void ShadowMappingSceneTest::destroyDepthBuffer(VkDepthBuffer& depthBuffer)
 {
     device().destroyImageView(depthBuffer.view);
     device().destroyImage(depthBuffer.image);
-    device().freeMemory(depthBuffer.memory);
+    memory().freeMemory(depthBuffer.memory);
     depthBuffer = VkDepthBuffer{};
 }
 
@@ -668,32 +673,33 @@ std::vector<vk::PipelineShaderStageCreateInfo> ShadowMappingSceneTest::getShader
 uint32_t ShadowMappingSceneTest::getNextFrameIndex() const
 {
     TIME_IT("Frame image acquisition");
+    framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::Present};
 
     _semaphoreIndex = (_semaphoreIndex + 1) % _acquireSemaphores.size();
-    auto nextFrameAcquireStatus =
-        device().acquireNextImageKHR(window().swapchain(), UINT64_MAX, _acquireSemaphores[_semaphoreIndex], {});
-
-    if (nextFrameAcquireStatus.result != vk::Result::eSuccess) {
-        throw std::system_error(nextFrameAcquireStatus.result, "Error during acquiring next frame index");
-    }
-
-    return nextFrameAcquireStatus.value;
+    return window().acquireNextImage(_acquireSemaphores[_semaphoreIndex]);
 }
 
-void ShadowMappingSceneTest::prepareCommandBuffer(std::size_t frameIndex) const
+void ShadowMappingSceneTest::prepareCommandBuffer(std::size_t frameIndex)
 {
     {
         TIME_IT("Fence waiting");
+        framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::GpuWait};
         device().waitForFences(1, &_fences[frameIndex], VK_FALSE, UINT64_MAX);
         device().resetFences(1, &_fences[frameIndex]);
     }
 
+    _gpuTimer.collect(frameIndex, [this](std::size_t pass, uint64_t begin, uint64_t end) {
+        processGpuPassTime(pass, begin, end);
+    });
+
     {
         TIME_IT("CmdBuffer building");
+        framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::Driver};
 
         const vk::CommandBuffer& cmdBuffer = _cmdBuffers[frameIndex];
         cmdBuffer.reset({});
         cmdBuffer.begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit, nullptr});
+        _gpuTimer.reset(cmdBuffer, frameIndex);
 
         {
             // Shadowmap pass
@@ -707,6 +713,7 @@ void ShadowMappingSceneTest::prepareCommandBuffer(std::size_t frameIndex) const
                                                    {{}, {shadowmapSize().x, shadowmapSize().y}},
                                                    1,
                                                    &clearValue};
+            _gpuTimer.begin(cmdBuffer, frameIndex, _shadowGpuPass);
             cmdBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
 
             for (const auto& renderObject : _vkRenderObjects) {
@@ -714,10 +721,12 @@ void ShadowMappingSceneTest::prepareCommandBuffer(std::size_t frameIndex) const
                 cmdBuffer.pushConstants(pass.pipelineLayout, vk::ShaderStageFlagBits::eVertex, 0, sizeof(MVP), &MVP);
 
                 cmdBuffer.bindVertexBuffers(0, {{renderObject.vbo.buffer}}, {{0}});
+                countDraws(1u, renderObject.drawCount);
                 cmdBuffer.draw(renderObject.drawCount, 1, 0, 0);
             }
 
             cmdBuffer.endRenderPass();
+            _gpuTimer.end(cmdBuffer, frameIndex, _shadowGpuPass);
         }
 
         // Image barrier between draw calls for shadowmap image
@@ -748,6 +757,7 @@ void ShadowMappingSceneTest::prepareCommandBuffer(std::size_t frameIndex) const
                                                    {{}, {window().size().x, window().size().y}},
                                                    static_cast<uint32_t>(clearValues.size()),
                                                    clearValues.data()};
+            _gpuTimer.begin(cmdBuffer, frameIndex, _renderGpuPass);
             cmdBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
 
             for (const auto& renderObject : _vkRenderObjects) {
@@ -759,10 +769,12 @@ void ShadowMappingSceneTest::prepareCommandBuffer(std::size_t frameIndex) const
                                         &matrices);
 
                 cmdBuffer.bindVertexBuffers(0, {{renderObject.vbo.buffer}}, {{0}});
+                countDraws(1u, renderObject.drawCount);
                 cmdBuffer.draw(renderObject.drawCount, 1, 0, 0);
             }
 
             cmdBuffer.endRenderPass();
+            _gpuTimer.end(cmdBuffer, frameIndex, _renderGpuPass);
         }
 
         cmdBuffer.end();
@@ -772,6 +784,7 @@ void ShadowMappingSceneTest::prepareCommandBuffer(std::size_t frameIndex) const
 void ShadowMappingSceneTest::submitCommandBuffer(std::size_t frameIndex) const
 {
     TIME_IT("CmdBuffer submition");
+    framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::Driver};
 
     vk::PipelineStageFlags waitStage = vk::PipelineStageFlagBits::eColorAttachmentOutput;
     vk::SubmitInfo submits{1, &_acquireSemaphores[_semaphoreIndex], &waitStage, 1, &_cmdBuffers[frameIndex],
@@ -782,11 +795,9 @@ void ShadowMappingSceneTest::submitCommandBuffer(std::size_t frameIndex) const
 void ShadowMappingSceneTest::presentFrame(std::size_t frameIndex) const
 {
     TIME_IT("Frame presentation");
+    framework::FrameStageTimer stage{_frameClassifier, framework::FrameStage::Present};
 
-    uint32_t imageIndex = static_cast<uint32_t>(frameIndex);
-    vk::PresentInfoKHR presentInfo{1,      &_renderSemaphores[_semaphoreIndex], 1, &window().swapchain(), &imageIndex,
-                                   nullptr};
-    queues().queue().presentKHR(presentInfo);
+    window().present(_renderSemaphores[_semaphoreIndex], static_cast<uint32_t>(frameIndex));
 }
 }
 }
@@ -9,6 +9,17 @@ const std::vector<glm::vec4> kVertices{
 }
 
 namespace tests {
+framework::TestConfiguration BaseInitializationTest::benchmarkConfiguration(
+    const framework::TestConfiguration& configuration)
+{
+    // Always benchmark mode, 1st frame only
+    framework::TestConfiguration result = configuration;
+    result.benchmarkMode = true;
+    result.benchmarkTime = 0.0f;
+    result.benchmarkFrames = 0u;
+    return result;
+}
+
 const std::vector<glm::vec4>& BaseInitializationTest::vertices() const
 {
     return kVertices;
@@ -1,13 +1,15 @@
 #include <tests/test4/gl/InitializationTest.h>
 
+#include <base/StartupPhases.h>
+
 #include <GL/glew.h>
 #include <glm/vec4.hpp>
 
 namespace tests {
 namespace test_gl {
-InitializationTest::InitializationTest()
+InitializationTest::InitializationTest(const framework::TestConfiguration& configuration)
     : BaseInitializationTest()
-    , GLTest("InitializationTest", true, 0.0f) // always benchmark mode, 1st frame only
+    , GLTest("InitializationTest", benchmarkConfiguration(configuration))
 {
 }
 
@@ -23,18 +25,22 @@ void InitializationTest::setup()
 
 void InitializationTest::run()
 {
-    glClear(GL_COLOR_BUFFER_BIT);
+    {
+        base::StartupPhases::Timer phase{"First frame", "firstFrame"};
 
-    program_.use();
-    vao_.bind();
-    vao_.drawArrays();
-    vao_.unbind();
-    program_.unbind();
+        glClear(GL_COLOR_BUFFER_BIT);
+
+        program_.use();
+        vao_.bind();
+        vao_.drawArrays();
+        vao_.unbind();
+        program_.unbind();
 
-    window_.update();
+        window_.update();
 
-    // Synchronize CPU<->GPU and time it
-    glFinish();
+        // Synchronize CPU<->GPU and time it
+        glFinish();
+    }
     processFrameTime();
 }
 
@@ -53,6 +59,7 @@ void InitializationTest::initApplication()
 
 void InitializationTest::initProgram()
 {
+    base::StartupPhases::Timer phase{"Program compilation and linking", "program"};
     program_.load({"resources/test4/shaders/gl_shader.vert", base::gl::Shader::Type::VertexShader},
                   {"resources/test4/shaders/gl_shader.frag", base::gl::Shader::Type::FragmentShader});
 }
@@ -2,6 +2,7 @@
 
 #include <base/File.h>
 #include <base/ScopedTimer.h>
+#include <base/StartupPhases.h>
 
 #include <glm/vec4.hpp>
 #include <vulkan/vulkan.hpp>
@@ -16,9 +17,11 @@ const std::string kPipelineCacheDataPath = "resources/test4/vk_pipeline_cache.bi
 
 namespace tests {
 namespace test_vk {
-InitializationTest::InitializationTest()
+InitializationTest::InitializationTest(const framework::TestConfiguration& configuration)
     : BaseInitializationTest()
-    , VKTest("InitializationTest", true, 0.0f)
+    , VKTest("InitializationTest", benchmarkConfiguration(configuration))
+    , _firstSubmitted(false)
+    , _pipelineCacheLoaded(false)
 {
 }
 
@@ -40,17 +43,19 @@ void InitializationTest::setup()
 
 void InitializationTest::run()
 {
-    TIME_RESET("Frame time:");
+    {
+        base::StartupPhases::Timer phase{"First frame", "firstFrame"};
 
-    auto frameIndex = getNextFrameIndex();
-    prepareCommandBuffer(frameIndex);
-    submitCommandBuffer(frameIndex);
-    presentFrame(frameIndex);
+        auto frameIndex = getNextFrameIndex();
+        prepareCommandBuffer(frameIndex);
+        submitCommandBuffer(frameIndex);
+        presentFrame(frameIndex);
 
-    window().update();
+        window().update();
 
-    // Synchronize CPU<->GPU and time it
-    queues().queue().waitIdle();
+        // Synchronize CPU<->GPU and time it
+        queues().queue().waitIdle();
+    }
     processFrameTime();
 }
 
@@ -122,7 +127,7 @@ void InitializationTest::createRenderPass()
                                          vk::AttachmentLoadOp::eDontCare,
                                          vk::AttachmentStoreOp::eDontCare,
                                          vk::ImageLayout::eUndefined,
-                                         vk::ImageLayout::ePresentSrcKHR};
+                                         window().presentImageLayout()};
     vk::AttachmentReference colorAttachment{0, vk::ImageLayout::eColorAttachmentOptimal};
     vk::SubpassDescription subpassDesc{
         {}, vk::PipelineBindPoint::eGraphics, 0, nullptr, 1, &colorAttachment, nullptr, nullptr, 0, nullptr};
@@ -143,6 +148,7 @@ void InitializationTest::createFramebuffers()
 
 void InitializationTest::createShaders()
 {
+    base::StartupPhases::Timer phase{"Shader loading", "shaders"};
     _vertexModule = base::vkx::ShaderModule{device(), "resources/test4/shaders/vk_shader.vert.spv"};
     _fragmentModule = base::vkx::ShaderModule{device(), "resources/test4/shaders/vk_shader.frag.spv"};
 }
@@ -164,14 +170,20 @@ void InitializationTest::createPipelineLayout()
 
 void InitializationTest::createPipelineCache()
 {
+    base::StartupPhases::Timer phase{"Pipeline cache loading", "pipelineCache"};
+
     std::vector<uint8_t> initialData = base::File::readBinaryBytes(kPipelineCacheDataPath, false);
     vk::PipelineCacheCreateInfo pipelineCacheInfo{{}, initialData.size(), initialData.data()};
     _pipelineCache = device().createPipelineCache(pipelineCacheInfo);
+    _pipelineCacheLoaded = !initialData.empty();
 }
 
 void InitializationTest::createPipeline()
 {
     TIME_IT("Pipeline creation");
+    base::StartupPhases::Timer phase{
+        _pipelineCacheLoaded ? "Pipeline creation (cached)" : "Pipeline creation (no cache)",
+        _pipelineCacheLoaded ? "pipelineCached" : "pipelineUncached"};
 
     // Shader stages
     std::vector<vk::PipelineShaderStageCreateInfo> shaderStages = getShaderStages();
@@ -327,12 +339,7 @@ uint32_t InitializationTest::getNextFrameIndex() const
 {
     TIME_IT("Frame image acquisition");
 
-    auto nextFrameAcquireStatus = device().acquireNextImageKHR(window().swapchain(), UINT64_MAX, _acquireSemaphore, {});
-    if (nextFrameAcquireStatus.result != vk::Result::eSuccess) {
-        throw std::system_error(nextFrameAcquireStatus.result, "Error during acquiring next frame index");
-    }
-
-    return nextFrameAcquireStatus.value;
+    return window().acquireNextImage(_acquireSemaphore);
 }
 
 void InitializationTest::prepareCommandBuffer(std::size_t frameIndex) const
@@ -370,15 +377,14 @@ void InitializationTest::submitCommandBuffer(std::size_t frameIndex) const
 {
     TIME_IT("CmdBuffer submition");
 
-    static bool first_sent = false;
     vk::PipelineStageFlags waitStages[] = {vk::PipelineStageFlagBits::eColorAttachmentOutput,
                                            vk::PipelineStageFlagBits::eVertexInput};
 
-    if (!first_sent) {
+    if (!_firstSubmitted) {
         vk::Semaphore waitSemaphores[2] = {_acquireSemaphore, _uploadSemaphore};
         vk::SubmitInfo submits{2, waitSemaphores, waitStages, 1, &_cmdBuffers[frameIndex], 1, &_renderSemaphore};
         queues().queue().submit(submits, _fences[frameIndex]);
-        first_sent = true;
+        _firstSubmitted = true;
     } else {
         vk::SubmitInfo submits{1, &_acquireSemaphore, waitStages, 1, &_cmdBuffers[frameIndex], 1, &_renderSemaphore};
         queues().queue().submit(submits, _fences[frameIndex]);
@@ -389,9 +395,7 @@ void InitializationTest::presentFrame(std::size_t frameIndex) const
 {
     TIME_IT("Frame presentation");
 
-    uint32_t imageIndex = static_cast<uint32_t>(frameIndex);
-    vk::PresentInfoKHR presentInfo{1, &_renderSemaphore, 1, &window().swapchain(), &imageIndex, nullptr};
-    queues().queue().presentKHR(presentInfo);
+    window().present(_renderSemaphore, static_cast<uint32_t>(frameIndex));
 }
 }
 }
@@ -0,0 +1,108 @@
+#include <base/Clock.h>
+#include <tests/test5/BaseApiCallTest.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+
+namespace {
+const std::vector<glm::vec4> kVertices{
+    glm::vec4{-0.5f, -0.5f, 0.0f, 1.0f}, //
+    glm::vec4{0.5f, -0.5f, 0.0f, 1.0f}, //
+    glm::vec4{0.0f, 0.5f, 0.0f, 1.0f}, //
+};
+
+const std::size_t kMinIterations = 16u;
+const std::size_t kMaxIterations = 1u << 18;
+const double kMinBatchTime = 0.005; // seconds
+const std::size_t kBatches = 15u;
+}
+
+namespace tests {
+framework::TestConfiguration BaseApiCallTest::benchmarkConfiguration(const framework::TestConfiguration& configuration)
+{
+    // Always benchmark mode, all measurements are done within a single frame
+    framework::TestConfiguration result = configuration;
+    result.benchmarkMode = true;
+    result.benchmarkTime = 0.0f;
+    result.benchmarkFrames = 0u;
+    return result;
+}
+
+const std::vector<glm::vec4>& BaseApiCallTest::vertices() const
+{
+    return kVertices;
+}
+
+void BaseApiCallTest::measureCall(const std::string& name,
+                                  const std::string& key,
+                                  bool withDraw,
+                                  const Batch& batch,
+                                  const Synchronize& synchronize)
+{
+    auto timeBatch = [&batch, &synchronize](std::size_t iterations) -> double {
+        double start = base::Clock::seconds();
+        batch(iterations);
+        double time = base::Clock::seconds() - start;
+        synchronize();
+        return time;
+    };
+
+    // Scaling of the batch size also warms up caches and driver paths of the operation
+    std::size_t iterations = kMinIterations;
+    while (timeBatch(iterations) < kMinBatchTime && iterations < kMaxIterations) {
+        iterations *= 2u;
+    }
+
+    std::vector<double> times;
+    for (std::size_t i = 0; i < kBatches; ++i) {
+        times.push_back(timeBatch(iterations) * 1.0e9 / static_cast<double>(iterations));
+    }
+    std::sort(times.begin(), times.end());
+
+    _callTimes.push_back(CallTime{name, key, withDraw, iterations, times[times.size() / 2u], times.front()});
+}
+
+void BaseApiCallTest::printCallTimes() const
+{
+    std::cout << std::endl;
+    std::cout << "API call overhead" << std::endl;
+    std::cout << "=================" << std::endl;
+
+    const CallTime* draw = findCallTime("draw");
+
+    char buffer[160];
+    std::snprintf(buffer, sizeof(buffer), "  %-30s %12s %12s %12s %8s", "Operation", "Median", "Minimum",
+                  "Over draw", "Batch");
+    std::cout << buffer << std::endl;
+    for (const CallTime& callTime : _callTimes) {
+        char extra[32] = "---";
+        if (callTime.withDraw && draw) {
+            std::snprintf(extra, sizeof(extra), "%.1fns", callTime.medianTime - draw->medianTime);
+        }
+        std::snprintf(buffer, sizeof(buffer), "  %-30s %10.1fns %10.1fns %12s %8zu", callTime.name.c_str(),
+                      callTime.medianTime, callTime.minTime, extra, callTime.iterations);
+        std::cout << buffer << std::endl;
+    }
+}
+
+void BaseApiCallTest::exportCallTimes(framework::BenchmarkResult& result) const
+{
+    const CallTime* draw = findCallTime("draw");
+
+    for (const CallTime& callTime : _callTimes) {
+        result.set("api", callTime.key + "Ns", callTime.medianTime);
+        result.set("api", callTime.key + "MinNs", callTime.minTime);
+        if (callTime.withDraw && draw) {
+            result.set("api", callTime.key + "OverDrawNs", callTime.medianTime - draw->medianTime);
+        }
+    }
+}
+
+const BaseApiCallTest::CallTime* BaseApiCallTest::findCallTime(const std::string& key) const
+{
+    auto callTime = std::find_if(_callTimes.begin(), _callTimes.end(),
+                                 [&key](const CallTime& measured) { return measured.key == key; });
+    return (callTime != _callTimes.end()) ? &*callTime : nullptr;
+}
+}
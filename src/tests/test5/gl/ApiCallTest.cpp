@@ -0,0 +1,180 @@
+#include <tests/test5/gl/ApiCallTest.h>
+
+#include <GL/glew.h>
+#include <glm/vec4.hpp>
+
+namespace {
+const GLuint kUniformBlockBinding = 0u;
+
+// Values differ between calls, so that drivers can't skip redundant updates
+glm::vec4 uniformValue(std::size_t iteration)
+{
+    return glm::vec4{static_cast<float>(iteration & 1u) * 0.1f, 0.0f, 0.0f, 0.0f};
+}
+}
+
+namespace tests {
+namespace test_gl {
+ApiCallTest::ApiCallTest(const framework::TestConfiguration& configuration)
+    : BaseApiCallTest()
+    , GLTest("ApiCallTest", benchmarkConfiguration(configuration))
+{
+}
+
+void ApiCallTest::setup()
+{
+    GLTest::setup();
+
+    initApplication();
+    initPrograms();
+    initVBOs();
+    initVAOs();
+    initUBOs();
+}
+
+void ApiCallTest::run()
+{
+    glClear(GL_COLOR_BUFFER_BIT);
+
+    measureCalls();
+
+    window_.update();
+
+    // Synchronize CPU<->GPU, whole run is a single frame
+    glFinish();
+    processFrameTime();
+}
+
+void ApiCallTest::teardown()
+{
+    GLTest::teardown();
+}
+
+void ApiCallTest::printStatistics() const
+{
+    GLTest::printStatistics();
+    printCallTimes();
+}
+
+void ApiCallTest::exportStatistics(framework::BenchmarkResult& result) const
+{
+    GLTest::exportStatistics(result);
+    exportCallTimes(result);
+}
+
+void ApiCallTest::initApplication()
+{
+    window_.setDisplayingFPS(true);
+    window_.setFPSRefreshRate(1.0);
+
+    glClearColor(0.1f, 0.1f, 0.1f, 1.0f);
+}
+
+void ApiCallTest::initPrograms()
+{
+    for (base::gl::Program& program : programs_) {
+        program.load({"resources/test5/shaders/gl_shader.vert", base::gl::Shader::Type::VertexShader},
+                     {"resources/test5/shaders/gl_shader.frag", base::gl::Shader::Type::FragmentShader});
+    }
+}
+
+void ApiCallTest::initVBOs()
+{
+    // VertexData
+    base::gl::VertexBuffer::Data vertexData;
+    vertexData.data = (GLvoid*)(vertices().data());
+    vertexData.size = sizeof(glm::vec4) * vertices().size();
+    vertexData.pointers.push_back(base::gl::VertexAttrib(0, 4, GL_FLOAT, 0, nullptr));
+
+    // VBO settings
+    for (base::gl::VertexBuffer& vbo : vbos_) {
+        vbo.bind();
+        vbo.setData(vertexData);
+        vbo.unbind();
+    }
+}
+
+void ApiCallTest::initVAOs()
+{
+    for (std::size_t i = 0; i < vaos_.size(); ++i) {
+        vaos_[i].setDrawCount(vertices().size());
+        vaos_[i].setDrawTarget(base::gl::VertexArray::DrawTarget::Triangles);
+
+        vaos_[i].bind();
+        vaos_[i].attachVBO(&vbos_[i]);
+        vaos_[i].setAttribPointers();
+        vaos_[i].unbind();
+    }
+}
+
+void ApiCallTest::initUBOs()
+{
+    const glm::vec4 data{};
+    for (base::gl::Buffer& ubo : ubos_) {
+        ubo.setTarget(base::gl::Buffer::Target::Uniform);
+        ubo.setUsage(base::gl::Buffer::Usage::DynamicDraw);
+        ubo.bind();
+        ubo.setData(sizeof(data), &data);
+        ubo.unbind();
+    }
+}
+
+void ApiCallTest::measureCalls()
+{
+    auto synchronize = []() { glFinish(); };
+
+    programs_[0].use();
+    vaos_[0].bind();
+
+    measureCall("Draw", "draw", false, [this](std::size_t iterations) {
+        for (std::size_t i = 0; i < iterations; ++i) {
+            vaos_[0].drawArrays();
+        }
+    }, synchronize);
+
+    // Uniform is looked up once, only glUniform4fv is measured
+    const base::gl::Uniform& position = programs_[0]["objPosition"];
+    measureCall("Uniform update", "uniform", false, [&position](std::size_t iterations) {
+        for (std::size_t i = 0; i < iterations; ++i) {
+            position = uniformValue(i);
+        }
+    }, synchronize);
+
+    measureCall("Program switch + draw", "programSwitch", true, [this](std::size_t iterations) {
+        for (std::size_t i = 0; i < iterations; ++i) {
+            programs_[i & 1u].use();
+            vaos_[0].drawArrays();
+        }
+    }, synchronize);
+    programs_[0].use();
+
+    measureCall("Vertex array bind + draw", "vertexBufferBind", true, [this](std::size_t iterations) {
+        for (std::size_t i = 0; i < iterations; ++i) {
+            vaos_[i & 1u].bind();
+            vaos_[i & 1u].drawArrays();
+        }
+    }, synchronize);
+    vaos_[0].bind();
+
+    // Counterpart of binding a descriptor set with a uniform buffer
+    measureCall("Uniform buffer bind + draw", "descriptorBind", true, [this](std::size_t iterations) {
+        for (std::size_t i = 0; i < iterations; ++i) {
+            glBindBufferBase(GL_UNIFORM_BUFFER, kUniformBlockBinding, ubos_[i & 1u].getID());
+            vaos_[0].drawArrays();
+        }
+    }, synchronize);
+
+    ubos_[0].bind();
+    measureCall("Buffer sub-data update", "bufferUpdate", false, [this](std::size_t iterations) {
+        for (std::size_t i = 0; i < iterations; ++i) {
+            glm::vec4 value = uniformValue(i);
+            ubos_[0].setSubData(0, sizeof(value), &value);
+        }
+    }, synchronize);
+    ubos_[0].unbind();
+
+    vaos_[0].unbind();
+    programs_[0].unbind();
+}
+}
+}
@@ -0,0 +1,431 @@
+#include <tests/test5/vk/ApiCallTest.h>
+
+#include <glm/vec4.hpp>
+#include <vulkan/vulkan.hpp>
+
+#include <array>
+#include <cstring>
+#include <vector>
+
+namespace {
+// Values differ between calls, so that drivers can't skip redundant updates
+glm::vec4 uniformValue(std::size_t iteration)
+{
+    return glm::vec4{static_cast<float>(iteration & 1u) * 0.1f, 0.0f, 0.0f, 0.0f};
+}
+}
+
+namespace tests {
+namespace test_vk {
+ApiCallTest::ApiCallTest(const framework::TestConfiguration& configuration)
+    : BaseApiCallTest()
+    , VKTest("ApiCallTest", benchmarkConfiguration(configuration))
+{
+}
+
+void ApiCallTest::setup()
+{
+    VKTest::setup();
+
+    createCommandBuffers();
+    createVbos();
+    createUbo();
+    createRenderPass();
+    createFramebuffer();
+    createShaders();
+    createDescriptorSets();
+    createPipelineLayout();
+    createPipelines();
+}
+
+void ApiCallTest::run()
+{
+    measureCalls();
+
+    window().update();
+
+    // Commands are only recorded, nothing is submitted, whole run is a single frame
+    processFrameTime();
+}
+
+void ApiCallTest::teardown()
+{
+    device().waitIdle();
+
+    destroyPipelines();
+    destroyPipelineLayout();
+    destroyDescriptorSets();
+    destroyShaders();
+    destroyFramebuffer();
+    destroyRenderPass();
+    destroyUbo();
+    destroyVbos();
+    destroyCommandBuffers();
+
+    VKTest::teardown();
+}
+
+void ApiCallTest::printStatistics() const
+{
+    VKTest::printStatistics();
+    printCallTimes();
+}
+
+void ApiCallTest::exportStatistics(framework::BenchmarkResult& result) const
+{
+    VKTest::exportStatistics(result);
+    exportCallTimes(result);
+}
+
+void ApiCallTest::createCommandBuffers()
+{
+    vk::CommandPoolCreateFlags cmdPoolFlags = vk::CommandPoolCreateFlagBits::eResetCommandBuffer;
+    _cmdPool = device().createCommandPool({cmdPoolFlags, queues().familyIndex()});
+    _cmdBuffer = device().allocateCommandBuffers({_cmdPool, vk::CommandBufferLevel::ePrimary, 1}).front();
+}
+
+void ApiCallTest::createVbos()
+{
+    vk::DeviceSize size = vertices().size() * sizeof(vertices().front());
+    vk::BufferUsageFlags usage = vk::BufferUsageFlagBits::eVertexBuffer;
+
+    base::vkx::Buffer stagingBuffer = memory().createStagingBuffer(size);
+    {
+        auto vboMemory = device().mapMemory(stagingBuffer.memory, stagingBuffer.offset, stagingBuffer.size, {});
+        std::memcpy(vboMemory, vertices().data(), static_cast<std::size_t>(stagingBuffer.size));
+        device().unmapMemory(stagingBuffer.memory);
+    }
+    for (base::vkx::Buffer& vbo : _vbos) {
+        vbo = memory().copyToDeviceLocalMemory(stagingBuffer, usage, _cmdBuffer, queues().queue());
+    }
+
+    memory().destroyBuffer(stagingBuffer);
+}
+
+void ApiCallTest::createUbo()
+{
+    const glm::vec4 data{};
+    vk::BufferUsageFlags usage = vk::BufferUsageFlagBits::eUniformBuffer | vk::BufferUsageFlagBits::eTransferDst;
+
+    base::vkx::Buffer stagingBuffer = memory().createStagingBuffer(sizeof(data));
+    {
+        auto uboMemory = device().mapMemory(stagingBuffer.memory, stagingBuffer.offset, stagingBuffer.size, {});
+        std::memcpy(uboMemory, &data, sizeof(data));
+        device().unmapMemory(stagingBuffer.memory);
+    }
+    _ubo = memory().copyToDeviceLocalMemory(stagingBuffer, usage, _cmdBuffer, queues().queue());
+
+    memory().destroyBuffer(stagingBuffer);
+}
+
+void ApiCallTest::createRenderPass()
+{
+    vk::AttachmentDescription attachment{{},
+                                         window().swapchainImageFormat(),
+                                         vk::SampleCountFlagBits::e1,
+                                         vk::AttachmentLoadOp::eClear,
+                                         vk::AttachmentStoreOp::eStore,
+                                         vk::AttachmentLoadOp::eDontCare,
+                                         vk::AttachmentStoreOp::eDontCare,
+                                         vk::ImageLayout::eUndefined,
+                                         window().presentImageLayout()};
+    vk::AttachmentReference colorAttachment{0, vk::ImageLayout::eColorAttachmentOptimal};
+    vk::SubpassDescription subpassDesc{
+        {}, vk::PipelineBindPoint::eGraphics, 0, nullptr, 1, &colorAttachment, nullptr, nullptr, 0, nullptr};
+
+    vk::RenderPassCreateInfo renderPassInfo{{}, 1, &attachment, 1, &subpassDesc, 0, nullptr};
+    _renderPass = device().createRenderPass(renderPassInfo);
+}
+
+void ApiCallTest::createFramebuffer()
+{
+    // Command buffer is never submitted, so any swapchain image will do
+    const vk::ImageView& imageView = window().swapchainImageViews().front();
+    vk::FramebufferCreateInfo framebufferInfo{{}, _renderPass, 1, &imageView, window().size().x, window().size().y, 1};
+    _framebuffer = device().createFramebuffer(framebufferInfo);
+}
+
+void ApiCallTest::createShaders()
+{
+    _vertexModule = base::vkx::ShaderModule{device(), "resources/test5/shaders/vk_shader.vert.spv"};
+    _fragmentModule = base::vkx::ShaderModule{device(), "resources/test5/shaders/vk_shader.frag.spv"};
+}
+
+void ApiCallTest::createDescriptorSets()
+{
+    // Uniform buffer isn't used by the shaders, it's there to make binding of descriptor sets realistic
+    std::vector<vk::DescriptorSetLayoutBinding> bindings{
+        vk::DescriptorSetLayoutBinding{0, vk::DescriptorType::eUniformBuffer, 1, vk::ShaderStageFlagBits::eVertex,
+                                       nullptr},
+    };
+    vk::DescriptorSetLayoutCreateInfo setLayoutInfo{{}, static_cast<uint32_t>(bindings.size()), bindings.data()};
+    _setLayout = device().createDescriptorSetLayout(setLayoutInfo);
+
+    const uint32_t setCount = 2u;
+    std::vector<vk::DescriptorPoolSize> poolSizes{
+        vk::DescriptorPoolSize{vk::DescriptorType::eUniformBuffer, setCount},
+    };
+    vk::DescriptorPoolCreateInfo poolInfo{{}, setCount, static_cast<uint32_t>(poolSizes.size()), poolSizes.data()};
+    _descriptorPool = device().createDescriptorPool(poolInfo);
+
+    std::vector<vk::DescriptorSetLayout> setLayouts(setCount, _setLayout);
+    vk::DescriptorSetAllocateInfo descriptorSetInfo{_descriptorPool, setCount, setLayouts.data()};
+    _descriptorSets = device().allocateDescriptorSets(descriptorSetInfo);
+
+    vk::DescriptorBufferInfo bufferInfo{_ubo.buffer, 0, _ubo.size};
+    std::vector<vk::WriteDescriptorSet> descriptorWrites;
+    for (const vk::DescriptorSet& descriptorSet : _descriptorSets) {
+        descriptorWrites.push_back(
+            {descriptorSet, 0, 0, 1, vk::DescriptorType::eUniformBuffer, nullptr, &bufferInfo, nullptr});
+    }
+    std::vector<vk::CopyDescriptorSet> descriptorCopies{};
+    device().updateDescriptorSets(descriptorWrites, descriptorCopies);
+}
+
+void ApiCallTest::createPipelineLayout()
+{
+    vk::PushConstantRange pushConstantRanges[] = {
+        {vk::ShaderStageFlagBits::eVertex, 0, sizeof(glm::vec4)}, // position
+        {vk::ShaderStageFlagBits::eFragment, sizeof(glm::vec4), sizeof(glm::vec4)} // color
+    };
+
+    vk::PipelineLayoutCreateInfo pipelineLayoutInfo{{}, 1, &_setLayout, 2, &pushConstantRanges[0]};
+    _pipelineLayout = device().createPipelineLayout(pipelineLayoutInfo);
+}
+
+void ApiCallTest::createPipelines()
+{
+    // Pipelines differ in a fixed-function state only, shaders are the same
+    _pipelines[0] = createPipeline(vk::CullModeFlagBits::eNone);
+    _pipelines[1] = createPipeline(vk::CullModeFlagBits::eBack);
+}
+
+void ApiCallTest::destroyPipelines()
+{
+    for (const vk::Pipeline& pipeline : _pipelines) {
+        device().destroyPipeline(pipeline);
+    }
+}
+
+void ApiCallTest::destroyPipelineLayout()
+{
+    device().destroyPipelineLayout(_pipelineLayout);
+}
+
+void ApiCallTest::destroyDescriptorSets()
+{
+    device().destroyDescriptorPool(_descriptorPool);
+    _descriptorSets.clear();
+    device().destroyDescriptorSetLayout(_setLayout);
+}
+
+void ApiCallTest::destroyShaders()
+{
+    _vertexModule = {};
+    _fragmentModule = {};
+}
+
+void ApiCallTest::destroyFramebuffer()
+{
+    device().destroyFramebuffer(_framebuffer);
+}
+
+void ApiCallTest::destroyRenderPass()
+{
+    device().destroyRenderPass(_renderPass);
+}
+
+void ApiCallTest::destroyUbo()
+{
+    memory().destroyBuffer(_ubo);
+}
+
+void ApiCallTest::destroyVbos()
+{
+    for (base::vkx::Buffer& vbo : _vbos) {
+        memory().destroyBuffer(vbo);
+    }
+}
+
+void ApiCallTest::destroyCommandBuffers()
+{
+    device().destroyCommandPool(_cmdPool);
+}
+
+std::vector<vk::PipelineShaderStageCreateInfo> ApiCallTest::getShaderStages() const
+{
+    std::vector<vk::PipelineShaderStageCreateInfo> stages;
+
+    vk::PipelineShaderStageCreateInfo vertexStage{{}, vk::ShaderStageFlagBits::eVertex, _vertexModule, "main", nullptr};
+    stages.push_back(vertexStage);
+
+    vk::PipelineShaderStageCreateInfo fragmentStage{
+        {}, vk::ShaderStageFlagBits::eFragment, _fragmentModule, "main", nullptr};
+    stages.push_back(fragmentStage);
+
+    return stages;
+}
+
+vk::Pipeline ApiCallTest::createPipeline(vk::CullModeFlags cullMode) const
+{
+    // Shader stages
+    std::vector<vk::PipelineShaderStageCreateInfo> shaderStages = getShaderStages();
+
+    // Vertex input state
+    std::vector<vk::VertexInputBindingDescription> vertexBindingDescriptions{
+        {0, sizeof(glm::vec4), vk::VertexInputRate::eVertex} // Binding #0 - vertex input data
+    };
+    std::vector<vk::VertexInputAttributeDescription> vertexAttributeDescription{
+        {0, 0, vk::Format::eR32G32B32A32Sfloat, 0} // Attribute #0 (from binding #0) - vec4
+    };
+    vk::PipelineVertexInputStateCreateInfo vertexInputState{{},
+                                                            static_cast<uint32_t>(vertexBindingDescriptions.size()),
+                                                            vertexBindingDescriptions.data(),
+                                                            static_cast<uint32_t>(vertexAttributeDescription.size()),
+                                                            vertexAttributeDescription.data()};
+
+    // Input assembly state
+    vk::PipelineInputAssemblyStateCreateInfo inputAssemblyState{{}, vk::PrimitiveTopology::eTriangleList, VK_FALSE};
+
+    // Viewport state
+    vk::Viewport viewport{0.0f, 0.0f, static_cast<float>(window().size().x), static_cast<float>(window().size().y),
+                          0.0f, 1.0f};
+    vk::Rect2D scissor{{0, 0}, {static_cast<uint32_t>(window().size().x), static_cast<uint32_t>(window().size().y)}};
+    vk::PipelineViewportStateCreateInfo viewportState{{}, 1, &viewport, 1, &scissor};
+
+    // Rasterization state
+    vk::PipelineRasterizationStateCreateInfo rasterizationState{{},
+                                                                VK_FALSE,
+                                                                VK_FALSE,
+                                                                vk::PolygonMode::eFill,
+                                                                cullMode,
+                                                                vk::FrontFace::eCounterClockwise,
+                                                                VK_FALSE,
+                                                                0.0f,
+                                                                0.0f,
+                                                                0.0f,
+                                                                1.0f};
+
+    // Multisample state
+    vk::PipelineMultisampleStateCreateInfo multisampleState{
+        {}, vk::SampleCountFlagBits::e1, VK_FALSE, 0.0f, nullptr, VK_FALSE, VK_FALSE};
+
+    // ColorBlend state
+    vk::PipelineColorBlendAttachmentState colorBlendAttachmentState{VK_FALSE};
+    colorBlendAttachmentState.colorWriteMask = vk::ColorComponentFlagBits::eR | vk::ColorComponentFlagBits::eG |
+                                               vk::ColorComponentFlagBits::eB | vk::ColorComponentFlagBits::eA;
+    vk::PipelineColorBlendStateCreateInfo colorBlendState{
+        {}, VK_FALSE, vk::LogicOp::eClear, 1, &colorBlendAttachmentState};
+
+    // Pipeline creation
+    vk::GraphicsPipelineCreateInfo pipelineInfo{{},
+                                                static_cast<uint32_t>(shaderStages.size()),
+                                                shaderStages.data(),
+                                                &vertexInputState,
+                                                &inputAssemblyState,
+                                                nullptr,
+                                                &viewportState,
+                                                &rasterizationState,
+                                                &multisampleState,
+                                                nullptr,
+                                                &colorBlendState,
+                                                nullptr,
+                                                _pipelineLayout,
+                                                _renderPass,
+                                                0};
+    return device().createGraphicsPipeline({}, pipelineInfo);
+}
+
+void ApiCallTest::measureCalls()
+{
+    // Recording is all the CPU work Vulkan does per call, submission is a separate step with its own cost
+    auto synchronize = []() {};
+
+    const vk::CommandBuffer& cmdBuffer = _cmdBuffer;
+    const vk::PipelineLayout& layout = _pipelineLayout;
+    const vk::ShaderStageFlags vertexStage = vk::ShaderStageFlagBits::eVertex;
+    const auto vertexCount = static_cast<uint32_t>(vertices().size());
+
+    measureCall("Draw", "draw", false, [&](std::size_t iterations) {
+        recordCommandBuffer(true, [&]() {
+            for (std::size_t i = 0; i < iterations; ++i) {
+                cmdBuffer.draw(vertexCount, 1, 0, 0);
+            }
+        });
+    }, synchronize);
+
+    measureCall("Push constants update", "uniform", false, [&](std::size_t iterations) {
+        recordCommandBuffer(true, [&]() {
+            for (std::size_t i = 0; i < iterations; ++i) {
+                glm::vec4 value = uniformValue(i);
+                cmdBuffer.pushConstants(layout, vertexStage, 0, sizeof(value), &value);
+            }
+        });
+    }, synchronize);
+
+    measureCall("Pipeline switch + draw", "programSwitch", true, [&](std::size_t iterations) {
+        recordCommandBuffer(true, [&]() {
+            for (std::size_t i = 0; i < iterations; ++i) {
+                cmdBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, _pipelines[i & 1u]);
+                cmdBuffer.draw(vertexCount, 1, 0, 0);
+            }
+        });
+    }, synchronize);
+
+    measureCall("Vertex buffer bind + draw", "vertexBufferBind", true, [&](std::size_t iterations) {
+        const vk::DeviceSize offset = 0;
+        recordCommandBuffer(true, [&]() {
+            for (std::size_t i = 0; i < iterations; ++i) {
+                cmdBuffer.bindVertexBuffers(0, 1, &_vbos[i & 1u].buffer, &offset);
+                cmdBuffer.draw(vertexCount, 1, 0, 0);
+            }
+        });
+    }, synchronize);
+
+    measureCall("Descriptor set bind + draw", "descriptorBind", true, [&](std::size_t iterations) {
+        recordCommandBuffer(true, [&]() {
+            for (std::size_t i = 0; i < iterations; ++i) {
+                cmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, layout, 0, 1,
+                                             &_descriptorSets[i & 1u], 0, nullptr);
+                cmdBuffer.draw(vertexCount, 1, 0, 0);
+            }
+        });
+    }, synchronize);
+
+    // Transfer commands aren't allowed inside of a render pass
+    measureCall("Buffer update", "bufferUpdate", false, [&](std::size_t iterations) {
+        recordCommandBuffer(false, [&]() {
+            for (std::size_t i = 0; i < iterations; ++i) {
+                glm::vec4 value = uniformValue(i);
+                cmdBuffer.updateBuffer(_ubo.buffer, 0, sizeof(value), &value);
+            }
+        });
+    }, synchronize);
+}
+
+template <typename Commands>
+void ApiCallTest::recordCommandBuffer(bool insideRenderPass, const Commands& commands) const
+{
+    static const vk::ClearValue clearValue = vk::ClearColorValue{std::array<float, 4>{{0.0f, 0.0f, 0.0f, 1.0f}}};
+    const vk::DeviceSize offset = 0;
+
+    _cmdBuffer.reset({});
+    _cmdBuffer.begin({vk::CommandBufferUsageFlagBits::eOneTimeSubmit, nullptr});
+    if (insideRenderPass) {
+        vk::RenderPassBeginInfo renderPassInfo{
+            _renderPass, _framebuffer, {{}, {window().size().x, window().size().y}}, 1, &clearValue};
+
+        _cmdBuffer.beginRenderPass(renderPassInfo, vk::SubpassContents::eInline);
+        _cmdBuffer.bindPipeline(vk::PipelineBindPoint::eGraphics, _pipelines[0]);
+        _cmdBuffer.bindVertexBuffers(0, 1, &_vbos[0].buffer, &offset);
+        _cmdBuffer.bindDescriptorSets(vk::PipelineBindPoint::eGraphics, _pipelineLayout, 0, 1, &_descriptorSets[0], 0,
+                                      nullptr);
+        commands();
+        _cmdBuffer.endRenderPass();
+    } else {
+        commands();
+    }
+    _cmdBuffer.end();
+}
+}
+}